@@ -6,7 +6,7 @@
 
 #include <Arduino.h>
 
-// How many **groups of four** 8x8 MAX7219 modules are connected
-const uint8_t matrixModulesCount = 4;
+// How many groups of four 8x8 MAX7219 modules are connected is now the
+// "matrixModulesCount" key in ticker_settings.json
 
 #endif
@@ -0,0 +1,287 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#include <ButtonEvents.h>
+
+namespace ButtonEvents {
+  /**
+   * @brief Start with no buttons and empty queues.
+   *
+   * @param onEdge Called from the interrupt after each edge is queued, like
+   *  to wake the loop up to handle it. Must be safe to call from an
+   *  interrupt.
+   */
+  void ButtonEvents::begin(void (*onEdge)() /* = nullptr */) {
+    this->end();
+    this->onEdge = onEdge;
+    this->edgeHead = 0;
+    this->edgeTail = 0;
+    this->droppedEdges = 0;
+    this->reportedDroppedEdges = 0;
+    this->eventHead = 0;
+    this->eventCount = 0;
+    this->droppedEvents = 0;
+  }
+
+  /**
+   * @brief Stop the interrupts of every button and forget them.
+   */
+  void ButtonEvents::end() {
+    for (uint8_t i = 0; i < this->buttonCount; i++) {
+      detachInterrupt(digitalPinToInterrupt(this->buttons[i].pin));
+      pinMode(this->buttons[i].pin, INPUT);
+    }
+    this->buttonCount = 0;
+  }
+
+  /**
+   * @brief Start watching a button's pin.
+   *
+   * A button already down counts as pressed right away, without a PRESS
+   * event, so isPressed() can check for a button held at boot.
+   *
+   * @param pin Pulled up, low when pressed.
+   * @param useInternalPullup False if the board has its own pull up.
+   * @return uint8_t The button's number in events, or NO_BUTTON if there are
+   *  already MAX_BUTTONS.
+   */
+  uint8_t ButtonEvents::addButton(uint8_t pin,
+                                  bool useInternalPullup /* = true */) {
+    if (this->buttonCount >= MAX_BUTTONS) {
+      LOG_ERROR("Buttons: no room for pin %d", pin);
+      return NO_BUTTON;
+    }
+    const uint8_t index = this->buttonCount;
+    Button& button = this->buttons[index];
+    pinMode(pin, useInternalPullup ? INPUT_PULLUP : INPUT);
+    button = {};
+    button.owner = this;
+    button.index = index;
+    button.pin = pin;
+    button.level = digitalRead(pin);
+    button.rawLevel = button.level;
+    button.changeTime = millis();
+    button.rawTime = button.changeTime;
+    button.pressTime = button.changeTime;
+    // Held since before it was added, don't make that a long press
+    button.longPressed = button.level == PRESSED;
+    this->buttonCount++;
+    attachInterruptParam(digitalPinToInterrupt(pin), onPinChange, CHANGE,
+                         &button);
+    return index;
+  }
+
+  /**
+   * @brief Turn the edges queued since the last call into events, and send
+   *  the events that were waiting on time, like a long press. Call every
+   *  loop, and at least by getNextUpdateTime().
+   */
+  void ButtonEvents::update() {
+    while (this->edgeTail != this->edgeHead) {
+      const Edge edge = this->edges[this->edgeTail & (EDGE_QUEUE_LEN - 1)];
+      // Copied before the interrupt can reuse the slot
+      __compiler_memory_barrier();
+      this->edgeTail++;
+      this->handleEdge(this->buttons[edge.button], edge.level, edge.time);
+    }
+
+    const uint32_t now = millis();
+    const uint32_t droppedEdges = this->droppedEdges;
+    if (droppedEdges != this->reportedDroppedEdges) {
+      LOG_WARN("Buttons: %lu edges dropped, reading pins again",
+               droppedEdges - this->reportedDroppedEdges);
+      this->reportedDroppedEdges = droppedEdges;
+      // The queue no longer says where the pins ended up
+      for (uint8_t i = 0; i < this->buttonCount; i++) {
+        this->handleEdge(this->buttons[i], digitalRead(this->buttons[i].pin),
+                         now);
+      }
+    }
+
+    for (uint8_t i = 0; i < this->buttonCount; i++) {
+      Button& button = this->buttons[i];
+      // Stopped bouncing at a level that came too soon to count
+      if (button.rawLevel != button.level &&
+          now - button.rawTime >= this->debounceTime) {
+        this->applyLevel(button, button.rawLevel, button.rawTime);
+      }
+      this->checkTimers(button, now);
+    }
+  }
+
+  /**
+   * @brief Take the oldest event.
+   *
+   * @param event Where to put it.
+   * @return true if there was one.
+   */
+  bool ButtonEvents::nextEvent(Event& event) {
+    if (this->eventCount == 0) {
+      return false;
+    }
+    event = this->events[this->eventHead];
+    this->eventHead = (this->eventHead + 1) % EVENT_QUEUE_LEN;
+    this->eventCount--;
+    return true;
+  }
+
+  /**
+   * @brief Get when update() has to run next to send an event on time, like
+   *  a long press while the button is held.
+   *
+   * @param time Set to the millis() it is due by, if there is one.
+   * @return true if something is waiting on time, false if only a new edge
+   *  can make another event.
+   */
+  bool ButtonEvents::getNextUpdateTime(uint32_t& time) const {
+    bool hasTime = false;
+    auto wakeBy = [&time, &hasTime](uint32_t t) {
+      if (!hasTime || static_cast<int32_t>(t - time) < 0) {
+        time = t;
+        hasTime = true;
+      }
+    };
+    for (uint8_t i = 0; i < this->buttonCount; i++) {
+      const Button& button = this->buttons[i];
+      if (button.rawLevel != button.level) {
+        wakeBy(button.rawTime + this->debounceTime);
+      }
+      if (button.level == PRESSED && !button.longPressed) {
+        wakeBy(button.pressTime + this->longPressTime);
+      }
+      if (button.clickPending && button.level == RELEASED) {
+        wakeBy(button.clickTime + this->doubleClickTime);
+      }
+    }
+    return hasTime;
+  }
+
+  /**
+   * @brief Queue a button's pin level. Runs in the GPIO interrupt.
+   *
+   * @param param The Button that changed.
+   */
+  void ButtonEvents::onPinChange(void* param) {
+    const Button* button = static_cast<const Button*>(param);
+    ButtonEvents* owner = button->owner;
+    owner->pushEdge(button->index, digitalRead(button->pin), millis());
+    if (owner->onEdge != nullptr) {
+      owner->onEdge();
+    }
+  }
+
+  /**
+   * @brief Add an edge to the queue, or count it as dropped if it is full.
+   *  Only called from the interrupt.
+   */
+  void ButtonEvents::pushEdge(uint8_t button, bool level, uint32_t time) {
+    const uint8_t head = this->edgeHead;
+    if (static_cast<uint8_t>(head - this->edgeTail) >= EDGE_QUEUE_LEN) {
+      this->droppedEdges = this->droppedEdges + 1;
+      return;
+    }
+    this->edges[head & (EDGE_QUEUE_LEN - 1)] = {button, level, time};
+    // Written before update() can see it
+    __compiler_memory_barrier();
+    this->edgeHead = head + 1;
+  }
+
+  /**
+   * @brief Debounce one pin level read by the interrupt.
+   *
+   * The first change after a quiet debounce time counts right away. Changes
+   * sooner than that are remembered, and count once the pin stays at them
+   * for the debounce time (in update()), so bounce can't leave the button
+   * stuck at the wrong level.
+   */
+  void ButtonEvents::handleEdge(Button& button, bool level, uint32_t time) {
+    // The last edge settled before this one came, with the loop behind
+    if (button.rawLevel != button.level &&
+        time - button.rawTime >= this->debounceTime) {
+      this->applyLevel(button, button.rawLevel, button.rawTime);
+    }
+    button.rawLevel = level;
+    button.rawTime = time;
+    if (level != button.level &&
+        time - button.changeTime >= this->debounceTime) {
+      this->applyLevel(button, level, time);
+    }
+  }
+
+  /**
+   * @brief A debounced change, send PRESS or RELEASE and work out the
+   *  gesture.
+   */
+  void ButtonEvents::applyLevel(Button& button, bool level, uint32_t time) {
+    // What was due before the change, the loop may not have been around to
+    // see a press get long or a click run out of time
+    this->checkTimers(button, time);
+    button.level = level;
+    button.changeTime = time;
+    if (level == PRESSED) {
+      button.pressTime = time;
+      button.longPressed = false;
+      this->pushEvent(button, EventType::PRESS, time);
+      return;
+    }
+
+    // Held past the double click time, so the click before it was a click
+    // of its own and this one might start a double click
+    if (button.clickPending &&
+        time - button.clickTime >= this->doubleClickTime) {
+      button.clickPending = false;
+      this->pushEvent(button, EventType::CLICK, button.clickTime);
+    }
+    this->pushEvent(button, EventType::RELEASE, time);
+    if (button.longPressed) {
+      return;
+    }
+    if (button.clickPending) {
+      button.clickPending = false;
+      this->pushEvent(button, EventType::DOUBLE_CLICK, time);
+    } else {
+      button.clickPending = true;
+      button.clickTime = time;
+    }
+  }
+
+  /**
+   * @brief Send the LONG_PRESS or CLICK that is due by now, in the order
+   *  they happened.
+   */
+  void ButtonEvents::checkTimers(Button& button, uint32_t now) {
+    if (button.level == PRESSED && !button.longPressed &&
+        now - button.pressTime >= this->longPressTime) {
+      if (button.clickPending) {
+        button.clickPending = false;
+        this->pushEvent(button, EventType::CLICK, button.clickTime);
+      }
+      button.longPressed = true;
+      this->pushEvent(button, EventType::LONG_PRESS,
+                      button.pressTime + this->longPressTime);
+    }
+    if (button.clickPending && button.level == RELEASED &&
+        now - button.clickTime >= this->doubleClickTime) {
+      button.clickPending = false;
+      this->pushEvent(button, EventType::CLICK, button.clickTime);
+    }
+  }
+
+  /**
+   * @brief Add an event to the queue, dropping it if nothing is taking
+   *  events.
+   */
+  void ButtonEvents::pushEvent(const Button& button, EventType type,
+                               uint32_t time) {
+    if (this->eventCount >= EVENT_QUEUE_LEN) {
+      this->droppedEvents++;
+      LOG_WARN("Buttons: event queue full, %lu events dropped",
+               this->droppedEvents);
+      return;
+    }
+    this->events[(this->eventHead + this->eventCount) % EVENT_QUEUE_LEN] = {
+      button.index, type, time};
+    this->eventCount++;
+  }
+} // ButtonEvents
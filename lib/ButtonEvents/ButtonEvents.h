@@ -0,0 +1,158 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_BUTTONEVENTS_H
+#define PICO2W_STOCK_TICKER_BUTTONEVENTS_H
+
+#include <Arduino.h>
+#include <hardware/sync.h>
+#include <Log.h>
+
+namespace ButtonEvents {
+  const uint8_t MAX_BUTTONS = 4;
+  // Raw edges waiting for update(), one bouncy press can make a dozen. Must be
+  // a power of two.
+  const uint8_t EDGE_QUEUE_LEN = 32;
+  const uint8_t EVENT_QUEUE_LEN = 8;
+  // Returned by addButton() when there is no room for another button
+  const uint8_t NO_BUTTON = UINT8_MAX;
+  // Milliseconds
+  const uint16_t DEFAULT_DEBOUNCE_TIME = 50;
+  const uint16_t DEFAULT_LONG_PRESS_TIME = 1000;
+  const uint16_t DEFAULT_DOUBLE_CLICK_TIME = 300;
+
+  static_assert((EDGE_QUEUE_LEN & (EDGE_QUEUE_LEN - 1)) == 0,
+                "EDGE_QUEUE_LEN must be a power of two");
+
+  enum class EventType {
+    // Went down, every press has one
+    PRESS,
+    // Came back up, every press has one
+    RELEASE,
+    // A short press with no second one within the double click time
+    CLICK,
+    // Two short presses, the second released within the double click time of
+    // the first, instead of two CLICKs
+    DOUBLE_CLICK,
+    // Held for the long press time, instead of a CLICK
+    LONG_PRESS
+  };
+
+  struct Event {
+      uint8_t button;
+      EventType type;
+      // millis() when it happened, not when update() noticed
+      uint32_t time;
+  };
+
+  /**
+   * @brief Turns button presses into events like clicks and long presses,
+   *  from pin change interrupts instead of polling the pins.
+   *
+   * The interrupt only reads the pin and queues it with millis(), everything
+   * else happens in update() from those timestamps. So a loop() that was
+   * busy for a second still sees a long press as long, and an edge can't be
+   * lost between checking for a press and checking for a release. Buttons are
+   * active low.
+   *
+   * Only update() and the interrupt touch the edge queue, so it needs no
+   * locks as long as update() and the interrupts run on the same core.
+   */
+  class ButtonEvents {
+    public:
+      ButtonEvents() = default;
+      ~ButtonEvents() = default;
+
+      void begin(void (*onEdge)() = nullptr);
+      void end();
+      uint8_t addButton(uint8_t pin, bool useInternalPullup = true);
+      void update();
+      bool nextEvent(Event& event);
+      bool getNextUpdateTime(uint32_t& time) const;
+
+      /**
+       * @brief Set how long each gesture takes, in milliseconds.
+       *
+       * @param debounce Changes this soon after the last one are bounce.
+       * @param longPress Hold this long for a LONG_PRESS.
+       * @param doubleClick Most time from releasing a click to releasing the
+       *  next for a DOUBLE_CLICK.
+       */
+      void setTimings(uint16_t debounce, uint16_t longPress,
+                      uint16_t doubleClick) {
+        this->debounceTime = debounce;
+        this->longPressTime = longPress;
+        this->doubleClickTime = doubleClick;
+      }
+
+      /**
+       * @brief Check if a button is down right now, after debouncing.
+       *
+       * @param button From addButton().
+       * @return true if it is pressed.
+       */
+      bool isPressed(uint8_t button) const {
+        return button < this->buttonCount &&
+               this->buttons[button].level == PRESSED;
+      }
+
+      static constexpr bool PRESSED = LOW;
+      static constexpr bool RELEASED = HIGH;
+
+    protected:
+      struct Edge {
+          uint8_t button;
+          bool level;
+          uint32_t time;
+      };
+
+      struct Button {
+          // For the interrupt to find its way back
+          ButtonEvents* owner;
+          uint8_t index;
+          uint8_t pin;
+          // Debounced level
+          bool level;
+          uint32_t changeTime;
+          // Last level the interrupt read, may still be bouncing
+          bool rawLevel;
+          uint32_t rawTime;
+          uint32_t pressTime;
+          // LONG_PRESS already sent for this press
+          bool longPressed;
+          // Released a click that might still become a DOUBLE_CLICK
+          bool clickPending;
+          uint32_t clickTime;
+      };
+
+      Button buttons[MAX_BUTTONS] = {};
+      uint8_t buttonCount = 0;
+      void (*onEdge)() = nullptr;
+
+      uint16_t debounceTime = DEFAULT_DEBOUNCE_TIME;
+      uint16_t longPressTime = DEFAULT_LONG_PRESS_TIME;
+      uint16_t doubleClickTime = DEFAULT_DOUBLE_CLICK_TIME;
+
+      // Written by the interrupt, free running, wrapped when indexing
+      Edge edges[EDGE_QUEUE_LEN] = {};
+      volatile uint8_t edgeHead = 0;
+      volatile uint8_t edgeTail = 0;
+      volatile uint32_t droppedEdges = 0;
+      uint32_t reportedDroppedEdges = 0;
+
+      Event events[EVENT_QUEUE_LEN] = {};
+      uint8_t eventHead = 0;
+      uint8_t eventCount = 0;
+      uint32_t droppedEvents = 0;
+
+      static void onPinChange(void* param);
+      void pushEdge(uint8_t button, bool level, uint32_t time);
+      void handleEdge(Button& button, bool level, uint32_t time);
+      void applyLevel(Button& button, bool level, uint32_t time);
+      void checkTimers(Button& button, uint32_t now);
+      void pushEvent(const Button& button, EventType type, uint32_t time);
+  };
+} // ButtonEvents
+
+#endif // PICO2W_STOCK_TICKER_BUTTONEVENTS_H
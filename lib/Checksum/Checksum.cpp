@@ -0,0 +1,31 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#include <Checksum.h>
+
+namespace Checksum {
+  /**
+   * @brief Calculate the CRC-32 (same as zlib) of some data.
+   *
+   * Bitwise instead of table driven to save flash and RAM, it's only used on
+   * a few hundred bytes at a time.
+   *
+   * @param data The data.
+   * @param len How many bytes of data there are.
+   * @param crc The CRC of the data before this, to checksum data in pieces.
+   *  0 to start a new checksum.
+   * @return uint32_t The CRC-32.
+   */
+  uint32_t crc32(const void* data, size_t len, uint32_t crc /* = 0 */) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+      crc ^= bytes[i];
+      for (uint8_t bit = 0; bit < 8; bit++) {
+        crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+      }
+    }
+    return ~crc;
+  }
+} // Checksum
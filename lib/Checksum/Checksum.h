@@ -0,0 +1,14 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_CHECKSUM_H
+#define PICO2W_STOCK_TICKER_CHECKSUM_H
+
+#include <Arduino.h>
+
+namespace Checksum {
+  uint32_t crc32(const void* data, size_t len, uint32_t crc = 0);
+} // Checksum
+
+#endif // PICO2W_STOCK_TICKER_CHECKSUM_H
@@ -0,0 +1,108 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#include <IdleScheduler.h>
+
+namespace IdleScheduler {
+  /**
+   * @brief Start measuring, call at the end of setup().
+   */
+  void IdleScheduler::begin() {
+    this->hasDeadline = false;
+    this->wakeRequested = false;
+    this->reportStartMicros = micros();
+    this->sleptMicros = 0;
+    this->sleepCount = 0;
+    this->earlyWakeCount = 0;
+    this->maxLateness = 0;
+    this->nextReportTime = millis() + IDLE_REPORT_PERIOD;
+  }
+
+  /**
+   * @brief Make the next idle() return by a deadline, the soonest one given
+   *  since the last idle() is used.
+   *
+   * @param time millis() time something has to happen by.
+   */
+  void IdleScheduler::wakeBy(uint32_t time) {
+    if (!this->hasDeadline ||
+        static_cast<int32_t>(time - this->deadline) < 0) {
+      this->deadline = time;
+      this->hasDeadline = true;
+    }
+  }
+
+  /**
+   * @brief End the current or next idle() early. Safe to call from an
+   *  interrupt.
+   */
+  void IdleScheduler::wake() {
+    this->wakeRequested = true;
+    // In case the core is between checking the flag and waiting
+    __sev();
+  }
+
+  /**
+   * @brief Sleep until the soonest deadline given with wakeBy(), at most
+   *  MAX_IDLE, or until wake(). Call at the end of every loop().
+   */
+  void IdleScheduler::idle() {
+    const uint32_t now = millis();
+    uint32_t until = now + MAX_IDLE;
+    if (this->hasDeadline &&
+        static_cast<int32_t>(this->deadline - until) < 0) {
+      until = this->deadline;
+    }
+    this->hasDeadline = false;
+    if (static_cast<int32_t>(now - this->nextReportTime) >= 0) {
+      this->report();
+    }
+    #ifdef LOW_POWER_IDLE
+    const int32_t remaining = static_cast<int32_t>(until - now);
+    if (remaining <= 0 || this->wakeRequested) {
+      this->wakeRequested = false;
+      return;
+    }
+    const uint64_t start = time_us_64();
+    // Wake on the microsecond millis() reaches the deadline, not a remaining
+    // count of milliseconds from somewhere in the current one
+    const absolute_time_t wakeTime = from_us_since_boot(
+      start - start % 1000 + static_cast<uint64_t>(remaining) * 1000);
+    while (!this->wakeRequested && !best_effort_wfe_or_timeout(wakeTime)) {
+      // Some other interrupt, it has been handled, keep sleeping
+    }
+    const uint64_t end = time_us_64();
+    if (this->wakeRequested) {
+      this->wakeRequested = false;
+      this->earlyWakeCount++;
+    } else {
+      this->maxLateness =
+        max(this->maxLateness,
+            static_cast<uint32_t>(end - to_us_since_boot(wakeTime)));
+    }
+    this->sleptMicros += static_cast<uint32_t>(end - start);
+    this->sleepCount++;
+    #endif
+  }
+
+  void IdleScheduler::report() {
+    const uint32_t elapsed = micros() - this->reportStartMicros;
+    // Tenths of a percent
+    const uint32_t awake =
+      elapsed > 0 ? 1000 - static_cast<uint32_t>(
+                             static_cast<uint64_t>(this->sleptMicros) * 1000 /
+                             elapsed)
+                  : 1000;
+    LOG_INFO("Idle: awake %lu.%lu%% of the last %lu s, %lu sleeps (%lu "
+             "ended early), woke up to %lu us after a deadline",
+             awake / 10, awake % 10, elapsed / 1000000, this->sleepCount,
+             this->earlyWakeCount, this->maxLateness);
+    this->reportStartMicros = micros();
+    this->sleptMicros = 0;
+    this->sleepCount = 0;
+    this->earlyWakeCount = 0;
+    this->maxLateness = 0;
+    this->nextReportTime = millis() + IDLE_REPORT_PERIOD;
+  }
+} // IdleScheduler
@@ -0,0 +1,66 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_IDLESCHEDULER_H
+#define PICO2W_STOCK_TICKER_IDLESCHEDULER_H
+
+#ifndef LOW_POWER_IDLE
+  #define LOW_POWER_IDLE
+#endif
+
+#include <Arduino.h>
+#include <hardware/sync.h>
+#include <Log.h>
+#include <pico/time.h>
+
+namespace IdleScheduler {
+  // Longest sleep, for anything that is polled instead of having a deadline,
+  // like the WiFi link while it connects
+  const uint32_t MAX_IDLE = 50;
+  const uint32_t IDLE_REPORT_PERIOD = 10 * 60 * 1000;
+
+  /**
+   * @brief Sleeps between iterations of loop() until the soonest thing that
+   *  has to happen, instead of spinning.
+   *
+   * Each loop() tells it the deadlines it knows of with wakeBy(), then calls
+   * idle(). The core waits for events (WFE) with a timer alarm at the
+   * deadline. Other interrupts, like USB or the WiFi chip, are handled by
+   * their own handlers and the core goes back to sleep, only wake() (from a
+   * button interrupt for example) ends the sleep early.
+   *
+   * How much of the time the core was awake, and how late it woke up for
+   * deadlines, is logged every IDLE_REPORT_PERIOD. Without LOW_POWER_IDLE
+   * idle() returns right away, for comparing against a spinning loop().
+   */
+  class IdleScheduler {
+    public:
+      IdleScheduler() = default;
+      ~IdleScheduler() = default;
+
+      void begin();
+      void wakeBy(uint32_t time);
+      void idle();
+      void wake();
+
+    protected:
+      // Soonest deadline given since the last idle()
+      uint32_t deadline = 0;
+      bool hasDeadline = false;
+      volatile bool wakeRequested = false;
+
+      // Since the last report
+      uint32_t reportStartMicros = 0;
+      uint32_t sleptMicros = 0;
+      uint32_t sleepCount = 0;
+      uint32_t earlyWakeCount = 0;
+      // Longest time from a deadline to waking up for it
+      uint32_t maxLateness = 0;
+      uint32_t nextReportTime = 0;
+
+      void report();
+  };
+} // IdleScheduler
+
+#endif // PICO2W_STOCK_TICKER_IDLESCHEDULER_H
@@ -0,0 +1,245 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#include <Log.h>
+
+namespace Log {
+  Logger logger;
+
+  namespace {
+    constexpr const char* LEVEL_NAMES[] = {"none", "error", "warn", "info",
+                                           "debug"};
+    // Same order as LEVEL_NAMES
+    constexpr char LEVEL_TAGS[] = {'-', 'E', 'W', 'I', 'D'};
+  } // namespace
+
+  /**
+   * @brief Find the level with a name.
+   *
+   * @param name "none", "error", "warn", "info" or "debug".
+   * @return Level The level, INFO if the name isn't one.
+   */
+  Level parseLevel(const char* name) {
+    for (uint8_t i = 0; i < sizeof(LEVEL_NAMES) / sizeof(LEVEL_NAMES[0]);
+         i++) {
+      if (strcmp(name, LEVEL_NAMES[i]) == 0) {
+        return static_cast<Level>(i);
+      }
+    }
+    return Level::INFO;
+  }
+
+  /**
+   * @brief Start Serial1 and the DMA channel that sends to it, call before
+   *  logging anything.
+   */
+  void Logger::begin() {
+    Serial1.begin(LOG_BAUD_RATE);
+    #ifdef LOG_DRAIN_DMA
+    // Without a free channel drain() feeds the FIFO instead
+    this->dmaChannel = dma_claim_unused_channel(false);
+    if (this->dmaChannel >= 0) {
+      dma_channel_config config =
+        dma_channel_get_default_config(this->dmaChannel);
+      channel_config_set_transfer_data_size(&config, DMA_SIZE_8);
+      channel_config_set_read_increment(&config, true);
+      channel_config_set_write_increment(&config, false);
+      // Paced by the UART taking bytes, Serial1 is UART0
+      channel_config_set_dreq(&config, uart_get_dreq_num(uart0, true));
+      dma_channel_configure(this->dmaChannel, &config,
+                            &uart_get_hw(uart0)->dr, nullptr, 0, false);
+    }
+    #endif
+  }
+
+  /**
+   * @brief Log a line if its level is enabled, formatted like printf()
+   *  without the line break.
+   *
+   * @param lineLevel The line's level.
+   * @param format The printf() format.
+   */
+  void Logger::log(Level lineLevel, const char* format, ...) {
+    if (lineLevel == Level::NONE || lineLevel > this->level) {
+      return;
+    }
+    char line[MAX_LOG_LINE_LEN];
+    int len = snprintf(line, sizeof(line), "%lu %c ", millis(),
+                       LEVEL_TAGS[static_cast<uint8_t>(lineLevel)]);
+    va_list args;
+    va_start(args, format);
+    const int written = vsnprintf(line + len, sizeof(line) - len, format, args);
+    va_end(args);
+    // Cut off to leave room for the line break
+    len = min(len + max(written, 0), static_cast<int>(sizeof(line)) - 3);
+    line[len++] = '\r';
+    line[len++] = '\n';
+
+    // Whatever finished sending makes room
+    this->drain();
+    uint32_t start;
+    const uint32_t drops = this->unreportedDrops.exchange(0);
+    if (drops > 0) {
+      char note[48];
+      const int noteLen = snprintf(note, sizeof(note),
+                                   "%lu W %lu log lines dropped\r\n", millis(),
+                                   drops);
+      if (this->reserve(noteLen + len, start)) {
+        this->copyIn(start, note, noteLen);
+        this->copyIn(start + noteLen, line, len);
+        this->commit();
+        this->drain();
+        return;
+      }
+      // Noted with the next line that has room for it
+      this->unreportedDrops += drops;
+    }
+    if (!this->reserve(len, start)) {
+      this->countDrop();
+      return;
+    }
+    this->copyIn(start, line, len);
+    this->commit();
+    this->drain();
+  }
+
+  size_t Logger::write(uint8_t c) {
+    return this->write(&c, 1);
+  }
+
+  size_t Logger::write(const uint8_t* buffer, size_t size) {
+    this->drain();
+    uint32_t start;
+    if (!this->reserve(size, start)) {
+      this->countDrop();
+      return 0;
+    }
+    this->copyIn(start, reinterpret_cast<const char*>(buffer), size);
+    this->commit();
+    this->drain();
+    return size;
+  }
+
+  /**
+   * @brief Get how many bytes fit in the ring right now, another writer may
+   *  take them first.
+   */
+  int Logger::availableForWrite() {
+    const uint32_t used =
+      (this->reserveState.load() - this->tail.load()) & LOG_POSITION_MASK;
+    return static_cast<int>(LOG_RING_SIZE - used);
+  }
+
+  /**
+   * @brief Reserve room for len bytes in the ring and count the caller as a
+   *  writer until it calls commit().
+   *
+   * @param len How many bytes.
+   * @param start Set to where they go.
+   * @return true if there was room.
+   */
+  bool Logger::reserve(uint32_t len, uint32_t& start) {
+    uint32_t state = this->reserveState.load();
+    do {
+      start = state & LOG_POSITION_MASK;
+      const uint32_t used = (start - this->tail.load()) & LOG_POSITION_MASK;
+      if (len > LOG_RING_SIZE - used) {
+        return false;
+      }
+    } while (!this->reserveState.compare_exchange_weak(
+      state, ((state & ~LOG_POSITION_MASK) + LOG_WRITER) |
+               ((start + len) & LOG_POSITION_MASK)));
+    return true;
+  }
+
+  /**
+   * @brief Copy bytes into reserved room.
+   */
+  void Logger::copyIn(uint32_t start, const char* data, uint32_t len) {
+    for (uint32_t i = 0; i < len; i++) {
+      this->ring[(start + i) & (LOG_RING_SIZE - 1)] = data[i];
+    }
+  }
+
+  /**
+   * @brief Stop counting the caller as a writer. The last writer out
+   *  publishes everything reserved so far, since all of it is copied by then.
+   */
+  void Logger::commit() {
+    const uint32_t state = this->reserveState.fetch_sub(LOG_WRITER) -
+                           LOG_WRITER;
+    if ((state & ~LOG_POSITION_MASK) != 0) {
+      return;
+    }
+    const uint32_t end = state & LOG_POSITION_MASK;
+    // Only forward, a writer that got here first may store after a later one
+    uint32_t published = this->head.load();
+    while (static_cast<int32_t>((end - published) << 8) > 0 &&
+           !this->head.compare_exchange_weak(published, end)) {
+    }
+  }
+
+  void Logger::countDrop() {
+    this->droppedCount++;
+    this->unreportedDrops++;
+  }
+
+  /**
+   * @brief Send more of the ring to the UART without waiting. Call every
+   *  loop().
+   *
+   * With DMA, once the last transfer is done the next one is started for
+   * everything up to the end of the ring. Without, as many bytes as the
+   * UART's FIFO has room for are written to it. If another caller is
+   * draining, this one leaves it to them.
+   */
+  void Logger::drain() {
+    if (this->draining.exchange(true)) {
+      return;
+    }
+    const uint32_t published = this->head.load();
+    uint32_t sent = this->tail.load();
+    #ifdef LOG_DRAIN_DMA
+    if (this->dmaChannel >= 0) {
+      if (this->inFlight > 0 && !dma_channel_is_busy(this->dmaChannel)) {
+        sent += this->inFlight;
+        this->inFlight = 0;
+        this->tail.store(sent & LOG_POSITION_MASK);
+      }
+      if (this->inFlight == 0) {
+        const uint32_t start = sent & (LOG_RING_SIZE - 1);
+        // The part after the ring wraps goes in the next transfer
+        this->inFlight = min((published - sent) & LOG_POSITION_MASK,
+                             LOG_RING_SIZE - start);
+        if (this->inFlight > 0) {
+          dma_channel_transfer_from_buffer_now(
+            this->dmaChannel, this->ring + start, this->inFlight);
+        }
+      }
+      this->draining = false;
+      return;
+    }
+    #endif
+    uint32_t count =
+      min((published - sent) & LOG_POSITION_MASK,
+          static_cast<uint32_t>(max(Serial1.availableForWrite(), 0)));
+    for (; count > 0; count--) {
+      Serial1.write(this->ring[sent & (LOG_RING_SIZE - 1)]);
+      sent++;
+    }
+    this->tail.store(sent & LOG_POSITION_MASK);
+    this->draining = false;
+  }
+
+  /**
+   * @brief Wait until everything logged so far is out of the UART, like
+   *  before rebooting.
+   */
+  void Logger::flush() {
+    while (this->head.load() != this->tail.load()) {
+      this->drain();
+    }
+    Serial1.flush();
+  }
+} // Log
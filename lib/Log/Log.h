@@ -0,0 +1,167 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_LOG_H
+#define PICO2W_STOCK_TICKER_LOG_H
+
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+
+// Most detailed level compiled in, anything above it costs nothing
+#ifndef LOG_LEVEL
+  #define LOG_LEVEL LOG_LEVEL_DEBUG
+#endif
+// Send the ring to the UART with DMA, instead of as much as the UART's FIFO
+// takes on each drain()
+#ifndef LOG_DRAIN_DMA
+  #define LOG_DRAIN_DMA
+#endif
+
+#include <Arduino.h>
+#include <atomic>
+#ifdef LOG_DRAIN_DMA
+  #include <hardware/dma.h>
+  #include <hardware/uart.h>
+#endif
+
+namespace Log {
+  // Power of two so indices can run freely and wrap
+  const uint32_t LOG_RING_SIZE = 4096;
+  // Longest line, longer ones are cut off
+  const size_t MAX_LOG_LINE_LEN = 320;
+  const uint32_t LOG_BAUD_RATE = 115200;
+
+  static_assert((LOG_RING_SIZE & (LOG_RING_SIZE - 1)) == 0,
+                "LOG_RING_SIZE should be a power of two");
+  // Ring positions run freely in the low 24 bits, the top 8 of the
+  // reservation state count the writers
+  const uint32_t LOG_POSITION_MASK = 0xFFFFFF;
+  const uint32_t LOG_WRITER = LOG_POSITION_MASK + 1;
+  static_assert(LOG_RING_SIZE <= LOG_POSITION_MASK,
+                "LOG_RING_SIZE should fit in a ring position");
+
+  enum class Level : uint8_t {
+    NONE = LOG_LEVEL_NONE,
+    ERROR = LOG_LEVEL_ERROR,
+    WARN = LOG_LEVEL_WARN,
+    INFO = LOG_LEVEL_INFO,
+    DEBUG = LOG_LEVEL_DEBUG
+  };
+
+  Level parseLevel(const char* name);
+
+  /**
+   * @brief Formats log lines into a ring buffer and sends them to Serial1 in
+   *  the background, so logging never waits on the UART.
+   *
+   * Each line is added whole or not at all, lines that don't fit are counted
+   * as dropped and a note of how many is logged once there is room again.
+   * With LOG_DRAIN_DMA a DMA channel sends the ring to the UART, otherwise
+   * drain() hands it as much as fits in its FIFO. Either way drain() should
+   * be called every loop(), logging calls it too.
+   *
+   * Either core and interrupt handlers can log too. A writer reserves its
+   * bytes with a compare-and-swap that also counts it as copying, and the
+   * last writer to finish publishes everything reserved so far, so no
+   * writer ever waits on another (which an interrupt on the same core would
+   * do forever). Only one caller drains at a time, one that finds drain()
+   * taken leaves it to that one. Without DMA, draining writes to Serial1,
+   * which shouldn't happen in an interrupt, so there handlers and their
+   * callbacks (like FatFSUSB's onPlug) still set a flag for loop() to log.
+   */
+  class Logger : public Print {
+    public:
+      Logger() = default;
+      ~Logger() override = default;
+
+      void begin();
+      void log(Level level, const char* format, ...)
+        __attribute__((format(printf, 3, 4)));
+      void drain();
+      void flush() override;
+
+      // Raw bytes without a level or line, for dumping streams like
+      // ReadLoggingStream
+      size_t write(uint8_t c) override;
+      size_t write(const uint8_t* buffer, size_t size) override;
+      int availableForWrite() override;
+
+      /**
+       * @brief Set the most detailed level to log, lines past it are skipped
+       *  without formatting them.
+       *
+       * @param newLevel The level.
+       */
+      void setLevel(Level newLevel) {
+        this->level = newLevel;
+      }
+
+      Level getLevel() const {
+        return this->level;
+      }
+
+      /**
+       * @brief Get how many lines didn't fit in the ring since boot.
+       *
+       * @return uint32_t
+       */
+      uint32_t getDroppedCount() const {
+        return this->droppedCount;
+      }
+
+    protected:
+      char ring[LOG_RING_SIZE];
+      // Where the next reservation starts, and the writers still copying
+      // into theirs times LOG_WRITER, so both change in one compare-and-swap
+      std::atomic<uint32_t> reserveState{0};
+      // Everything before head is whole and can be sent, the oldest byte not
+      // sent yet is at tail
+      std::atomic<uint32_t> head{0};
+      std::atomic<uint32_t> tail{0};
+      // Held by whoever is in drain()
+      std::atomic<bool> draining{false};
+      // Bytes from tail on that the DMA channel is sending, only drain()
+      // touches it
+      uint32_t inFlight = 0;
+      int dmaChannel = -1;
+
+      Level level = Level::INFO;
+      std::atomic<uint32_t> droppedCount{0};
+      // Dropped since the last note about it
+      std::atomic<uint32_t> unreportedDrops{0};
+
+      bool reserve(uint32_t len, uint32_t& start);
+      void copyIn(uint32_t start, const char* data, uint32_t len);
+      void commit();
+      void countDrop();
+  };
+
+  extern Logger logger;
+} // Log
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+  #define LOG_ERROR(...) Log::logger.log(Log::Level::ERROR, __VA_ARGS__)
+#else
+  #define LOG_ERROR(...) do { } while (false)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+  #define LOG_WARN(...) Log::logger.log(Log::Level::WARN, __VA_ARGS__)
+#else
+  #define LOG_WARN(...) do { } while (false)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+  #define LOG_INFO(...) Log::logger.log(Log::Level::INFO, __VA_ARGS__)
+#else
+  #define LOG_INFO(...) do { } while (false)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+  #define LOG_DEBUG(...) Log::logger.log(Log::Level::DEBUG, __VA_ARGS__)
+#else
+  #define LOG_DEBUG(...) do { } while (false)
+#endif
+
+#endif // PICO2W_STOCK_TICKER_LOG_H
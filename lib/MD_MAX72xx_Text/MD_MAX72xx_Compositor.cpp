@@ -0,0 +1,58 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#include "MD_MAX72xx_Compositor.h"
+
+/**
+ * @brief Give a renderer a zone of the display.
+ *
+ * The renderer must draw into the same framebuffer as this compositor. Zones
+ * should not overlap, a renderer clears its own zone before drawing.
+ *
+ * @param renderer The renderer that draws the zone.
+ * @param firstX The first column of the zone, counted from the left edge.
+ * @param width How many columns wide the zone is. 0 means everything from
+ *  firstX to the right edge of the display.
+ * @param period The minimum time in milliseconds between each render of this
+ *  zone. 0 means render on every update and let the renderer pace itself.
+ * @return true if the zone was added, false if there are already
+ *  MAX_COMPOSITOR_ZONES zones or the renderer draws into another framebuffer.
+ */
+bool MD_MAX72XX_Compositor::addZone(MD_MAX72XX_Renderer* renderer,
+                                    uint16_t firstX, uint16_t width /* = 0 */,
+                                    uint32_t period /* = 0 */) {
+  if (this->zoneCount >= MAX_COMPOSITOR_ZONES ||
+      renderer->getZone().getFramebuffer() != this->framebuffer) {
+    return false;
+  }
+  renderer->setZone(firstX, width);
+  this->zones[this->zoneCount] = {renderer, period, millis()};
+  this->zoneCount++;
+  return true;
+}
+
+/**
+ * @brief Call this function as often as possible to render every zone that is
+ *  due, then flush the framebuffer once if any of them changed.
+ *
+ * A zone that is not due or did not change costs a millis() comparison and a
+ * virtual call, and nothing is sent to the display if no zone changed.
+ */
+void MD_MAX72XX_Compositor::update() {
+  const uint32_t now = millis();
+  bool changed = false;
+  for (uint8_t i = 0; i < this->zoneCount; i++) {
+    ZoneEntry& entry = this->zones[i];
+    if (static_cast<int32_t>(now - entry.nextRenderTime) < 0) {
+      continue; // Not time to render this zone yet
+    }
+    entry.nextRenderTime = now + entry.period;
+    if (entry.renderer->render()) {
+      changed = true;
+    }
+  }
+  if (changed) {
+    this->framebuffer->flush();
+  }
+}
@@ -0,0 +1,61 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_MD_MAX72XX_COMPOSITOR_H
+#define PICO2W_STOCK_TICKER_MD_MAX72XX_COMPOSITOR_H
+
+#include <Arduino.h>
+#include <MD_MAX72xx_Framebuffer.h>
+#include <MD_MAX72xx_Renderer.h>
+
+const uint8_t MAX_COMPOSITOR_ZONES = 4;
+
+// Splits the display into zones, each drawn by its own renderer into one
+// shared framebuffer that is flushed at most once per update.
+class MD_MAX72XX_Compositor {
+  public:
+    /**
+     * @brief Constructor for MD_MAX72XX_Compositor.
+     *
+     * @param framebuffer A pointer to the framebuffer all zones draw into.
+     */
+    MD_MAX72XX_Compositor(MD_MAX72XX_Framebuffer* framebuffer) {
+      this->framebuffer = framebuffer;
+    }
+    ~MD_MAX72XX_Compositor() = default;
+
+    bool addZone(MD_MAX72XX_Renderer* renderer, uint16_t firstX,
+                 uint16_t width = 0, uint32_t period = 0);
+
+    /**
+     * @brief Remove all zones. Does not clear the framebuffer.
+     */
+    void removeAllZones() {
+      this->zoneCount = 0;
+    }
+
+    /**
+     * @brief Get how many zones have been added.
+     *
+     * @return uint8_t The number of zones.
+     */
+    uint8_t getZoneCount() const {
+      return this->zoneCount;
+    }
+
+    void update();
+
+  protected:
+    struct ZoneEntry {
+        MD_MAX72XX_Renderer* renderer;
+        uint32_t period;
+        uint32_t nextRenderTime;
+    };
+
+    MD_MAX72XX_Framebuffer* framebuffer = nullptr;
+    ZoneEntry zones[MAX_COMPOSITOR_ZONES] = {};
+    uint8_t zoneCount = 0;
+};
+
+#endif // PICO2W_STOCK_TICKER_MD_MAX72XX_COMPOSITOR_H
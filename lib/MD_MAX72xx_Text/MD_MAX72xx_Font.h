@@ -0,0 +1,294 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_MD_MAX72XX_FONT_H
+#define PICO2W_STOCK_TICKER_MD_MAX72XX_FONT_H
+
+#include <Arduino.h>
+
+// Proportional 7 pixel tall font. Glyphs are written as fixed 5 column cells
+// (least significant bit is the top row) and trimmed at compile time into
+// flat width, offset and bitmap tables, so drawing a character is two table
+// lookups instead of a font search through MD_MAX72XX::getChar().
+namespace MD_MAX72XX_Font {
+  // Custom glyphs, placed below space like code page 437 does
+  const char UP_ARROW = '\x1E';
+  const char DOWN_ARROW = '\x1F';
+
+  const uint8_t FIRST_CHAR = 0x1E;
+  const uint8_t LAST_CHAR = 0x7E;
+  const uint8_t GLYPH_COUNT = LAST_CHAR - FIRST_CHAR + 1;
+  // Drawn for characters outside of FIRST_CHAR and LAST_CHAR
+  const char FALLBACK_CHAR = '?';
+
+  // Sparkline bars, one column wide and drawn without spacing so a run of
+  // them reads as one graph. SPARKLINE_FIRST_CHAR is the shortest bar (just
+  // the bottom row) and each next character is one row taller.
+  const uint8_t SPARKLINE_FIRST_CHAR = 0x80;
+  const uint8_t SPARKLINE_LEVELS = 8;
+
+  const uint8_t CELL_WIDTH = 5;
+  // Space is all blank so it would be trimmed to nothing
+  const uint8_t SPACE_WIDTH = 2;
+
+  // clang-format off
+  inline constexpr uint8_t CELLS[GLYPH_COUNT][CELL_WIDTH] = {
+    {0x10, 0x18, 0x1C, 0x18, 0x10}, // 0x1E up arrow
+    {0x04, 0x0C, 0x1C, 0x0C, 0x04}, // 0x1F down arrow
+    {0x00, 0x00, 0x00, 0x00, 0x00}, // space
+    {0x00, 0x00, 0x5F, 0x00, 0x00}, // !
+    {0x00, 0x07, 0x00, 0x07, 0x00}, // "
+    {0x14, 0x7F, 0x14, 0x7F, 0x14}, // #
+    {0x00, 0x2E, 0x6B, 0x3A, 0x00}, // $ (narrow)
+    {0x23, 0x13, 0x08, 0x64, 0x62}, // %
+    {0x36, 0x49, 0x55, 0x22, 0x50}, // &
+    {0x00, 0x05, 0x03, 0x00, 0x00}, // '
+    {0x00, 0x1C, 0x22, 0x41, 0x00}, // (
+    {0x00, 0x41, 0x22, 0x1C, 0x00}, // )
+    {0x08, 0x2A, 0x1C, 0x2A, 0x08}, // *
+    {0x08, 0x08, 0x3E, 0x08, 0x08}, // +
+    {0x00, 0x50, 0x30, 0x00, 0x00}, // ,
+    {0x08, 0x08, 0x08, 0x08, 0x08}, // -
+    {0x00, 0x60, 0x60, 0x00, 0x00}, // .
+    {0x20, 0x10, 0x08, 0x04, 0x02}, // /
+    {0x3E, 0x51, 0x49, 0x45, 0x3E}, // 0
+    {0x00, 0x42, 0x7F, 0x40, 0x00}, // 1
+    {0x42, 0x61, 0x51, 0x49, 0x46}, // 2
+    {0x21, 0x41, 0x45, 0x4B, 0x31}, // 3
+    {0x18, 0x14, 0x12, 0x7F, 0x10}, // 4
+    {0x27, 0x45, 0x45, 0x45, 0x39}, // 5
+    {0x3C, 0x4A, 0x49, 0x49, 0x30}, // 6
+    {0x01, 0x71, 0x09, 0x05, 0x03}, // 7
+    {0x36, 0x49, 0x49, 0x49, 0x36}, // 8
+    {0x06, 0x49, 0x49, 0x29, 0x1E}, // 9
+    {0x00, 0x36, 0x36, 0x00, 0x00}, // :
+    {0x00, 0x56, 0x36, 0x00, 0x00}, // ;
+    {0x08, 0x14, 0x22, 0x41, 0x00}, // <
+    {0x14, 0x14, 0x14, 0x14, 0x14}, // =
+    {0x00, 0x41, 0x22, 0x14, 0x08}, // >
+    {0x02, 0x01, 0x51, 0x09, 0x06}, // ?
+    {0x32, 0x49, 0x79, 0x41, 0x3E}, // @
+    {0x7E, 0x11, 0x11, 0x11, 0x7E}, // A
+    {0x7F, 0x49, 0x49, 0x49, 0x36}, // B
+    {0x3E, 0x41, 0x41, 0x41, 0x22}, // C
+    {0x7F, 0x41, 0x41, 0x22, 0x1C}, // D
+    {0x7F, 0x49, 0x49, 0x49, 0x41}, // E
+    {0x7F, 0x09, 0x09, 0x01, 0x01}, // F
+    {0x3E, 0x41, 0x41, 0x51, 0x32}, // G
+    {0x7F, 0x08, 0x08, 0x08, 0x7F}, // H
+    {0x00, 0x41, 0x7F, 0x41, 0x00}, // I
+    {0x20, 0x40, 0x41, 0x3F, 0x01}, // J
+    {0x7F, 0x08, 0x14, 0x22, 0x41}, // K
+    {0x7F, 0x40, 0x40, 0x40, 0x40}, // L
+    {0x7F, 0x02, 0x04, 0x02, 0x7F}, // M
+    {0x7F, 0x04, 0x08, 0x10, 0x7F}, // N
+    {0x3E, 0x41, 0x41, 0x41, 0x3E}, // O
+    {0x7F, 0x09, 0x09, 0x09, 0x06}, // P
+    {0x3E, 0x41, 0x51, 0x21, 0x5E}, // Q
+    {0x7F, 0x09, 0x19, 0x29, 0x46}, // R
+    {0x46, 0x49, 0x49, 0x49, 0x31}, // S
+    {0x01, 0x01, 0x7F, 0x01, 0x01}, // T
+    {0x3F, 0x40, 0x40, 0x40, 0x3F}, // U
+    {0x1F, 0x20, 0x40, 0x20, 0x1F}, // V
+    {0x7F, 0x20, 0x18, 0x20, 0x7F}, // W
+    {0x63, 0x14, 0x08, 0x14, 0x63}, // X
+    {0x03, 0x04, 0x78, 0x04, 0x03}, // Y
+    {0x61, 0x51, 0x49, 0x45, 0x43}, // Z
+    {0x00, 0x7F, 0x41, 0x41, 0x00}, // [
+    {0x02, 0x04, 0x08, 0x10, 0x20}, // backslash
+    {0x00, 0x41, 0x41, 0x7F, 0x00}, // ]
+    {0x04, 0x02, 0x01, 0x02, 0x04}, // ^
+    {0x40, 0x40, 0x40, 0x40, 0x40}, // _
+    {0x00, 0x01, 0x02, 0x04, 0x00}, // `
+    {0x20, 0x54, 0x54, 0x54, 0x78}, // a
+    {0x7F, 0x48, 0x44, 0x44, 0x38}, // b
+    {0x38, 0x44, 0x44, 0x44, 0x20}, // c
+    {0x38, 0x44, 0x44, 0x48, 0x7F}, // d
+    {0x38, 0x54, 0x54, 0x54, 0x18}, // e
+    {0x08, 0x7E, 0x09, 0x01, 0x02}, // f
+    {0x08, 0x14, 0x54, 0x54, 0x3C}, // g
+    {0x7F, 0x08, 0x04, 0x04, 0x78}, // h
+    {0x00, 0x44, 0x7D, 0x40, 0x00}, // i
+    {0x20, 0x40, 0x44, 0x3D, 0x00}, // j
+    {0x00, 0x7F, 0x10, 0x28, 0x44}, // k
+    {0x00, 0x41, 0x7F, 0x40, 0x00}, // l
+    {0x7C, 0x04, 0x18, 0x04, 0x78}, // m
+    {0x7C, 0x08, 0x04, 0x04, 0x78}, // n
+    {0x38, 0x44, 0x44, 0x44, 0x38}, // o
+    {0x7C, 0x14, 0x14, 0x14, 0x08}, // p
+    {0x08, 0x14, 0x14, 0x18, 0x7C}, // q
+    {0x7C, 0x08, 0x04, 0x04, 0x08}, // r
+    {0x48, 0x54, 0x54, 0x54, 0x20}, // s
+    {0x04, 0x3F, 0x44, 0x40, 0x20}, // t
+    {0x3C, 0x40, 0x40, 0x20, 0x7C}, // u
+    {0x1C, 0x20, 0x40, 0x20, 0x1C}, // v
+    {0x3C, 0x40, 0x30, 0x40, 0x3C}, // w
+    {0x44, 0x28, 0x10, 0x28, 0x44}, // x
+    {0x0C, 0x50, 0x50, 0x50, 0x3C}, // y
+    {0x44, 0x64, 0x54, 0x4C, 0x44}, // z
+    {0x00, 0x08, 0x36, 0x41, 0x00}, // {
+    {0x00, 0x00, 0x7F, 0x00, 0x00}, // |
+    {0x00, 0x41, 0x36, 0x08, 0x00}, // }
+    {0x02, 0x01, 0x02, 0x04, 0x02}, // ~
+  };
+  // clang-format on
+
+  /**
+   * @brief Get the first non-blank column of a cell.
+   */
+  constexpr uint8_t cellFirstColumn(const uint8_t* cell) {
+    uint8_t first = 0;
+    while (first < CELL_WIDTH && cell[first] == 0) {
+      first++;
+    }
+    return first;
+  }
+
+  /**
+   * @brief Get the trimmed width of a cell in columns.
+   */
+  constexpr uint8_t cellWidth(const uint8_t* cell) {
+    const uint8_t first = cellFirstColumn(cell);
+    if (first == CELL_WIDTH) {
+      return SPACE_WIDTH;
+    }
+    uint8_t last = CELL_WIDTH - 1;
+    while (cell[last] == 0) {
+      last--;
+    }
+    return last - first + 1;
+  }
+
+  /**
+   * @brief Get the total number of columns of all trimmed glyphs.
+   */
+  constexpr uint16_t totalWidth() {
+    uint16_t total = 0;
+    for (uint8_t i = 0; i < GLYPH_COUNT; i++) {
+      total += cellWidth(CELLS[i]);
+    }
+    return total;
+  }
+
+  const uint16_t BITMAP_SIZE = totalWidth();
+
+  struct Atlas {
+      uint8_t widths[GLYPH_COUNT];
+      uint16_t offsets[GLYPH_COUNT];
+      uint8_t bitmap[BITMAP_SIZE];
+  };
+
+  /**
+   * @brief Trim and pack every cell into one flat table.
+   */
+  constexpr Atlas buildAtlas() {
+    Atlas atlas = {};
+    uint16_t offset = 0;
+    for (uint8_t i = 0; i < GLYPH_COUNT; i++) {
+      const uint8_t first = cellFirstColumn(CELLS[i]);
+      const uint8_t width = cellWidth(CELLS[i]);
+      atlas.widths[i] = width;
+      atlas.offsets[i] = offset;
+      for (uint8_t col = 0; col < width; col++) {
+        // Blank glyphs have no first column, they are just blank bitmap
+        atlas.bitmap[offset + col] =
+          first + col < CELL_WIDTH ? CELLS[i][first + col] : 0;
+      }
+      offset += width;
+    }
+    return atlas;
+  }
+
+  inline constexpr Atlas ATLAS = buildAtlas();
+
+  static_assert(ATLAS.widths['$' - FIRST_CHAR] == 3, "$ should be narrow");
+  static_assert(ATLAS.widths[' ' - FIRST_CHAR] == SPACE_WIDTH,
+                "Space should not be trimmed away");
+
+  /**
+   * @brief Get the column of a sparkline bar, the most significant bit is the
+   *  bottom row.
+   */
+  constexpr uint8_t sparklineColumn(uint8_t level) {
+    return static_cast<uint8_t>(0xFF << (SPARKLINE_LEVELS - 1 - level));
+  }
+
+  inline constexpr uint8_t SPARKLINE_COLUMNS[SPARKLINE_LEVELS] = {
+    sparklineColumn(0), sparklineColumn(1), sparklineColumn(2),
+    sparklineColumn(3), sparklineColumn(4), sparklineColumn(5),
+    sparklineColumn(6), sparklineColumn(7)};
+
+  /**
+   * @brief Check if a character is a sparkline bar.
+   */
+  constexpr bool isSparklineChar(char c) {
+    return static_cast<uint8_t>(c) >= SPARKLINE_FIRST_CHAR &&
+           static_cast<uint8_t>(c) < SPARKLINE_FIRST_CHAR + SPARKLINE_LEVELS;
+  }
+
+  /**
+   * @brief Get the sparkline bar character for a level.
+   *
+   * @param level 0 (shortest) to SPARKLINE_LEVELS - 1 (full height).
+   */
+  constexpr char sparklineChar(uint8_t level) {
+    return static_cast<char>(
+      SPARKLINE_FIRST_CHAR +
+      (level < SPARKLINE_LEVELS ? level : SPARKLINE_LEVELS - 1));
+  }
+
+  /**
+   * @brief Get the index of a character in the atlas tables.
+   *
+   * @param c The character.
+   * @return uint8_t The index, which is FALLBACK_CHAR's for characters that
+   *  aren't in the font.
+   */
+  constexpr uint8_t glyphIndex(char c) {
+    const uint8_t code = static_cast<uint8_t>(c);
+    if (code < FIRST_CHAR || code > LAST_CHAR) {
+      return FALLBACK_CHAR - FIRST_CHAR;
+    }
+    return code - FIRST_CHAR;
+  }
+
+  /**
+   * @brief Get the width of a character in columns.
+   *
+   * @param c The character.
+   * @return uint8_t The width in columns, not including spacing.
+   */
+  constexpr uint8_t charWidth(char c) {
+    if (isSparklineChar(c)) {
+      return 1;
+    }
+    return ATLAS.widths[glyphIndex(c)];
+  }
+
+  /**
+   * @brief Get how many blank columns go after a character.
+   *
+   * @param c The character.
+   * @return uint8_t 0 for sparkline bars, 1 for everything else.
+   */
+  constexpr uint8_t charSpacing(char c) {
+    return isSparklineChar(c) ? 0 : 1;
+  }
+
+  /**
+   * @brief Get the columns of a character.
+   *
+   * @param c The character.
+   * @return const uint8_t* Pointer to charWidth(c) column bitmaps, left to
+   *  right.
+   */
+  constexpr const uint8_t* charColumns(char c) {
+    if (isSparklineChar(c)) {
+      return &SPARKLINE_COLUMNS[static_cast<uint8_t>(c) - SPARKLINE_FIRST_CHAR];
+    }
+    return &ATLAS.bitmap[ATLAS.offsets[glyphIndex(c)]];
+  }
+} // MD_MAX72XX_Font
+
+#endif // PICO2W_STOCK_TICKER_MD_MAX72XX_FONT_H
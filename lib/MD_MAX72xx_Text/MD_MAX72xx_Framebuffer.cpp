@@ -0,0 +1,67 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#include "MD_MAX72xx_Framebuffer.h"
+
+/**
+ * @brief Attach the framebuffer to a display, sizing it to the display.
+ *
+ * @param display A pointer to the MD_MAX72XX display object to flush to.
+ */
+void MD_MAX72XX_Framebuffer::begin(MD_MAX72XX* display) {
+  this->display = display;
+  this->columnCount = min(display->getColumnCount(),
+                          static_cast<uint16_t>(MAX_FRAMEBUFFER_COLUMNS));
+  memset(this->columns, 0, sizeof(this->columns));
+  // Everything is dirty so the first flush overwrites whatever the display had
+  this->dirtyFirstX = 0;
+  this->dirtyLastX = static_cast<int16_t>(this->columnCount) - 1;
+}
+
+/**
+ * @brief Set a column of the framebuffer. Out of range columns are ignored.
+ *
+ * @param x The column, counted from the left edge.
+ * @param value The column bitmap.
+ */
+void MD_MAX72XX_Framebuffer::setColumn(int16_t x, uint8_t value) {
+  if (x < 0 || x >= this->columnCount || this->columns[x] == value) {
+    return;
+  }
+  this->columns[x] = value;
+  this->markDirty(x);
+}
+
+/**
+ * @brief Clear a range of columns. Columns out of range are ignored.
+ *
+ * @param firstX The first column to clear, counted from the left edge.
+ * @param count How many columns to clear.
+ */
+void MD_MAX72XX_Framebuffer::clear(int16_t firstX, uint16_t count) {
+  const int16_t endX = min(static_cast<int16_t>(firstX + count),
+                           static_cast<int16_t>(this->columnCount));
+  for (int16_t x = max(firstX, static_cast<int16_t>(0)); x < endX; x++) {
+    this->setColumn(x, 0);
+  }
+}
+
+/**
+ * @brief Push the changed columns to the display and update it once.
+ *
+ * Does nothing if nothing changed since the last flush, so callers can flush
+ * every frame without cost.
+ */
+void MD_MAX72XX_Framebuffer::flush() {
+  if (!this->isDirty()) {
+    return;
+  }
+  // The display counts columns from the right edge
+  const uint16_t lastCol = this->display->getColumnCount() - 1;
+  for (int16_t x = this->dirtyFirstX; x <= this->dirtyLastX; x++) {
+    this->display->setColumn(lastCol - x, this->columns[x]);
+  }
+  this->display->update();
+  this->clearDirty();
+}
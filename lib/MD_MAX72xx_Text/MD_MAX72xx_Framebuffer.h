@@ -0,0 +1,127 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_MD_MAX72XX_FRAMEBUFFER_H
+#define PICO2W_STOCK_TICKER_MD_MAX72XX_FRAMEBUFFER_H
+
+#include <Arduino.h>
+#include <MD_MAX72xx.h>
+
+// 8 groups of four 8x8 modules, 8 columns each
+const uint16_t MAX_FRAMEBUFFER_COLUMNS = 8 * 4 * 8;
+
+// A copy of the display's columns that renderers draw into. Columns are
+// numbered from the left edge of the display, and only columns that actually
+// changed are pushed to the display on flush.
+class MD_MAX72XX_Framebuffer {
+  public:
+    /**
+     * @brief Constructor for MD_MAX72XX_Framebuffer, a shared framebuffer that
+     *  is flushed to a MD_MAX72XX display in one update. The framebuffer has
+     *  no columns until MD_MAX72XX_Framebuffer::begin() is called.
+     */
+    MD_MAX72XX_Framebuffer() = default;
+
+    /**
+     * @brief Constructor for MD_MAX72XX_Framebuffer, a shared framebuffer that
+     *  is flushed to a MD_MAX72XX display in one update.
+     *
+     * @param display A pointer to the MD_MAX72XX display object to flush to.
+     */
+    MD_MAX72XX_Framebuffer(MD_MAX72XX* display) {
+      this->begin(display);
+    }
+    virtual ~MD_MAX72XX_Framebuffer() = default;
+
+    void begin(MD_MAX72XX* display);
+
+    /**
+     * @brief Get the display this framebuffer flushes to.
+     *
+     * @return MD_MAX72XX* The display, nullptr if this framebuffer has no
+     *  display. (like MD_MAX72XX_OffscreenFramebuffer)
+     */
+    MD_MAX72XX* getDisplay() const {
+      return this->display;
+    }
+
+    /**
+     * @brief Get the number of columns in the framebuffer.
+     *
+     * @return uint16_t The number of columns.
+     */
+    uint16_t getColumnCount() const {
+      return this->columnCount;
+    }
+
+    /**
+     * @brief Get a column of the framebuffer.
+     *
+     * @param x The column, counted from the left edge.
+     * @return uint8_t The column bitmap, 0 if out of range.
+     */
+    uint8_t getColumn(int16_t x) const {
+      if (x < 0 || x >= this->columnCount) {
+        return 0;
+      }
+      return this->columns[x];
+    }
+
+    void setColumn(int16_t x, uint8_t value);
+    void clear(int16_t firstX, uint16_t count);
+
+    /**
+     * @brief Clear the whole framebuffer.
+     */
+    void clear() {
+      this->clear(0, this->columnCount);
+    }
+
+    /**
+     * @brief Check if anything has changed since the last flush.
+     *
+     * @return true if a flush would send anything to the display.
+     */
+    bool isDirty() const {
+      return this->dirtyFirstX <= this->dirtyLastX;
+    }
+
+    virtual void flush();
+
+  protected:
+    /**
+     * @brief Constructor for framebuffers that don't flush to a display.
+     *
+     * @param columnCount How many columns the framebuffer has.
+     */
+    MD_MAX72XX_Framebuffer(uint16_t columnCount) {
+      this->columnCount =
+        min(columnCount, static_cast<uint16_t>(MAX_FRAMEBUFFER_COLUMNS));
+    }
+
+    MD_MAX72XX* display = nullptr;
+    uint16_t columnCount = 0;
+    uint8_t columns[MAX_FRAMEBUFFER_COLUMNS] = {};
+
+    // Inclusive range of columns changed since the last flush, empty when
+    // first > last
+    int16_t dirtyFirstX = MAX_FRAMEBUFFER_COLUMNS;
+    int16_t dirtyLastX = -1;
+
+    void markDirty(int16_t x) {
+      if (x < this->dirtyFirstX) {
+        this->dirtyFirstX = x;
+      }
+      if (x > this->dirtyLastX) {
+        this->dirtyLastX = x;
+      }
+    }
+
+    void clearDirty() {
+      this->dirtyFirstX = MAX_FRAMEBUFFER_COLUMNS;
+      this->dirtyLastX = -1;
+    }
+};
+
+#endif // PICO2W_STOCK_TICKER_MD_MAX72XX_FRAMEBUFFER_H
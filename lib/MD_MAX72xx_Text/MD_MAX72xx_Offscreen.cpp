@@ -0,0 +1,108 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#include "MD_MAX72xx_Offscreen.h"
+
+/**
+ * @brief Record the current framebuffer as a frame.
+ *
+ * Unlike a real framebuffer, a frame is recorded even if nothing changed, so
+ * the recording has exactly one frame per flush.
+ */
+void MD_MAX72XX_OffscreenFramebuffer::flush() {
+  if (this->flushCount < this->maxFrames) {
+    memcpy(&this->frameStorage[this->flushCount * this->columnCount],
+           this->columns, this->columnCount);
+  }
+  this->flushCount++;
+  this->clearDirty();
+}
+
+/**
+ * @brief Compare the recorded frames against known good frames.
+ *
+ * @param goldenFrames The known good frames, laid out like the frame storage.
+ * @param goldenFrameCount How many known good frames there are.
+ * @return int32_t -1 if the recording matches exactly, otherwise the index of
+ *  the first frame that differs. (or is missing from either side)
+ */
+int32_t MD_MAX72XX_OffscreenFramebuffer::compareFrames(
+  const uint8_t* goldenFrames, size_t goldenFrameCount) const {
+  const size_t frameCount = this->getFrameCount();
+  const size_t commonCount = min(frameCount, goldenFrameCount);
+  for (size_t i = 0; i < commonCount; i++) {
+    if (memcmp(this->getFrame(i), &goldenFrames[i * this->columnCount],
+               this->columnCount) != 0) {
+      return static_cast<int32_t>(i);
+    }
+  }
+  if (frameCount != goldenFrameCount) {
+    return static_cast<int32_t>(commonCount);
+  }
+  return -1;
+}
+
+/**
+ * @brief Print a recorded frame as 8 lines of '#' (on) and '.' (off).
+ *
+ * @param out Where to print to, like Serial1.
+ * @param index The frame.
+ */
+void MD_MAX72XX_OffscreenFramebuffer::dumpFrameAscii(Print& out,
+                                                     size_t index) const {
+  const uint8_t* frame = this->getFrame(index);
+  if (frame == nullptr) {
+    out.printf("Frame %u not recorded\n", index);
+    return;
+  }
+  out.printf("Frame %u:\n", index);
+  for (uint8_t row = 0; row < 8; row++) {
+    for (uint16_t x = 0; x < this->columnCount; x++) {
+      out.write((frame[x] >> row) & 1 ? '#' : '.');
+    }
+    out.write('\n');
+  }
+}
+
+/**
+ * @brief Print a recorded frame as a plain (ASCII) PGM image, which most image
+ *  viewers can open after copying it out of the serial log.
+ *
+ * @param out Where to print to, like Serial1.
+ * @param index The frame.
+ */
+void MD_MAX72XX_OffscreenFramebuffer::dumpFramePgm(Print& out,
+                                                   size_t index) const {
+  const uint8_t* frame = this->getFrame(index);
+  if (frame == nullptr) {
+    return;
+  }
+  out.printf("P2\n%u 8\n1\n", this->columnCount);
+  for (uint8_t row = 0; row < 8; row++) {
+    for (uint16_t x = 0; x < this->columnCount; x++) {
+      out.write((frame[x] >> row) & 1 ? '1' : '0');
+      out.write(x + 1 < this->columnCount ? ' ' : '\n');
+    }
+  }
+}
+
+/**
+ * @brief Print every recorded frame as a C array initializer, to store as
+ *  known good frames for MD_MAX72XX_OffscreenFramebuffer::compareFrames().
+ *
+ * @param out Where to print to, like Serial1.
+ */
+void MD_MAX72XX_OffscreenFramebuffer::dumpFramesAsArray(Print& out) const {
+  const size_t frameCount = this->getFrameCount();
+  out.printf("// %u frames of %u columns\n{\n", frameCount, this->columnCount);
+  for (size_t i = 0; i < frameCount; i++) {
+    const uint8_t* frame = this->getFrame(i);
+    out.print("  ");
+    for (uint16_t x = 0; x < this->columnCount; x++) {
+      out.printf("0x%02X,", frame[x]);
+    }
+    out.write('\n');
+  }
+  out.println("}");
+}
@@ -0,0 +1,89 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_MD_MAX72XX_OFFSCREEN_H
+#define PICO2W_STOCK_TICKER_MD_MAX72XX_OFFSCREEN_H
+
+#include <Arduino.h>
+#include <MD_MAX72xx_Framebuffer.h>
+
+// A framebuffer that never touches a display. Instead every flush is recorded
+// as a frame, so what the renderers draw can be compared against known good
+// ("golden") frames or dumped for debugging without the physical matrix.
+class MD_MAX72XX_OffscreenFramebuffer : public MD_MAX72XX_Framebuffer {
+  public:
+    /**
+     * @brief Constructor for MD_MAX72XX_OffscreenFramebuffer.
+     *
+     * @param columnCount How many columns the pretend display has.
+     * @param frameStorage Where to record frames, must be at least
+     *  columnCount * maxFrames bytes. Each frame is columnCount column
+     *  bitmaps from left to right.
+     * @param maxFrames How many frames fit in frameStorage. Flushes past this
+     *  are counted but not recorded.
+     */
+    MD_MAX72XX_OffscreenFramebuffer(uint16_t columnCount, uint8_t* frameStorage,
+                                    size_t maxFrames)
+        : MD_MAX72XX_Framebuffer(columnCount) {
+      this->frameStorage = frameStorage;
+      this->maxFrames = maxFrames;
+    }
+    ~MD_MAX72XX_OffscreenFramebuffer() override = default;
+
+    void flush() override;
+
+    /**
+     * @brief Forget all recorded frames.
+     */
+    void resetRecording() {
+      this->flushCount = 0;
+    }
+
+    /**
+     * @brief Get how many times the framebuffer was flushed, including
+     *  flushes that didn't fit in the frame storage.
+     *
+     * @return size_t The number of flushes.
+     */
+    size_t getFlushCount() const {
+      return this->flushCount;
+    }
+
+    /**
+     * @brief Get how many frames were recorded.
+     *
+     * @return size_t The number of recorded frames.
+     */
+    size_t getFrameCount() const {
+      return min(this->flushCount, this->maxFrames);
+    }
+
+    /**
+     * @brief Get a recorded frame.
+     *
+     * @param index The frame, 0 is the first flush.
+     * @return const uint8_t* The columnCount column bitmaps of the frame, or
+     *  nullptr if that frame wasn't recorded.
+     */
+    const uint8_t* getFrame(size_t index) const {
+      if (index >= this->getFrameCount()) {
+        return nullptr;
+      }
+      return &this->frameStorage[index * this->columnCount];
+    }
+
+    int32_t compareFrames(const uint8_t* goldenFrames,
+                          size_t goldenFrameCount) const;
+
+    void dumpFrameAscii(Print& out, size_t index) const;
+    void dumpFramePgm(Print& out, size_t index) const;
+    void dumpFramesAsArray(Print& out) const;
+
+  protected:
+    uint8_t* frameStorage = nullptr;
+    size_t maxFrames = 0;
+    size_t flushCount = 0;
+};
+
+#endif // PICO2W_STOCK_TICKER_MD_MAX72XX_OFFSCREEN_H
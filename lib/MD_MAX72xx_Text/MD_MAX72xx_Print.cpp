@@ -5,15 +5,123 @@
 #include "MD_MAX72xx_Print.h"
 
 size_t MD_MAX72XX_Print::write(uint8_t c) {
-  if (this->display == nullptr) {
-    return 0;
+  if (this->buffered) {
+    return this->bufferChar(c);
   }
   if (c == '\r') { // Return to start of line, but do not clear
     this->carriageReturn();
   } else if (c == '\n') { // Return to start of line and clear
     this->newline();      // Automatic carriage return;
-  } else {
-    this->curCol -= this->display->setChar(curCol, c) + 1;
+  } else if (this->curX < this->zone.getWidth()) {
+    // Characters past the right edge of the zone are dropped
+    this->curX += this->zone.drawChar(this->curX, static_cast<char>(c)) +
+                  this->zone.getCharSpacing(static_cast<char>(c));
+    this->changed = true;
   }
   return 1;
 }
+
+/**
+ * @brief Lay out anything printed since the last flush and update the display
+ *  once.
+ */
+void MD_MAX72XX_Print::flush() {
+  this->render();
+  this->zone.getFramebuffer()->flush();
+}
+
+/**
+ * @brief Call this function as often as possible to keep a line that is too
+ *  wide for the zone scrolling. Flushes the framebuffer if anything changed,
+ *  use MD_MAX72XX_Print::render() instead when sharing the framebuffer with
+ *  other renderers.
+ */
+void MD_MAX72XX_Print::update() {
+  if (this->render()) {
+    this->zone.getFramebuffer()->flush();
+  }
+}
+
+/**
+ * @brief Draw anything printed since the last call into the zone. In
+ *  buffered mode this lays out the line, or shifts it if it is scrolling.
+ *
+ * @return true if the zone changed since the last call.
+ */
+bool MD_MAX72XX_Print::render() {
+  if (!this->buffered) {
+    // Text is drawn as soon as it is printed, so only report if anything was
+    // printed
+    const bool wasChanged = this->changed;
+    this->changed = false;
+    return wasChanged;
+  }
+  if (this->linePending) {
+    return this->layoutLine();
+  }
+  if (this->overflowing) {
+    return this->overflowScroller.render();
+  }
+  return false;
+}
+
+/**
+ * @brief Add a character to the line buffer.
+ *
+ * @param c The character.
+ * @return size_t Always 1, characters past the end of the buffer are dropped
+ *  silently like characters past the edge of the zone are when not buffered.
+ */
+size_t MD_MAX72XX_Print::bufferChar(uint8_t c) {
+  if (this->lineFlushed) { // First write after a flush starts a new line
+    this->lineFlushed = false;
+    this->lineLen = 0;
+  }
+  if (c == '\r' || c == '\n') {
+    this->lineLen = 0;
+  } else if (this->lineLen < MAX_PRINT_LINE_LEN - 1) {
+    this->lineBuffer[this->lineLen] = static_cast<char>(c);
+    this->lineLen++;
+  }
+  this->lineBuffer[this->lineLen] = '\0';
+  this->linePending = true;
+  return 1;
+}
+
+/**
+ * @brief Measure the line buffer and either draw it into the zone in one go,
+ *  or hand it to the scroller if it doesn't fit.
+ *
+ * @return true if the zone changed.
+ */
+bool MD_MAX72XX_Print::layoutLine() {
+  this->linePending = false;
+  this->lineFlushed = true;
+
+  uint16_t lineWidth = 0;
+  for (size_t i = 0; i < this->lineLen; i++) {
+    lineWidth += this->zone.getCharWidth(this->lineBuffer[i]) +
+                 this->zone.getCharSpacing(this->lineBuffer[i]);
+  }
+  if (this->lineLen > 0) {
+    // No space needed after the last character
+    lineWidth -= this->zone.getCharSpacing(this->lineBuffer[this->lineLen - 1]);
+  }
+
+  if (lineWidth > this->zone.getWidth()) {
+    // Start on the left so the beginning of the line is readable right away
+    this->overflowing = true;
+    this->overflowScroller.setText(this->lineBuffer, true);
+    this->overflowScroller.render();
+    return true;
+  }
+
+  this->overflowing = false;
+  this->zone.clear();
+  int16_t x = 0;
+  for (size_t i = 0; i < this->lineLen; i++) {
+    x += this->zone.drawChar(x, this->lineBuffer[i]) +
+         this->zone.getCharSpacing(this->lineBuffer[i]);
+  }
+  return true;
+}
@@ -7,10 +7,15 @@
 
 #include <Arduino.h>
 #include <MD_MAX72xx.h>
+#include <MD_MAX72xx_Framebuffer.h>
+#include <MD_MAX72xx_Renderer.h>
+#include <MD_MAX72xx_Scrolling.h>
+
+const size_t MAX_PRINT_LINE_LEN = 128;
 
 // This class extends the Print class to allow printing text to an MD_MAX72XX
 // display.
-class MD_MAX72XX_Print : public Print {
+class MD_MAX72XX_Print : public Print, public MD_MAX72XX_Renderer {
   public:
     /**
      * @brief Constructor for MD_MAX72XX_Print, allowing "print"ing and other
@@ -18,30 +23,106 @@ class MD_MAX72XX_Print : public Print {
      *
      * This enables using Arduino print functions like print, println, printf on
      * supported builds to make printing text easy. \r sets the current column
-     * to the left most column. \n will clear the display. (and also do a
-     * carriage return as well)
+     * to the left most column. \n will clear the zone. (and also do a
+     * carriage return as well) Text is drawn into the framebuffer, call
+     * MD_MAX72XX_Print::flush() or MD_MAX72XX_Framebuffer::flush() to show it.
      *
-     * @param display A pointer to the MD_MAX72XX display object to print to.
+     * @param framebuffer A pointer to the framebuffer to print to.
      */
-    MD_MAX72XX_Print(MD_MAX72XX* display) {
-      this->display = display;
+    MD_MAX72XX_Print(MD_MAX72XX_Framebuffer* framebuffer)
+        : MD_MAX72XX_Renderer(framebuffer), overflowScroller(framebuffer) {
       this->carriageReturn();
     }
-    ~MD_MAX72XX_Print() = default;
+    ~MD_MAX72XX_Print() override = default;
 
     size_t write(uint8_t c) override;
+    void flush() override;
+    void update();
+
+    /**
+     * @brief Turn buffered mode on or off.
+     *
+     * In buffered mode, printed text is collected into a line buffer (up to
+     * MAX_PRINT_LINE_LEN - 1 characters) and only drawn on flush(), all at
+     * once. \r and \n both start a new line. If the line is wider than the
+     * zone, it is scrolled instead, call update() to keep it scrolling.
+     *
+     * @param buffered True to collect text until flush(), false to draw each
+     *  character as soon as it's printed.
+     */
+    void setBuffered(bool buffered) {
+      this->buffered = buffered;
+      this->lineLen = 0;
+      this->lineBuffer[0] = '\0';
+      this->linePending = false;
+      this->overflowing = false;
+    }
+
+    bool isBuffered() const {
+      return this->buffered;
+    }
+
+    /**
+     * @brief Check if the last flushed line didn't fit in the zone and is
+     *  being scrolled instead.
+     *
+     * @return true if the line is being scrolled.
+     */
+    bool isOverflowing() const {
+      return this->overflowing;
+    }
+
+    /**
+     * @brief Set the time in milliseconds between each shift of a line that
+     *  is too wide for the zone.
+     *
+     * @param period The time in milliseconds, lower scrolls faster.
+     */
+    void setPeriodBetweenShifts(uint32_t period) {
+      this->overflowScroller.periodBetweenShifts = period;
+    }
+
+    /**
+     * @brief Restrict printing to a window of columns. Clears the new zone.
+     *
+     * @param firstX The first column of the zone, counted from the left edge.
+     * @param width How many columns wide the zone is. 0 means everything from
+     *  firstX to the right edge of the framebuffer.
+     */
+    void setZone(uint16_t firstX, uint16_t width = 0) override {
+      MD_MAX72XX_Renderer::setZone(firstX, width);
+      this->overflowScroller.setZone(firstX, width);
+      this->newline();
+    }
+
+    bool render() override;
 
   protected:
-    MD_MAX72XX* display = nullptr;
-    uint16_t curCol = 0;
+    int16_t curX = 0;
+    bool changed = false;
+
+    bool buffered = false;
+    char lineBuffer[MAX_PRINT_LINE_LEN] = "";
+    size_t lineLen = 0;
+    // If the line has been printed to but not laid out yet
+    bool linePending = false;
+    // If the line has been laid out, so the next write starts a new line
+    bool lineFlushed = false;
+    // If the laid out line was too wide and is being scrolled
+    bool overflowing = false;
+    MD_MAX72XX_Scrolling overflowScroller;
+
+    size_t bufferChar(uint8_t c);
+    bool layoutLine();
 
     void carriageReturn() {
-      this->curCol = this->display->getColumnCount() - 1;
+      this->curX = 0;
     }
 
     void newline() {
       this->carriageReturn();
-      this->display->clear();
+      this->zone.clear();
+      this->changed = true;
     }
 };
 
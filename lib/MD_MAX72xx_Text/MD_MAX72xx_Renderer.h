@@ -0,0 +1,54 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_MD_MAX72XX_RENDERER_H
+#define PICO2W_STOCK_TICKER_MD_MAX72XX_RENDERER_H
+
+#include <Arduino.h>
+#include <MD_MAX72xx_Framebuffer.h>
+#include <MD_MAX72xx_Zone.h>
+
+// Base class for anything that draws into a zone of a shared framebuffer.
+class MD_MAX72XX_Renderer {
+  public:
+    /**
+     * @brief Constructor for MD_MAX72XX_Renderer. The renderer starts out
+     *  owning the whole framebuffer.
+     *
+     * @param framebuffer A pointer to the framebuffer to draw into.
+     */
+    MD_MAX72XX_Renderer(MD_MAX72XX_Framebuffer* framebuffer)
+        : zone(framebuffer) {
+    }
+    virtual ~MD_MAX72XX_Renderer() = default;
+
+    /**
+     * @brief Restrict the renderer to a window of columns.
+     *
+     * @param firstX The first column of the zone, counted from the left edge.
+     * @param width How many columns wide the zone is. 0 means everything from
+     *  firstX to the right edge of the framebuffer.
+     */
+    virtual void setZone(uint16_t firstX, uint16_t width = 0) {
+      this->zone.setBounds(firstX, width);
+    }
+
+    const MD_MAX72XX_Zone& getZone() const {
+      return this->zone;
+    }
+
+    /**
+     * @brief Draw the next frame into the zone if there is one, without
+     *  flushing the framebuffer.
+     *
+     * @return true if the zone changed, false if it didn't (in which case
+     *  nothing was drawn).
+     */
+    virtual bool render() = 0;
+
+  protected:
+    MD_MAX72XX_Zone zone;
+};
+
+#endif // PICO2W_STOCK_TICKER_MD_MAX72XX_RENDERER_H
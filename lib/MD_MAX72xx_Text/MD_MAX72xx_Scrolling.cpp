@@ -9,38 +9,85 @@
  *
  * This update function checks to make sure the text is scrolled at the set
  * speed `MD_MAX72XX_Scrolling::periodBetweenShifts`. It will also handle text
- * that is constantly changing.
+ * that is constantly changing. Flushes the framebuffer on every shift, use
+ * MD_MAX72XX_Scrolling::render() instead when sharing the framebuffer with
+ * other renderers.
  */
 void MD_MAX72XX_Scrolling::update() {
-  if (this->display == nullptr || this->strToDisplay == nullptr ||
-      strlen(this->strToDisplay) == 0) {
-    return; // Nothing to display
+  if (!this->isTimeToShift()) {
+    return;
+  }
+  // Update now, which will be more precise than waiting till after we do all
+  // the computation
+  this->zone.getFramebuffer()->flush();
+  this->drawNextFrame();
+}
+
+/**
+ * @brief Draw the next frame into the zone if it is time to shift, without
+ *  flushing the framebuffer.
+ *
+ * @return true if a frame was drawn.
+ */
+bool MD_MAX72XX_Scrolling::render() {
+  if (!this->isTimeToShift()) {
+    return false;
+  }
+  this->drawNextFrame();
+  return true;
+}
+
+/**
+ * @brief Check if there is text to scroll and it is time to shift it, and if
+ *  so schedule the next shift.
+ *
+ * @return true if it is time to shift.
+ */
+bool MD_MAX72XX_Scrolling::isTimeToShift() {
+  const bool nothingToDisplay =
+    this->source != nullptr
+      ? this->windowLen == 0 && this->source->getSegmentCount() == 0
+      : this->strToDisplay == nullptr || this->strToDisplay[0] == '\0';
+  if (nothingToDisplay) {
+    // Look again in a period, rather than leaving the next shift in the past
+    // for getNextShiftTime()
+    this->nextShiftTime = millis() + this->periodBetweenShifts;
+    return false;
   }
 
   if (static_cast<int32_t>(millis() - this->nextShiftTime) < 0) {
-    return; // Not time to shift yet
+    return false; // Not time to shift yet
   }
   this->nextShiftTime = millis() + this->periodBetweenShifts;
-  this->display->update(); // Update now, which will be more precise than
-  // waiting till after we do all the computation
+  return true;
+}
 
-  const size_t strToDisplayLen = strlen(this->strToDisplay);
-  const uint16_t colCount = this->display->getColumnCount();
-  this->display->clear();
-  int16_t thisCurCol = this->curCharColOffset;
-  if (this->pretendPositiveOffset) {
-    // If we are pretending the offset is positive, then we start at the left
-    // side of the display and scroll right
-    thisCurCol = 1;
+/**
+ * @brief Draw the text at the current position into the zone and shift it
+ *  left by one column.
+ */
+void MD_MAX72XX_Scrolling::drawNextFrame() {
+  const char* text = this->strToDisplay;
+  size_t textLen;
+  if (this->source != nullptr) {
+    this->fillWindow();
+    text = this->window;
+    textLen = this->windowLen;
+    if (static_cast<size_t>(this->curCharIndex) >= textLen) {
+      // The source ran out of segments
+      this->reset();
+      return;
+    }
+  } else {
+    textLen = strlen(this->strToDisplay);
   }
-  for (size_t i = this->curCharIndex; // Start from the current character index
-       i < strToDisplayLen && // Keep going as long as we have characters to
-       thisCurCol < colCount; // display or columns left to fill
-       i++) {
-    thisCurCol +=
-      this->display->setChar(colCount - thisCurCol, this->strToDisplay[i]) +
-      this->spaceBetweenChars;
+  const uint16_t colCount = this->zone.getWidth();
+  if (colCount != this->drawTextWidth) {
+    // The framebuffer was resized by MD_MAX72XX_Framebuffer::begin() after
+    // the zone was set
+    this->pickDrawText(colCount);
   }
+  (this->*drawText)(text, textLen);
   // This column offset is from the left instead of from the right
   // So to move text left, we subtract
   this->curCharColOffset -= 1;
@@ -49,18 +96,140 @@ void MD_MAX72XX_Scrolling::update() {
   if (this->pretendPositiveOffset && this->curCharColOffset <= 0) {
     this->pretendPositiveOffset = false;
   }
-  const char curChar = this->strToDisplay[this->curCharIndex];
+  const char curChar = text[this->curCharIndex];
   // If the current character is scrolled completely past the left edge of the
   // display, then focus on the next character and set it's offset to 0
   if (this->curCharColOffset <= -this->getTextWidth(curChar)) {
     this->curCharColOffset = 0;
     this->curCharIndex++;
   }
-  if (this->curCharIndex >= strToDisplayLen) {
+  // A segment source goes on with its next segment instead
+  if (this->source == nullptr &&
+      static_cast<size_t>(this->curCharIndex) >= textLen) {
     this->reset();
   }
 }
 
+/**
+ * @brief Pick the text drawing specialized for the zone's width.
+ *
+ * Zones of 1, 2, 4 or 8 groups of four modules, or of that many groups less
+ * one module (the rest of the chain beside a one module status zone), get a
+ * version with the width known at compile time, other widths use the generic
+ * one.
+ *
+ * @param width How many columns wide the zone is.
+ */
+void MD_MAX72XX_Scrolling::pickDrawText(uint16_t width) {
+  this->drawTextWidth = width;
+  switch (width) {
+    case 1 * 4 * 8:
+      this->drawText = &MD_MAX72XX_Scrolling::drawTextColumns<1 * 4 * 8>;
+      break;
+    case 1 * 4 * 8 - 8:
+      this->drawText = &MD_MAX72XX_Scrolling::drawTextColumns<1 * 4 * 8 - 8>;
+      break;
+    case 2 * 4 * 8:
+      this->drawText = &MD_MAX72XX_Scrolling::drawTextColumns<2 * 4 * 8>;
+      break;
+    case 2 * 4 * 8 - 8:
+      this->drawText = &MD_MAX72XX_Scrolling::drawTextColumns<2 * 4 * 8 - 8>;
+      break;
+    case 4 * 4 * 8:
+      this->drawText = &MD_MAX72XX_Scrolling::drawTextColumns<4 * 4 * 8>;
+      break;
+    case 4 * 4 * 8 - 8:
+      this->drawText = &MD_MAX72XX_Scrolling::drawTextColumns<4 * 4 * 8 - 8>;
+      break;
+    case 8 * 4 * 8:
+      this->drawText = &MD_MAX72XX_Scrolling::drawTextColumns<8 * 4 * 8>;
+      break;
+    case 8 * 4 * 8 - 8:
+      this->drawText = &MD_MAX72XX_Scrolling::drawTextColumns<8 * 4 * 8 - 8>;
+      break;
+    default:
+      this->drawText = &MD_MAX72XX_Scrolling::drawTextColumns<0>;
+      break;
+  }
+}
+
+/**
+ * @brief Clear the zone and draw the text from the current character on.
+ *
+ * When COLUMNS is nonzero it is the zone's width as a compile time constant,
+ * so the end of the loop and the clipping of every character fold into
+ * constants. COLUMNS of 0 is the generic version that uses the zone's width.
+ *
+ * @param text The text to draw.
+ * @param textLen The length of the text.
+ */
+template <uint16_t COLUMNS>
+void MD_MAX72XX_Scrolling::drawTextColumns(const char* text, size_t textLen) {
+  const int16_t colCount =
+    COLUMNS != 0 ? COLUMNS : static_cast<int16_t>(this->zone.getWidth());
+  this->zone.getFramebuffer()->clear(this->zone.getFirstX(), colCount);
+  int16_t thisCurCol = this->curCharColOffset;
+  if (this->pretendPositiveOffset) {
+    // If we are pretending the offset is positive, then we start at the left
+    // side of the display and scroll right
+    thisCurCol = 1;
+  }
+  for (size_t i = this->curCharIndex; // Start from the current character index
+       i < textLen && // Keep going as long as we have characters to
+       thisCurCol < colCount; // display or columns left to fill
+       i++) {
+    // Offsets are 1-based from the left edge, zone columns are 0-based
+    thisCurCol += this->zone.drawChar(thisCurCol - 1, text[i], colCount) +
+                  this->zone.getCharSpacing(text[i]);
+  }
+}
+
+/**
+ * @brief Add segments from the source to the window until its text reaches
+ *  the right edge of the zone, dropping the characters that already scrolled
+ *  off the left edge when it needs the room.
+ */
+void MD_MAX72XX_Scrolling::fillWindow() {
+  const int16_t colCount = this->zone.getWidth();
+  int16_t endCol = this->pretendPositiveOffset ? 1 : this->curCharColOffset;
+  for (size_t i = this->curCharIndex; i < this->windowLen && endCol < colCount;
+       i++) {
+    endCol += this->getTextWidth(this->window[i]);
+  }
+  const uint16_t segmentCount = this->source->getSegmentCount();
+  // Each segment at most once, in case they are all empty
+  for (uint16_t added = 0;
+       added < segmentCount &&
+       (endCol < colCount ||
+        static_cast<size_t>(this->curCharIndex) >= this->windowLen);
+       added++) {
+    if (this->windowLen + MD_MAX72XX_MAX_SEGMENT_LEN >
+        MD_MAX72XX_SEGMENT_WINDOW_LEN) {
+      this->windowLen -= this->curCharIndex;
+      memmove(this->window, this->window + this->curCharIndex,
+              this->windowLen);
+      this->curCharIndex = 0;
+      if (this->windowLen + MD_MAX72XX_MAX_SEGMENT_LEN >
+          MD_MAX72XX_SEGMENT_WINDOW_LEN) {
+        // Can't happen with zones up to MAX_FRAMEBUFFER_COLUMNS wide, see
+        // MD_MAX72XX_SEGMENT_WINDOW_LEN
+        return;
+      }
+    }
+    // The segment count can shrink between calls
+    const uint16_t segment = this->nextSegment % segmentCount;
+    this->nextSegment = segment + 1;
+    const size_t start = this->windowLen;
+    this->windowLen += min(this->source->writeSegment(
+                             segment, this->window + this->windowLen,
+                             MD_MAX72XX_MAX_SEGMENT_LEN),
+                           MD_MAX72XX_MAX_SEGMENT_LEN - 1);
+    for (size_t i = start; i < this->windowLen && endCol < colCount; i++) {
+      endCol += this->getTextWidth(this->window[i]);
+    }
+  }
+}
+
 /**
  * @brief Get the width of the text in columns.
  *
@@ -69,11 +238,9 @@ void MD_MAX72XX_Scrolling::update() {
  */
 uint16_t MD_MAX72XX_Scrolling::getTextWidth(const char* text) {
   uint16_t width = 0;
-  const size_t tempBufSize = 16; // Useless buffer, just to get column width
-  uint8_t tempBuf[tempBufSize];
-  for (size_t i = 0; i < strlen(text); i++) {
-    width += this->display->getChar(text[i], tempBufSize, tempBuf) +
-      this->spaceBetweenChars;
+  for (size_t i = 0; text[i] != '\0'; i++) {
+    width += this->zone.getCharWidth(text[i]) +
+             this->zone.getCharSpacing(text[i]);
   }
   return width;
 }
@@ -85,8 +252,5 @@ uint16_t MD_MAX72XX_Scrolling::getTextWidth(const char* text) {
  * @return The number of columns it would take up.
  */
 uint16_t MD_MAX72XX_Scrolling::getTextWidth(char c) {
-  const size_t tempBufSize = 16; // Useless buffer, just to get column width
-  uint8_t tempBuf[tempBufSize];
-  return this->display->getChar(c, tempBufSize, tempBuf) +
-         this->spaceBetweenChars;
+  return this->zone.getCharWidth(c) + this->zone.getCharSpacing(c);
 }
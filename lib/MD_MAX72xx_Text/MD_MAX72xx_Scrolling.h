@@ -7,9 +7,20 @@
 
 #include <Arduino.h>
 #include <MD_MAX72xx.h>
+#include <MD_MAX72xx_Framebuffer.h>
+#include <MD_MAX72xx_Renderer.h>
+#include <MD_MAX72xx_SegmentSource.h>
 
-// Manages continually scrolling a string of text across the display.
-class MD_MAX72XX_Scrolling {
+// Characters kept from a segment source. Every character is at least a column
+// wide (sparkline bars are exactly one), so the widest zone shows at most a
+// character per column plus the one scrolling off the left edge. On top of
+// that goes the rest of the segment past the right edge and the next segment.
+const size_t MD_MAX72XX_SEGMENT_WINDOW_LEN =
+  MAX_FRAMEBUFFER_COLUMNS + 2 * MD_MAX72XX_MAX_SEGMENT_LEN;
+
+// Manages continually scrolling a string of text, or text from a segment
+// source, across the display.
+class MD_MAX72XX_Scrolling : public MD_MAX72XX_Renderer {
   public:
     /**
      * @brief Constructor for MD_MAX72XX_Print, allowing scrolling text from the
@@ -17,12 +28,12 @@ class MD_MAX72XX_Scrolling {
      *
      * This enables easy scrolling at a configurable speed.
      *
-     * @param display A pointer to the MD_MAX72XX display object to print to.
+     * @param framebuffer A pointer to the framebuffer to scroll across.
      */
-    MD_MAX72XX_Scrolling(MD_MAX72XX* display) {
-      this->display = display;
+    MD_MAX72XX_Scrolling(MD_MAX72XX_Framebuffer* framebuffer)
+        : MD_MAX72XX_Renderer(framebuffer) {
     }
-    ~MD_MAX72XX_Scrolling() = default;
+    ~MD_MAX72XX_Scrolling() override = default;
 
     /**
      * @brief Set the text to display on the scrolling display. Does not copy,
@@ -36,19 +47,66 @@ class MD_MAX72XX_Scrolling {
      */
     void setText(const char* text, bool startOnLeftInsteadOfRightSide = false) {
       this->strToDisplay = text;
+      this->source = nullptr;
+      this->reset(startOnLeftInsteadOfRightSide);
+    }
+
+    /**
+     * @brief Scroll text from a segment source instead of a string, one
+     *  segment after another, looping back to the first after the last.
+     *
+     * Segments are written just before they scroll in, so changes to them
+     * show up from the next segment on, and only the segments on the display
+     * are kept in memory.
+     *
+     * @param segmentSource The source, must outlive scrolling it.
+     * @param startOnLeftInsteadOfRightSide If true, the text will start on the
+     *  left side and wait for a bit before scrolling instead of starting on the
+     *  right side off the screen.
+     */
+    void setSource(MD_MAX72XX_SegmentSource* segmentSource,
+                   bool startOnLeftInsteadOfRightSide = false) {
+      this->strToDisplay = nullptr;
+      this->source = segmentSource;
       this->reset(startOnLeftInsteadOfRightSide);
     }
 
     /**
      * @brief Get the text currently being displayed.
      *
-     * @return const char* The pointer to the text currently being displayed.
+     * @return const char* The pointer to the text currently being displayed,
+     *  nullptr if scrolling a segment source.
      */
     const char* getText() const {
       return this->strToDisplay;
     }
 
     void update();
+    bool render() override;
+
+    /**
+     * @brief Get when the text is next shifted, to know how long there is
+     *  nothing to do.
+     *
+     * @return uint32_t The millis() time of the next shift.
+     */
+    uint32_t getNextShiftTime() const {
+      return this->nextShiftTime;
+    }
+
+    /**
+     * @brief Restrict scrolling to a window of columns. Restarts the text from
+     *  the right side of the new zone.
+     *
+     * @param firstX The first column of the zone, counted from the left edge.
+     * @param width How many columns wide the zone is. 0 means everything from
+     *  firstX to the right edge of the framebuffer.
+     */
+    void setZone(uint16_t firstX, uint16_t width = 0) override {
+      MD_MAX72XX_Renderer::setZone(firstX, width);
+      this->pickDrawText(this->zone.getWidth());
+      this->reset();
+    }
 
     /**
      * @brief Reset the scrolling display to the initial state. (text to the
@@ -60,10 +118,13 @@ class MD_MAX72XX_Scrolling {
      */
     void reset(bool startOnLeftInsteadOfRightSide = false) {
       this->curCharIndex = 0;
-      this->curCharColOffset = this->display->getColumnCount();
-      this->nextShiftTime = 0; // Reset next shift time to 0 so it will shift
-                               // immediately on next update
+      this->curCharColOffset = this->zone.getWidth();
+      // Shift immediately on next update, 0 would be in the future once
+      // millis() passes 2^31
+      this->nextShiftTime = millis();
       this->pretendPositiveOffset = startOnLeftInsteadOfRightSide;
+      this->windowLen = 0;
+      this->nextSegment = 0;
     }
 
     /**
@@ -75,8 +136,13 @@ class MD_MAX72XX_Scrolling {
     uint32_t periodBetweenShifts = 30;
 
   protected:
-    MD_MAX72XX* display = nullptr;
     const char* strToDisplay = nullptr;
+    MD_MAX72XX_SegmentSource* source = nullptr;
+    // Segments from the source that are on the display or about to be, the
+    // current character is always in here
+    char window[MD_MAX72XX_SEGMENT_WINDOW_LEN];
+    size_t windowLen = 0;
+    uint16_t nextSegment = 0;
     int16_t curCharIndex = 0;
     // Instead of 0 being the right, we'll define 0 as offset from the left edge
     // of the display
@@ -85,10 +151,20 @@ class MD_MAX72XX_Scrolling {
     // before scrolling instead of starting on the right side off the screen.
     bool pretendPositiveOffset = false;
 
-    const uint16_t spaceBetweenChars = 1;
-
     uint32_t nextShiftTime = 0;
 
+    // Picked by pickDrawText() for the zone's width, drawTextWidth is the
+    // width it was picked for
+    void (MD_MAX72XX_Scrolling::*drawText)(const char*, size_t) = nullptr;
+    uint16_t drawTextWidth = UINT16_MAX;
+
+    bool isTimeToShift();
+    void drawNextFrame();
+    void pickDrawText(uint16_t width);
+    template <uint16_t COLUMNS>
+    void drawTextColumns(const char* text, size_t textLen);
+    void fillWindow();
+
     uint16_t getTextWidth(const char* text);
     uint16_t getTextWidth(char c);
 };
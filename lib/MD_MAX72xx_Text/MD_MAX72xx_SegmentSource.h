@@ -0,0 +1,41 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_MD_MAX72XX_SEGMENTSOURCE_H
+#define PICO2W_STOCK_TICKER_MD_MAX72XX_SEGMENTSOURCE_H
+
+#include <Arduino.h>
+
+// Longest segment a segment source is asked for, including the null
+// terminator
+const size_t MD_MAX72XX_MAX_SEGMENT_LEN = 128;
+
+// Produces text to scroll one segment at a time, like one stock's price, so
+// the whole text never has to exist at once. Segments are asked for just
+// before they scroll in and loop back to the first after the last.
+class MD_MAX72XX_SegmentSource {
+  public:
+    virtual ~MD_MAX72XX_SegmentSource() = default;
+
+    /**
+     * @brief Get how many segments there are right now.
+     *
+     * @return uint16_t The number of segments, 0 if there is nothing to
+     *  scroll.
+     */
+    virtual uint16_t getSegmentCount() = 0;
+
+    /**
+     * @brief Write a segment's text, as it should look now.
+     *
+     * @param index 0 to getSegmentCount() - 1.
+     * @param str Where to write it.
+     * @param maxLen The size of str, including the null terminator.
+     * @return size_t The number of characters written, not including the null
+     *  terminator.
+     */
+    virtual size_t writeSegment(uint16_t index, char* str, size_t maxLen) = 0;
+};
+
+#endif // PICO2W_STOCK_TICKER_MD_MAX72XX_SEGMENTSOURCE_H
@@ -7,7 +7,14 @@
 
 #include <Arduino.h>
 #include <MD_MAX72xx.h>
+#include <MD_MAX72xx_Compositor.h>
+#include <MD_MAX72xx_Font.h>
+#include <MD_MAX72xx_Framebuffer.h>
+#include <MD_MAX72xx_Offscreen.h>
 #include <MD_MAX72xx_Print.h>
+#include <MD_MAX72xx_Renderer.h>
 #include <MD_MAX72xx_Scrolling.h>
+#include <MD_MAX72xx_SegmentSource.h>
+#include <MD_MAX72xx_Zone.h>
 
 #endif // PICO2W_STOCK_TICKER_MD_MAX72XX_TEXT_H
@@ -0,0 +1,18 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#include "MD_MAX72xx_Zone.h"
+
+/**
+ * @brief Draw a character into the zone, clipping any columns outside it.
+ *
+ * @param x The column of the left side of the character, counted from the
+ *  left edge of the zone. Can be negative or past the right edge.
+ * @param c The character to draw.
+ * @return uint8_t The width of the character in columns, whether or not it
+ *  was clipped.
+ */
+uint8_t MD_MAX72XX_Zone::drawChar(int16_t x, char c) {
+  return this->drawChar(x, c, static_cast<int16_t>(this->getWidth()));
+}
@@ -0,0 +1,148 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_MD_MAX72XX_ZONE_H
+#define PICO2W_STOCK_TICKER_MD_MAX72XX_ZONE_H
+
+#include <Arduino.h>
+#include <MD_MAX72xx.h>
+#include <MD_MAX72xx_Font.h>
+#include <MD_MAX72xx_Framebuffer.h>
+
+// A window of columns on a framebuffer. Everything drawn through a zone is
+// clipped to it, so renderers sharing a framebuffer can't draw over each
+// other.
+class MD_MAX72XX_Zone {
+  public:
+    /**
+     * @brief Constructor for MD_MAX72XX_Zone.
+     *
+     * @param framebuffer A pointer to the framebuffer to draw into.
+     * @param firstX The first column of the zone, counted from the left edge.
+     * @param width How many columns wide the zone is. 0 means everything from
+     *  firstX to the right edge of the framebuffer.
+     */
+    MD_MAX72XX_Zone(MD_MAX72XX_Framebuffer* framebuffer, uint16_t firstX = 0,
+                    uint16_t width = 0) {
+      this->framebuffer = framebuffer;
+      this->setBounds(firstX, width);
+    }
+    ~MD_MAX72XX_Zone() = default;
+
+    /**
+     * @brief Move or resize the zone.
+     *
+     * @param firstX The first column of the zone, counted from the left edge.
+     * @param width How many columns wide the zone is. 0 means everything from
+     *  firstX to the right edge of the framebuffer.
+     */
+    void setBounds(uint16_t firstX, uint16_t width = 0) {
+      this->firstX = firstX;
+      this->requestedWidth = width;
+    }
+
+    MD_MAX72XX_Framebuffer* getFramebuffer() const {
+      return this->framebuffer;
+    }
+
+    uint16_t getFirstX() const {
+      return this->firstX;
+    }
+
+    /**
+     * @brief Get the width of the zone, clipped to the framebuffer. Worked out
+     *  on every call because the framebuffer can be resized by
+     *  MD_MAX72XX_Framebuffer::begin() after the zone is set.
+     *
+     * @return uint16_t How many columns wide the zone is.
+     */
+    uint16_t getWidth() const {
+      const uint16_t fbWidth = this->framebuffer->getColumnCount();
+      if (this->firstX >= fbWidth) {
+        return 0;
+      }
+      const uint16_t maxWidth = fbWidth - this->firstX;
+      return this->requestedWidth == 0 ? maxWidth
+                                       : min(this->requestedWidth, maxWidth);
+    }
+
+    /**
+     * @brief Set a column of the zone. Out of range columns are ignored.
+     *
+     * @param x The column, counted from the left edge of the zone.
+     * @param value The column bitmap.
+     */
+    void setColumn(int16_t x, uint8_t value) {
+      if (x < 0 || x >= this->getWidth()) {
+        return;
+      }
+      this->framebuffer->setColumn(this->firstX + x, value);
+    }
+
+    /**
+     * @brief Clear the whole zone.
+     */
+    void clear() {
+      this->framebuffer->clear(this->firstX, this->getWidth());
+    }
+
+    uint8_t drawChar(int16_t x, char c);
+
+    /**
+     * @brief Draw a character into the zone, clipping any columns outside it,
+     *  for callers that already know the zone's width. Inline so a width known
+     *  at compile time folds into the clipping.
+     *
+     * @param x The column of the left side of the character, counted from the
+     *  left edge of the zone. Can be negative or past the right edge.
+     * @param c The character to draw.
+     * @param width The width of the zone, from getWidth().
+     * @return uint8_t The width of the character in columns, whether or not
+     *  it was clipped.
+     */
+    uint8_t drawChar(int16_t x, char c, int16_t width) {
+      const uint8_t glyphWidth = MD_MAX72XX_Font::charWidth(c);
+      if (x >= width || x + glyphWidth <= 0) {
+        return glyphWidth; // Completely clipped
+      }
+      const uint8_t* glyph = MD_MAX72XX_Font::charColumns(c);
+      // Only loop over the columns that are inside the zone
+      const int16_t firstCol =
+        max(static_cast<int16_t>(-x), static_cast<int16_t>(0));
+      const int16_t endCol = min(static_cast<int16_t>(width - x),
+                                 static_cast<int16_t>(glyphWidth));
+      for (int16_t i = firstCol; i < endCol; i++) {
+        this->framebuffer->setColumn(this->firstX + x + i, glyph[i]);
+      }
+      return glyphWidth;
+    }
+
+    /**
+     * @brief Get the width of a character in columns, without drawing it.
+     *
+     * @param c The character.
+     * @return uint8_t The width of the character in columns.
+     */
+    uint8_t getCharWidth(char c) const {
+      return MD_MAX72XX_Font::charWidth(c);
+    }
+
+    /**
+     * @brief Get how many blank columns go after a character.
+     *
+     * @param c The character.
+     * @return uint8_t The number of blank columns.
+     */
+    uint8_t getCharSpacing(char c) const {
+      return MD_MAX72XX_Font::charSpacing(c);
+    }
+
+  protected:
+    MD_MAX72XX_Framebuffer* framebuffer = nullptr;
+    uint16_t firstX = 0;
+    // 0 means to the right edge of the framebuffer
+    uint16_t requestedWidth = 0;
+};
+
+#endif // PICO2W_STOCK_TICKER_MD_MAX72XX_ZONE_H
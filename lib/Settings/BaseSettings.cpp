@@ -3,12 +3,19 @@
 //
 
 #include <BaseSettings.h>
+#include <Checksum.h>
 
 namespace Settings {
   /**
    * @brief Don't touch.
    */
-  bool usbConnected = false;
+  volatile bool usbConnected = false;
+
+  namespace {
+    // What fatFSUSBConnected() last logged, the USB callbacks only set
+    // usbConnected
+    bool usbConnectedLogged = false;
+  } // namespace
 
   /**
    * @brief Save the settings to disk in JSON format.
@@ -16,11 +23,14 @@ namespace Settings {
    * @return SaveToDiskResult
    */
   SaveToDiskResult BaseSettings::saveToDisk() {
-    Serial1.printf("Saving %s settings to disk\n", this->getSettingsName());
+    LOG_INFO("Saving %s settings to disk", this->getSettingsName());
+    // Parse the new file on the next boot instead of checking it against the
+    // cache
+    SettingsCache::invalidateAll();
 
 #ifdef LOG_FREE_MEMORY
-    Serial1.printf("Free memory before save to disk: heap %d kb, stack %d kb\n",
-                   rp2040.getFreeHeap() / 1024, rp2040.getFreeStack() / 1024);
+    LOG_DEBUG("Free memory before save to disk: heap %d kb, stack %d kb",
+              rp2040.getFreeHeap() / 1024, rp2040.getFreeStack() / 1024);
 #endif
     { // Scope for JsonDocument
       JsonDocument doc;
@@ -28,51 +38,51 @@ namespace Settings {
       doc.shrinkToFit();
 
 #ifdef LOG_FREE_MEMORY
-      Serial1.printf(
-        "Free memory after building document: heap %d kb, stack %d kb\n",
+      LOG_DEBUG(
+        "Free memory after building document: heap %d kb, stack %d kb",
         rp2040.getFreeHeap() / 1024, rp2040.getFreeStack() / 1024);
 #endif
 
       { // Scope for file operations
-        Serial1.println("Starting FatFS and opening file");
+        LOG_DEBUG("Starting FatFS and opening file");
         if (!FatFS.begin()) {
-          Serial1.println("Failed to init FatFS");
+          LOG_ERROR("Failed to init FatFS");
           return SaveToDiskResult::ERROR_FATFS_INIT_FAILED;
         }
         File file = FatFS.open(this->getSettingsFilePath(), "w");
         if (!file) {
-          Serial1.printf("Failed to open %s for writing",
-                         this->getSettingsFilePath());
+          LOG_ERROR("Failed to open %s for writing",
+                    this->getSettingsFilePath());
           return SaveToDiskResult::ERROR_FILE_OPEN_FAILED;
         }
 
-        Serial1.println("Serializing JSON to file");
+        LOG_DEBUG("Serializing JSON to file");
 #ifdef LOG_JSON_PARSED
-        Serial1.println("JSON:");
-        WriteLoggingStream loggingStream(file, Serial1);
+        LOG_DEBUG("JSON:");
+        WriteLoggingStream loggingStream(file, Log::logger);
         serializeJsonPretty(doc, loggingStream);
-        Serial1.println("");
+        Log::logger.println();
 #else
         serializeJsonPretty(doc, file);
 #endif
 
 #ifdef LOG_FREE_MEMORY
-        Serial1.printf(
-          "Free memory after serialization: heap %d kb, stack %d kb\n",
+        LOG_DEBUG(
+          "Free memory after serialization: heap %d kb, stack %d kb",
           rp2040.getFreeHeap() / 1024, rp2040.getFreeStack() / 1024);
 #endif
 
-        Serial1.println("Closing file and stopping FatFS");
+        LOG_DEBUG("Closing file and stopping FatFS");
         file.close();
         FatFS.end();
       }
     }
 #ifdef LOG_FREE_MEMORY
-    Serial1.printf("Free memory after save to disk: heap %d kb, stack %d kb\n",
-                   rp2040.getFreeHeap() / 1024, rp2040.getFreeStack() / 1024);
+    LOG_DEBUG("Free memory after save to disk: heap %d kb, stack %d kb",
+              rp2040.getFreeHeap() / 1024, rp2040.getFreeStack() / 1024);
 #endif
-    Serial1.printf("%s settings saved to disk successfully\n",
-                   this->getSettingsName());
+    LOG_INFO("%s settings saved to disk successfully",
+             this->getSettingsName());
 
     return SaveToDiskResult::OK;
   }
@@ -80,124 +90,281 @@ namespace Settings {
   /**
    * @brief Load the settings from disk in JSON format.
    *
+   * Mounts and unmounts the filesystem, use Settings::loadAllFromDisk() to
+   * load several settings objects with one mount.
+   *
    * @return LoadFromDiskResult
    */
   LoadFromDiskResult BaseSettings::loadFromDisk() {
-    Serial1.printf("Loading %s settings from disk\n", this->getSettingsName());
+    LOG_DEBUG("Starting FatFS");
+    if (!FatFS.begin()) {
+      LOG_ERROR("Failed to init FatFS");
+      return LoadFromDiskResult::ERROR_FATFS_INIT_FAILED;
+    }
+    const LoadFromDiskResult result = this->loadFromMountedDisk();
+    LOG_DEBUG("Stopping FatFS");
+    FatFS.end();
+    return result;
+  }
+
+  /**
+   * @brief Load the settings from disk in JSON format. The filesystem must
+   *  already be mounted with FatFS.begin().
+   *
+   * @param timings If not nullptr, the time spent reading, parsing and
+   *  validating is added to it.
+   * @return LoadFromDiskResult
+   */
+  LoadFromDiskResult BaseSettings::loadFromMountedDisk(
+    LoadTimings* timings /* = nullptr */) {
+    // Only used for one file at a time and copied out of by
+    // loadValuesFromDocument(), so it can be shared by every settings object
+    static char fileBuffer[MAX_BUFFERED_SETTINGS_FILE_SIZE];
+
+    LOG_INFO("Loading %s settings from disk", this->getSettingsName());
 
 #ifdef LOG_FREE_MEMORY
-    Serial1.printf(
-      "Free memory before load from disk: heap %d kb, stack %d kb\n",
+    LOG_DEBUG(
+      "Free memory before load from disk: heap %d kb, stack %d kb",
       rp2040.getFreeHeap() / 1024, rp2040.getFreeStack() / 1024);
 #endif
     {
-      Serial1.println("Starting FatFS and opening file");
-      if (!FatFS.begin()) {
-        Serial1.println("Failed to init FatFS");
-        return LoadFromDiskResult::ERROR_FATFS_INIT_FAILED;
-      }
+      uint32_t start = micros();
       File file = FatFS.open(this->getSettingsFilePath(), "r");
       if (!file) {
-        Serial1.printf("Failed to open %s for reading",
-                       this->getSettingsFilePath());
+        LOG_ERROR("Failed to open %s for reading",
+                  this->getSettingsFilePath());
         return LoadFromDiskResult::ERROR_FILE_OPEN_FAILED;
       }
 
       {
-        Serial1.println("Deserializing JSON from file");
         JsonDocument doc;
+        DeserializationError error;
+        const size_t fileSize = file.size();
+        if (fileSize < MAX_BUFFERED_SETTINGS_FILE_SIZE) {
+          // Parsing from memory is much faster than parsing from the file one
+          // byte at a time
+          const size_t bytesRead = file.read(
+            reinterpret_cast<uint8_t*>(fileBuffer), fileSize);
+          file.close();
+          if (timings != nullptr) {
+            timings->read += micros() - start;
+          }
+#ifdef LOG_JSON_PARSED
+          LOG_DEBUG("JSON:");
+          Log::logger.write(fileBuffer, bytesRead);
+          Log::logger.println();
+#endif
+          LOG_DEBUG("Deserializing JSON from memory");
+          start = micros();
+          // Const so ArduinoJson copies strings instead of pointing into the
+          // shared buffer
+          error = deserializeJson(doc, static_cast<const char*>(fileBuffer),
+                                  bytesRead);
+        } else {
+          LOG_DEBUG("Deserializing JSON from file");
 #ifdef LOG_JSON_PARSED
-        Serial1.println("JSON:");
-        ReadLoggingStream loggingStream(file, Serial1);
-        DeserializationError error = deserializeJson(doc, loggingStream);
-        Serial1.println("");
+          LOG_DEBUG("JSON:");
+          ReadLoggingStream loggingStream(file, Log::logger);
+          error = deserializeJson(doc, loggingStream);
+          Log::logger.println();
 #else
-        DeserializationError error = deserializeJson(doc, file);
+          error = deserializeJson(doc, file);
 #endif
-        Serial1.println("Closing file and stopping FatFS");
-        file.close();
-        FatFS.end();
+          file.close();
+        }
+        if (timings != nullptr) {
+          timings->parse += micros() - start;
+        }
 
         if (error) {
-          Serial1.printf("Failed to deserialize JSON: %s\n", error.c_str());
+          LOG_ERROR("Failed to deserialize JSON: %s", error.c_str());
           switch (error.code()) {
             case DeserializationError::TooDeep: {
-              Serial1.println("JSON is too deep, please check the file");
+              LOG_ERROR("JSON is too deep, please check the file");
               return LoadFromDiskResult::ERROR_JSON_PARSE_TOO_DEEP;
             }
             case DeserializationError::NoMemory: {
-              Serial1.println("JSON parsing failed due to insufficient memory");
+              LOG_ERROR("JSON parsing failed due to insufficient memory");
               return LoadFromDiskResult::ERROR_JSON_PARSE_NO_MEMORY;
             }
             case DeserializationError::InvalidInput: {
-              Serial1.println("JSON parsing failed due to invalid input");
+              LOG_ERROR("JSON parsing failed due to invalid input");
               return LoadFromDiskResult::ERROR_JSON_PARSE_INVALID_INPUT;
             }
             case DeserializationError::IncompleteInput: {
-              Serial1.println("JSON parsing failed due to incomplete input");
+              LOG_ERROR("JSON parsing failed due to incomplete input");
               return LoadFromDiskResult::ERROR_JSON_PARSE_INCOMPLETE_INPUT;
             }
             case DeserializationError::EmptyInput: {
-              Serial1.println("JSON parsing failed due to empty input");
+              LOG_ERROR("JSON parsing failed due to empty input");
               return LoadFromDiskResult::ERROR_JSON_PARSE_EMPTY_INPUT;
             }
             case DeserializationError::Ok:
             default: {
-              Serial1.println("Unknown error");
+              LOG_ERROR("Unknown error");
               return LoadFromDiskResult::ERROR_JSON_PARSE_UNKNOWN_ERROR;
             }
           }
         }
 
 #ifdef LOG_FREE_MEMORY
-        Serial1.printf(
-          "Free memory after deserialization: heap %d kb, stack %d kb\n",
+        LOG_DEBUG(
+          "Free memory after deserialization: heap %d kb, stack %d kb",
           rp2040.getFreeHeap() / 1024, rp2040.getFreeStack() / 1024);
 #endif
 
-        this->lastValidationResult = this->validateSettings(doc);
+        start = micros();
+        this->lastValidationResult = this->loadValuesFromDocument(doc);
         if (this->lastValidationResult == 0) {
-          Serial1.printf("%s settings validation passed\n",
-                         this->getSettingsName());
-          this->loadValuesFromDocument(doc);
-        } else {
-          Serial1.printf(
-            "Validation failed for %s settings after loading from disk\n",
+          LOG_INFO("%s settings validation passed",
+                   this->getSettingsName());
+        }
+        if (timings != nullptr) {
+          timings->validate += micros() - start;
+        }
+        if (this->lastValidationResult != 0) {
+          LOG_ERROR(
+            "Validation failed for %s settings after loading from disk",
             this->getSettingsName());
           return LoadFromDiskResult::ERROR_VALIDATION_FAILED;
         }
       }
     }
 #ifdef LOG_FREE_MEMORY
-    Serial1.printf(
-      "Free memory after load from disk: heap %d kb, stack %d kb\n",
+    LOG_DEBUG(
+      "Free memory after load from disk: heap %d kb, stack %d kb",
       rp2040.getFreeHeap() / 1024, rp2040.getFreeStack() / 1024);
 #endif
-    Serial1.printf("%s settings loaded from disk successfully\n",
-                   this->getSettingsName());
+    LOG_INFO("%s settings loaded from disk successfully",
+             this->getSettingsName());
 
     return LoadFromDiskResult::OK;
   }
 
+  /**
+   * @brief Load several settings objects with a single filesystem mount.
+   *
+   * @param allSettings The settings objects to load.
+   * @param results Where to put the result of loading each settings object,
+   *  same order as allSettings.
+   * @param count How many settings objects there are.
+   * @param timings If not nullptr, the time spent mounting, reading, parsing
+   *  and validating is added to it.
+   * @param whileMounted If not nullptr, called after the settings are loaded
+   *  while the filesystem is still mounted, to read anything else in the
+   *  same mount.
+   */
+  void loadAllFromDisk(BaseSettings* const* allSettings,
+                       LoadFromDiskResult* results, size_t count,
+                       LoadTimings* timings /* = nullptr */,
+                       void (*whileMounted)() /* = nullptr */) {
+    LOG_DEBUG("Starting FatFS");
+    const uint32_t start = micros();
+    const bool mounted = FatFS.begin();
+    if (timings != nullptr) {
+      timings->mount += micros() - start;
+    }
+    if (!mounted) {
+      LOG_ERROR("Failed to init FatFS");
+      for (size_t i = 0; i < count; i++) {
+        results[i] = LoadFromDiskResult::ERROR_FATFS_INIT_FAILED;
+      }
+      return;
+    }
+    SettingsCache cache;
+    cache.begin();
+    for (size_t i = 0; i < count; i++) {
+      SettingsFileFingerprint fingerprint = {};
+      const uint32_t readStart = micros();
+      const bool hasFingerprint =
+        allSettings[i]->getFileFingerprint(fingerprint);
+      if (hasFingerprint && cache.restore(i, *allSettings[i], fingerprint)) {
+        LOG_INFO("%s settings restored from cache",
+                 allSettings[i]->getSettingsName());
+        if (timings != nullptr) {
+          timings->read += micros() - readStart;
+          timings->cacheHits++;
+        }
+        results[i] = LoadFromDiskResult::OK;
+        continue;
+      }
+      results[i] = allSettings[i]->loadFromMountedDisk(timings);
+      if (hasFingerprint && results[i] == LoadFromDiskResult::OK) {
+        cache.store(i, *allSettings[i], fingerprint);
+      }
+    }
+    cache.end();
+    if (whileMounted != nullptr) {
+      whileMounted();
+    }
+    LOG_DEBUG("Stopping FatFS");
+    FatFS.end();
+  }
+
+  /**
+   * @brief Get the fingerprint of the settings file, which changes whenever
+   *  its contents do. The filesystem must already be mounted.
+   *
+   * The whole file is read for its CRC, which is still much faster than
+   * parsing and validating it.
+   *
+   * @param fingerprint Where to put the fingerprint.
+   * @return true if the file exists, false otherwise.
+   */
+  bool BaseSettings::getFileFingerprint(
+    SettingsFileFingerprint& fingerprint) const {
+    File file = FatFS.open(this->getSettingsFilePath(), "r");
+    if (!file) {
+      return false;
+    }
+    fingerprint.size = file.size();
+    fingerprint.lastWrite = static_cast<uint32_t>(file.getLastWrite());
+    fingerprint.contentCrc = 0;
+    uint8_t buffer[64];
+    size_t bytesRead;
+    while ((bytesRead = file.read(buffer, sizeof(buffer))) > 0) {
+      fingerprint.contentCrc =
+        Checksum::crc32(buffer, bytesRead, fingerprint.contentCrc);
+    }
+    file.close();
+    return true;
+  }
+
   /**
    * @brief Start exposing the FatFS filesystem to the computer as a USB.
    *
    * This will allow the user to modify the settings file on the USB drive.
    */
   void BaseSettings::fatFSUSBBegin() {
-    Serial1.println("Exposing FatFS to USB");
-    FatFSUSB.onUnplug([](uint32_t i) {
-      usbConnected = false;
-      Serial1.println("USB unplugged");
-    });
-    FatFSUSB.onPlug([](uint32_t i) {
-      usbConnected = true;
-      Serial1.println("USB plugged in");
-    });
+    // Anything could be edited, parse every file on the next boot instead of
+    // checking them against the cache
+    SettingsCache::invalidateAll();
+    LOG_INFO("Exposing FatFS to USB");
+    // These run in the USB interrupt, where logging could break into a line
+    // loop() is adding, so fatFSUSBConnected() logs the change instead
+    FatFSUSB.onUnplug([](uint32_t i) { usbConnected = false; });
+    FatFSUSB.onPlug([](uint32_t i) { usbConnected = true; });
     FatFSUSB.driveReady([](uint32_t i) { return true; });
     FatFSUSB.begin();
     usbConnected = true;
-    Serial1.println("FatFSUSB started");
+    usbConnectedLogged = true;
+    LOG_INFO("FatFSUSB started");
+  }
+
+  /**
+   * @brief Check if the Pico is being exposed to the computer as a USB
+   *  drive, and log if it was plugged in or unplugged since the last check.
+   *
+   * @return true if it is.
+   */
+  bool BaseSettings::fatFSUSBConnected() const {
+    const bool connected = usbConnected;
+    if (connected != usbConnectedLogged) {
+      usbConnectedLogged = connected;
+      LOG_INFO("USB %s", connected ? "plugged in" : "unplugged");
+    }
+    return connected;
   }
 
   /**
@@ -208,6 +375,157 @@ namespace Settings {
   void BaseSettings::fatFSUSBEnd() {
     FatFSUSB.end();
     usbConnected = false;
-    Serial1.println("FatFSUSB stopped");
+    usbConnectedLogged = false;
+    LOG_INFO("FatFSUSB stopped");
+  }
+
+  /**
+   * @brief Copy every field into the cache, one after another in schema
+   *  order.
+   *
+   * @param cache Where to copy getCacheSize() bytes of values to.
+   */
+  void BaseSettings::saveValuesToCache(uint8_t* cache) const {
+    const SettingsSchema& schema = this->getSchema();
+    const uint8_t* values = this->getValues();
+    for (uint8_t i = 0; i < schema.fieldCount; i++) {
+      const FieldDescriptor& field = schema.fields[i];
+      memcpy(cache, values + field.offset, field.size);
+      cache += field.size;
+    }
+  }
+
+  /**
+   * @brief Copy every field back out of the cache, in the same order as
+   *  saveValuesToCache().
+   *
+   * @param cache Where to copy getCacheSize() bytes of values from.
+   */
+  void BaseSettings::loadValuesFromCache(const uint8_t* cache) {
+    const SettingsSchema& schema = this->getSchema();
+    uint8_t* values = this->getValues();
+    for (uint8_t i = 0; i < schema.fieldCount; i++) {
+      const FieldDescriptor& field = schema.fields[i];
+      memcpy(values + field.offset, cache, field.size);
+      cache += field.size;
+    }
+  }
+
+  /**
+   * @brief Save every field to the JSON document.
+   *
+   * @param doc The JSON document to save values to.
+   */
+  void BaseSettings::saveValuesToDocument(JsonDocument& doc) const {
+    const SettingsSchema& schema = this->getSchema();
+    const uint8_t* values = this->getValues();
+    for (uint8_t i = 0; i < schema.fieldCount; i++) {
+      const FieldDescriptor& field = schema.fields[i];
+      const uint8_t* value = values + field.offset;
+      switch (field.type) {
+        case FieldType::STRING:
+          doc[field.key] = reinterpret_cast<const char*>(value);
+          break;
+        case FieldType::UINT8:
+          doc[field.key] = *value;
+          break;
+        case FieldType::UINT16:
+          doc[field.key] = *reinterpret_cast<const uint16_t*>(value);
+          break;
+        case FieldType::UINT32:
+          doc[field.key] = *reinterpret_cast<const uint32_t*>(value);
+          break;
+        case FieldType::BOOL:
+          doc[field.key] = *reinterpret_cast<const bool*>(value);
+          break;
+      }
+    }
+  }
+
+  /**
+   * @brief Validate and load every field from the JSON document in one pass.
+   *
+   * Values are staged and only copied in once every field is valid, so the
+   * current values are untouched if validation fails.
+   *
+   * @param doc The JSON document to load values from.
+   * @return uint8_t 0 if the settings are valid, otherwise the error of the
+   *  first invalid field.
+   */
+  uint8_t BaseSettings::loadValuesFromDocument(const JsonDocument& doc) {
+    // Only used for one settings object at a time
+    static uint8_t staging[MAX_SETTINGS_VALUES_SIZE];
+
+    const SettingsSchema& schema = this->getSchema();
+    memcpy(staging, this->getValues(), schema.valuesSize);
+    for (uint8_t i = 0; i < schema.fieldCount; i++) {
+      const FieldDescriptor& field = schema.fields[i];
+      uint8_t* value = staging + field.offset;
+      JsonVariantConst variant = doc[field.key];
+      switch (field.type) {
+        case FieldType::STRING: {
+          const char* str = field.defaultString;
+          if (!variant.isNull()) {
+            if (!variant.is<const char*>()) {
+              return field.error;
+            }
+            str = variant.as<const char*>();
+          }
+          if (str == nullptr) {
+            return field.error; // Required
+          }
+          // Bounded so an overly long string isn't walked to the end
+          const size_t len = strnlen(str, field.size);
+          if (len < field.minimum || len > field.maximum) {
+            return field.error;
+          }
+          if (field.choices != nullptr) {
+            bool matched = false;
+            for (uint8_t j = 0; j < field.choiceCount && !matched; j++) {
+              matched = strcmp(str, field.choices[j]) == 0;
+            }
+            if (!matched) {
+              return field.error;
+            }
+          }
+          if (field.isValid != nullptr && !field.isValid(str)) {
+            return field.error;
+          }
+          strncpy(reinterpret_cast<char*>(value), str, field.size);
+          break;
+        }
+        case FieldType::UINT8:
+        case FieldType::UINT16:
+        case FieldType::UINT32: {
+          uint32_t number = field.defaultNumber;
+          if (!variant.isNull()) {
+            if (!variant.is<uint32_t>()) {
+              return field.error;
+            }
+            number = variant.as<uint32_t>();
+          }
+          if (number < field.minimum || number > field.maximum) {
+            return field.error;
+          }
+          if (field.type == FieldType::UINT8) {
+            *value = static_cast<uint8_t>(number);
+          } else if (field.type == FieldType::UINT16) {
+            const uint16_t narrowed = static_cast<uint16_t>(number);
+            memcpy(value, &narrowed, sizeof(narrowed));
+          } else {
+            memcpy(value, &number, sizeof(number));
+          }
+          break;
+        }
+        case FieldType::BOOL: {
+          const bool flag = variant.is<bool>() ? variant.as<bool>()
+                                               : field.defaultNumber != 0;
+          memcpy(value, &flag, sizeof(flag));
+          break;
+        }
+      }
+    }
+    memcpy(this->getValues(), staging, schema.valuesSize);
+    return 0;
   }
 } // Settings
@@ -6,19 +6,25 @@
 #define PICO2W_STOCK_TICKER_BASESETTINGS_H
 
 #ifndef LOG_FREE_MEMORY
-  #define LOG_FREE_MEMORY
+// #define LOG_FREE_MEMORY
 #endif
 #ifndef LOG_JSON_PARSED
-  #define LOG_JSON_PARSED
+// #define LOG_JSON_PARSED
 #endif
 
 #include <Arduino.h>
 #include <ArduinoJson.h>
 #include <FatFS.h>
 #include <FatFSUSB.h>
+#include <Log.h>
+#include <SettingsCache.h>
+#include <SettingsSchema.h>
 #include <StreamUtils.h>
 
 namespace Settings {
+  // Settings files smaller than this are read into memory in one go before
+  // parsing, larger ones are parsed straight from the file
+  const size_t MAX_BUFFERED_SETTINGS_FILE_SIZE = 2048;
 
   enum class SaveToDiskResult {
     OK,
@@ -39,7 +45,20 @@ namespace Settings {
     ERROR_VALIDATION_FAILED
   };
 
-  extern bool usbConnected;
+  extern volatile bool usbConnected;
+
+  /**
+   * @brief Where the time went while loading settings, in microseconds. Times
+   *  add up over every settings object loaded with the same LoadTimings.
+   */
+  struct LoadTimings {
+      uint32_t mount;
+      uint32_t read;
+      uint32_t parse;
+      uint32_t validate;
+      // How many settings objects were restored from SettingsCache instead
+      uint8_t cacheHits;
+  };
 
   class BaseSettings {
     public:
@@ -48,17 +67,8 @@ namespace Settings {
 
       SaveToDiskResult saveToDisk();
       LoadFromDiskResult loadFromDisk();
-
-      /**
-       * @brief Validate the settings. This method should be implemented by
-       *  classes inheriting from BaseSettings to validate their specific
-       *  settings.
-       *
-       * @param doc The JSON document containing the settings to validate.
-       * @return 0 if the settings are valid, otherwise return a class-specific
-       * enum specifying what's wrong.
-       */
-      virtual uint8_t validateSettings(JsonDocument& doc) = 0;
+      LoadFromDiskResult loadFromMountedDisk(LoadTimings* timings = nullptr);
+      bool getFileFingerprint(SettingsFileFingerprint& fingerprint) const;
 
       /**
        * @brief Get the last validation result.
@@ -72,33 +82,50 @@ namespace Settings {
 
       void fatFSUSBBegin();
       void fatFSUSBEnd();
-      /**
-       * @brief Check if the Pico is being exposed to the computer as a USB
-       *  drive.
-       *
-       * @return
-       */
-      bool fatFSUSBConnected() const {
-        return usbConnected;
-      }
+      bool fatFSUSBConnected() const;
 
     protected:
+      friend class SettingsCache;
+      friend void loadAllFromDisk(BaseSettings* const* allSettings,
+                                  LoadFromDiskResult* results, size_t count,
+                                  LoadTimings* timings,
+                                  void (*whileMounted)());
+
       uint8_t lastValidationResult = 0;
 
       /**
        * @brief Classes inheriting from BaseSettings must implement this method
-       *  to save their specific values to the JSON document.
+       *  to describe their values, see SettingsSchema.h.
        *
-       * @param doc The JSON document to save values to.
+       * @return The field table built with makeSchema().
        */
-      virtual void saveValuesToDocument(JsonDocument& doc) = 0;
+      virtual const SettingsSchema& getSchema() const = 0;
       /**
        * @brief Classes inheriting from BaseSettings must implement this method
-       *  to load their specific values from the JSON document.
+       *  to point to the values struct the schema's offsets are from.
        *
-       * @param doc The JSON document to load values from.
+       * @return The start of the values struct.
        */
-      virtual void loadValuesFromDocument(const JsonDocument& doc) = 0;
+      virtual uint8_t* getValues() = 0;
+
+      const uint8_t* getValues() const {
+        return const_cast<BaseSettings*>(this)->getValues();
+      }
+
+      /**
+       * @brief How many bytes the values take up in SettingsCache. At most
+       *  MAX_CACHED_SETTINGS_SIZE.
+       *
+       * @return The size of the cached values in bytes.
+       */
+      size_t getCacheSize() const {
+        return this->getSchema().cacheSize;
+      }
+
+      void saveValuesToCache(uint8_t* cache) const;
+      void loadValuesFromCache(const uint8_t* cache);
+      void saveValuesToDocument(JsonDocument& doc) const;
+      uint8_t loadValuesFromDocument(const JsonDocument& doc);
 
       /**
        * @brief Get the name of the settings. Ex. for WiFi settings it might
@@ -117,6 +144,11 @@ namespace Settings {
       virtual const char* getSettingsFilePath() const = 0;
   };
 
+  void loadAllFromDisk(BaseSettings* const* allSettings,
+                       LoadFromDiskResult* results, size_t count,
+                       LoadTimings* timings = nullptr,
+                       void (*whileMounted)() = nullptr);
+
 } // Settings
 
 #endif // PICO2W_STOCK_TICKER_BASESETTINGS_H
@@ -0,0 +1,21 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_EEPROMLAYOUT_H
+#define PICO2W_STOCK_TICKER_EEPROMLAYOUT_H
+
+#include <Arduino.h>
+
+namespace Settings {
+  // EEPROM.commit() erases the whole flash sector and only writes back as many
+  // bytes as EEPROM.begin() was given, so every user must begin with this size
+  // or it would wipe everyone after it
+  const size_t EEPROM_EMULATION_SIZE = 4096;
+
+  // Where each user's data starts
+  const size_t SETTINGS_CACHE_EEPROM_OFFSET = 0;
+  const size_t WIFI_LINK_CACHE_EEPROM_OFFSET = 3072;
+} // Settings
+
+#endif // PICO2W_STOCK_TICKER_EEPROMLAYOUT_H
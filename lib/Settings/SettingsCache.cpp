@@ -0,0 +1,118 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#include <BaseSettings.h>
+#include <Checksum.h>
+#include <SettingsCache.h>
+
+namespace Settings {
+  /**
+   * @brief Load the cache from flash into RAM.
+   */
+  void SettingsCache::begin() {
+    EEPROM.begin(EEPROM_EMULATION_SIZE);
+    this->dirty = false;
+  }
+
+  /**
+   * @brief Write the cache back to flash if anything was stored, and free the
+   *  RAM copy.
+   */
+  void SettingsCache::end() {
+    if (this->dirty) {
+      LOG_DEBUG("Writing settings cache to flash");
+      EEPROM.commit();
+      this->dirty = false;
+    }
+    EEPROM.end();
+  }
+
+  /**
+   * @brief Restore settings values from the cache.
+   *
+   * @param slot The slot the settings were stored in.
+   * @param settings The settings to restore.
+   * @param fingerprint The fingerprint of the settings file right now.
+   * @return true if the slot was valid and cached from the same file, so the
+   *  settings were restored. false if the settings were left alone.
+   */
+  bool SettingsCache::restore(uint8_t slot, BaseSettings& settings,
+                              const SettingsFileFingerprint& fingerprint) {
+    if (slot >= MAX_CACHED_SETTINGS) {
+      return false;
+    }
+    const Slot* cached = getSlots() + slot;
+    if (cached->magic != SETTINGS_CACHE_MAGIC ||
+        cached->version != SETTINGS_CACHE_VERSION ||
+        cached->dataSize != settings.getCacheSize() ||
+        cached->fingerprint.size != fingerprint.size ||
+        cached->fingerprint.lastWrite != fingerprint.lastWrite ||
+        cached->fingerprint.contentCrc != fingerprint.contentCrc ||
+        cached->crc != slotCrc(*cached)) {
+      return false;
+    }
+    settings.loadValuesFromCache(cached->data);
+    settings.lastValidationResult = 0; // Only validated values are cached
+    return true;
+  }
+
+  /**
+   * @brief Store validated settings values in the cache. Only written to
+   *  flash on SettingsCache::end().
+   *
+   * @param slot The slot to store the settings in.
+   * @param settings The settings to store, must have been validated.
+   * @param fingerprint The fingerprint of the file the settings came from.
+   */
+  void SettingsCache::store(uint8_t slot, const BaseSettings& settings,
+                            const SettingsFileFingerprint& fingerprint) {
+    if (slot >= MAX_CACHED_SETTINGS ||
+        settings.getCacheSize() > MAX_CACHED_SETTINGS_SIZE) {
+      return;
+    }
+    Slot* cached = getSlots() + slot;
+    memset(cached, 0, sizeof(Slot));
+    cached->magic = SETTINGS_CACHE_MAGIC;
+    cached->version = SETTINGS_CACHE_VERSION;
+    cached->dataSize = settings.getCacheSize();
+    cached->fingerprint = fingerprint;
+    settings.saveValuesToCache(cached->data);
+    cached->crc = slotCrc(*cached);
+    this->dirty = true;
+  }
+
+  /**
+   * @brief Throw away every cached settings value, so the next boot parses
+   *  the JSON files again. Used whenever the files might change, like being
+   *  edited over USB, so the fingerprint isn't the only thing that catches
+   *  it.
+   */
+  void SettingsCache::invalidateAll() {
+    EEPROM.begin(EEPROM_EMULATION_SIZE);
+    Slot* slots = getSlots();
+    bool changed = false;
+    for (uint8_t i = 0; i < MAX_CACHED_SETTINGS; i++) {
+      if (slots[i].magic != 0) {
+        slots[i].magic = 0;
+        changed = true;
+      }
+    }
+    if (changed) { // Don't wear flash when already invalid
+      LOG_DEBUG("Invalidating settings cache");
+      EEPROM.commit();
+    }
+    EEPROM.end();
+  }
+
+  /**
+   * @brief Calculate the CRC of everything in a slot except the CRC itself.
+   *
+   * @param slot The slot.
+   * @return uint32_t The CRC.
+   */
+  uint32_t SettingsCache::slotCrc(const Slot& slot) {
+    uint32_t crc = Checksum::crc32(&slot, offsetof(Slot, crc));
+    return Checksum::crc32(slot.data, slot.dataSize, crc);
+  }
+} // Settings
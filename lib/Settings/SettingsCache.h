@@ -0,0 +1,85 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_SETTINGSCACHE_H
+#define PICO2W_STOCK_TICKER_SETTINGSCACHE_H
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <EEPROMLayout.h>
+#include <Log.h>
+
+namespace Settings {
+  class BaseSettings;
+
+  const uint32_t SETTINGS_CACHE_MAGIC = 0x53544B43; // "STKC"
+  // Bump this when the layout of any settings class' cached values changes
+  const uint16_t SETTINGS_CACHE_VERSION = 6;
+  const uint8_t MAX_CACHED_SETTINGS = 4;
+  const size_t MAX_CACHED_SETTINGS_SIZE = 512;
+
+  /**
+   * @brief Identifies a version of a settings file without parsing it.
+   */
+  struct SettingsFileFingerprint {
+      uint32_t size;
+      uint32_t lastWrite;
+      // CRC of the whole file, since an edit can keep the size and the
+      // modification time (like without a real time clock)
+      uint32_t contentCrc;
+  };
+
+  /**
+   * @brief Validated settings values kept in flash (EEPROM emulation) so they
+   *  can be restored with a memcpy instead of parsing and validating JSON
+   *  again.
+   *
+   * Each settings object gets a fixed slot with its own CRC, and a slot is
+   * only used if the settings file's fingerprint still matches the one it was
+   * cached from.
+   */
+  class SettingsCache {
+    public:
+      SettingsCache() = default;
+      ~SettingsCache() = default;
+
+      void begin();
+      void end();
+
+      bool restore(uint8_t slot, BaseSettings& settings,
+                   const SettingsFileFingerprint& fingerprint);
+      void store(uint8_t slot, const BaseSettings& settings,
+                 const SettingsFileFingerprint& fingerprint);
+
+      static void invalidateAll();
+
+    protected:
+      // clang-format off
+      struct Slot {
+          uint32_t magic;
+          uint16_t version;
+          uint16_t dataSize;
+          SettingsFileFingerprint fingerprint;
+          uint32_t crc;
+          uint8_t data[MAX_CACHED_SETTINGS_SIZE];
+      };
+      // clang-format on
+
+      static const size_t EEPROM_SIZE = sizeof(Slot) * MAX_CACHED_SETTINGS;
+      static_assert(SETTINGS_CACHE_EEPROM_OFFSET + EEPROM_SIZE <=
+                      WIFI_LINK_CACHE_EEPROM_OFFSET,
+                    "Settings cache overlaps the WiFi link cache");
+
+      static Slot* getSlots() {
+        return reinterpret_cast<Slot*>(EEPROM.getDataPtr() +
+                                       SETTINGS_CACHE_EEPROM_OFFSET);
+      }
+
+      bool dirty = false;
+
+      static uint32_t slotCrc(const Slot& slot);
+  };
+} // Settings
+
+#endif // PICO2W_STOCK_TICKER_SETTINGSCACHE_H
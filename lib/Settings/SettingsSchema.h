@@ -0,0 +1,171 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_SETTINGSSCHEMA_H
+#define PICO2W_STOCK_TICKER_SETTINGSSCHEMA_H
+
+#include <Arduino.h>
+
+namespace Settings {
+  // Largest values struct a settings class can have, it is staged in a shared
+  // buffer while a document is validated
+  const size_t MAX_SETTINGS_VALUES_SIZE = 512;
+
+  enum class FieldType : uint8_t {
+    STRING,
+    UINT8,
+    UINT16,
+    UINT32,
+    BOOL
+  };
+
+  /**
+   * @brief Describes one setting: its JSON key, where it lives in the values
+   *  struct, and what is allowed.
+   *
+   * Build these with stringField(), numberField() and boolField() so the table
+   * can be constexpr.
+   */
+  struct FieldDescriptor {
+      const char* key;
+      FieldType type;
+      // offsetof() the value in the settings class' values struct
+      uint16_t offset;
+      // Capacity including the null terminator for strings, sizeof otherwise
+      uint16_t size;
+      // Length bounds for strings, value bounds for numbers, both inclusive
+      uint32_t minimum;
+      uint32_t maximum;
+      // Used when the key is missing, strings without a default are required
+      uint32_t defaultNumber;
+      const char* defaultString;
+      // If not nullptr, a string must be one of these
+      const char* const* choices;
+      uint8_t choiceCount;
+      // If not nullptr, a string must also pass this
+      bool (*isValid)(const char* value);
+      // Validation result returned when this field is invalid
+      uint8_t error;
+  };
+
+  /**
+   * @brief Describe a string setting.
+   *
+   * @param key The JSON key.
+   * @param offset offsetof() the char array in the values struct.
+   * @param size The size of the char array, the string must be shorter.
+   * @param minLength The shortest allowed string.
+   * @param defaultString Used if the key is missing, nullptr if required.
+   * @param error Validation result when invalid.
+   * @param choices If not nullptr, the allowed strings.
+   * @param choiceCount How many strings are in choices.
+   * @param isValid If not nullptr, an extra check the string must pass.
+   */
+  constexpr FieldDescriptor stringField(
+    const char* key, size_t offset, size_t size, uint32_t minLength,
+    const char* defaultString, uint8_t error,
+    const char* const* choices = nullptr, uint8_t choiceCount = 0,
+    bool (*isValid)(const char* value) = nullptr) {
+    return {key,
+            FieldType::STRING,
+            static_cast<uint16_t>(offset),
+            static_cast<uint16_t>(size),
+            minLength,
+            static_cast<uint32_t>(size - 1),
+            0,
+            defaultString,
+            choices,
+            choiceCount,
+            isValid,
+            error};
+  }
+
+  /**
+   * @brief Describe an unsigned integer setting.
+   *
+   * @tparam T uint8_t, uint16_t or uint32_t.
+   * @param key The JSON key.
+   * @param offset offsetof() the value in the values struct.
+   * @param minimum The smallest allowed value.
+   * @param maximum The largest allowed value.
+   * @param defaultNumber Used if the key is missing.
+   * @param error Validation result when invalid.
+   */
+  template <typename T>
+  constexpr FieldDescriptor numberField(const char* key, size_t offset,
+                                        uint32_t minimum, uint32_t maximum,
+                                        uint32_t defaultNumber, uint8_t error) {
+    static_assert(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4,
+                  "Only 8, 16 and 32-bit settings are supported");
+    return {key,
+            sizeof(T) == 1   ? FieldType::UINT8
+            : sizeof(T) == 2 ? FieldType::UINT16
+                             : FieldType::UINT32,
+            static_cast<uint16_t>(offset),
+            sizeof(T),
+            minimum,
+            maximum,
+            defaultNumber,
+            nullptr,
+            nullptr,
+            0,
+            nullptr,
+            error};
+  }
+
+  /**
+   * @brief Describe a boolean setting, anything that isn't a boolean is
+   *  treated as missing.
+   *
+   * @param key The JSON key.
+   * @param offset offsetof() the value in the values struct.
+   * @param defaultValue Used if the key is missing.
+   */
+  constexpr FieldDescriptor boolField(const char* key, size_t offset,
+                                      bool defaultValue) {
+    return {key,
+            FieldType::BOOL,
+            static_cast<uint16_t>(offset),
+            sizeof(bool),
+            0,
+            1,
+            defaultValue,
+            nullptr,
+            nullptr,
+            0,
+            nullptr,
+            0};
+  }
+
+  /**
+   * @brief A settings class' field table.
+   */
+  struct SettingsSchema {
+      const FieldDescriptor* fields;
+      uint8_t fieldCount;
+      // Size of the values struct
+      uint16_t valuesSize;
+      // Sum of every field's size, how many bytes the values take in
+      // SettingsCache
+      uint16_t cacheSize;
+  };
+
+  /**
+   * @brief Build a schema from a field table.
+   *
+   * @tparam Values The values struct the fields are in.
+   */
+  template <typename Values, size_t N>
+  constexpr SettingsSchema makeSchema(const FieldDescriptor (&fields)[N]) {
+    static_assert(sizeof(Values) <= MAX_SETTINGS_VALUES_SIZE,
+                  "Values struct is larger than MAX_SETTINGS_VALUES_SIZE");
+    uint16_t cacheSize = 0;
+    for (size_t i = 0; i < N; i++) {
+      cacheSize += fields[i].size;
+    }
+    return {fields, static_cast<uint8_t>(N), sizeof(Values), cacheSize};
+  }
+} // Settings
+
+#endif // PICO2W_STOCK_TICKER_SETTINGSSCHEMA_H
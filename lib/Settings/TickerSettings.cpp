@@ -5,89 +5,116 @@
 #include <TickerSettings.h>
 
 namespace Settings {
-#pragma clang diagnostic push
-#pragma ide diagnostic ignored "readability-convert-member-functions-to-static"
-  uint8_t TickerSettings::validateSettings(JsonDocument& doc) {
-    const char* parsedApcaApiKeyId = doc["apcaApiKeyId"];
-    const char* parsedApcaApiSecretKey = doc["apcaApiSecretKey"];
-    const char* parsedSymbols = doc["symbols"];
-    const char* parsedSourceFeed = doc["sourceFeed"];
-    const uint16_t parsedScrollPeriod =
-      doc["scrollPeriod"] | 30; // Default to 30 ms
-    const uint32_t parsedRequestPeriod =
-      doc["requestPeriod"] | 60; // Default to 60 seconds
-    const uint8_t parsedDisplayBrightness =
-      doc["displayBrightness"] | 7; // Default to 7
-    if (strlen(parsedApcaApiKeyId) == 0 ||
-        strlen(parsedApcaApiKeyId) >= APCA_API_KEY_ID_MAX_LEN) {
-      return static_cast<uint8_t>(
-        TickerSettingsValidationResult::ERROR_INVALID_APCA_API_KEY_ID);
-    }
-    if (strlen(parsedApcaApiSecretKey) == 0 ||
-        strlen(parsedApcaApiSecretKey) >= APCA_API_SECRET_KEY_MAX_LEN) {
-      return static_cast<uint8_t>(
-        TickerSettingsValidationResult::ERROR_INVALID_APCA_API_SECRET_KEY);
-    }
-    if (strlen(parsedSymbols) == 0 ||
-        strlen(parsedSymbols) >= SYMBOLS_STRING_MAX_LEN) {
-      return static_cast<uint8_t>(
-        TickerSettingsValidationResult::ERROR_INVALID_SYMBOLS);
-    }
-    const uint16_t symbolsCount = StockTicker::stockSymbolsCount(parsedSymbols);
-    if (symbolsCount > MAX_SYMBOLS_COUNT || symbolsCount == 0) {
-      return static_cast<uint8_t>(
-        TickerSettingsValidationResult::ERROR_INVALID_SYMBOLS);
-    }
-    if (strcmp(parsedSourceFeed, "sip") != 0 &&
-        strcmp(parsedSourceFeed, "iex") != 0 &&
-        strcmp(parsedSourceFeed, "delayed_sip") != 0 &&
-        strcmp(parsedSourceFeed, "boats") != 0 &&
-        strcmp(parsedSourceFeed, "overnight") != 0 &&
-        strcmp(parsedSourceFeed, "otc") != 0) {
-      return static_cast<uint8_t>(
-        TickerSettingsValidationResult::ERROR_INVALID_SOURCE_FEED);
-    }
-    if (parsedScrollPeriod <
-        1) { // Must be a natural number and already uint16_t
-      return static_cast<uint8_t>(
-        TickerSettingsValidationResult::ERROR_INVALID_SCROLL_PERIOD);
-    }
-    if (parsedRequestPeriod <
-        1) { // Must be a natural number and already uint32_t
-      return static_cast<uint8_t>(
-        TickerSettingsValidationResult::ERROR_INVALID_REQUEST_PERIOD);
+  namespace {
+    constexpr const char* SOURCE_FEEDS[] = {"sip",   "iex",       "delayed_sip",
+                                            "boats", "overnight", "otc"};
+    constexpr const char* CRYPTO_LOCATIONS[] = {"us", "us-1", "eu-1"};
+    constexpr const char* LOG_LEVELS[] = {"none", "error", "warn", "info",
+                                          "debug"};
+
+    bool isValidSymbols(const char* symbols) {
+      const uint16_t symbolsCount = StockTicker::stockSymbolsCount(symbols);
+      return symbolsCount > 0 && symbolsCount <= MAX_SYMBOLS_COUNT;
     }
-    if (parsedDisplayBrightness < 1 ||
-        parsedDisplayBrightness > 15) { // Must be a natural number between 1
-                                        // and 15 inclusive and already uint8_t
-      return static_cast<uint8_t>(
-        TickerSettingsValidationResult::ERROR_INVALID_DISPLAY_BRIGHTNESS);
+
+    constexpr uint8_t error(TickerSettingsValidationResult result) {
+      return static_cast<uint8_t>(result);
     }
-    return static_cast<uint8_t>(TickerSettingsValidationResult::OK);
-  }
-#pragma clang diagnostic pop
 
-  void TickerSettings::saveValuesToDocument(JsonDocument& doc) {
-    doc["apcaApiKeyId"] = this->apcaApiKeyId;
-    doc["apcaApiSecretKey"] = this->apcaApiSecretKey;
-    doc["symbols"] = this->symbols;
-    doc["sourceFeed"] = this->sourceFeed;
-    doc["requestPeriod"] = this->requestPeriod;
-    doc["scrollPeriod"] = this->scrollPeriod;
-    doc["displayBrightness"] = this->displayBrightness;
-  }
+    constexpr FieldDescriptor TICKER_SETTINGS_FIELDS[] = {
+      stringField("apcaApiKeyId", offsetof(TickerSettingsValues, apcaApiKeyId),
+                  APCA_API_KEY_ID_MAX_LEN, 1, nullptr,
+                  error(TickerSettingsValidationResult::
+                          ERROR_INVALID_APCA_API_KEY_ID)),
+      stringField("apcaApiSecretKey",
+                  offsetof(TickerSettingsValues, apcaApiSecretKey),
+                  APCA_API_SECRET_KEY_MAX_LEN, 1, nullptr,
+                  error(TickerSettingsValidationResult::
+                          ERROR_INVALID_APCA_API_SECRET_KEY)),
+      stringField("symbols", offsetof(TickerSettingsValues, symbols),
+                  SYMBOLS_STRING_MAX_LEN, 1, nullptr,
+                  error(TickerSettingsValidationResult::ERROR_INVALID_SYMBOLS),
+                  nullptr, 0, isValidSymbols),
+      stringField(
+        "sourceFeed", offsetof(TickerSettingsValues, sourceFeed),
+        SOURCE_FEED_MAX_LEN, 1, "iex",
+        error(TickerSettingsValidationResult::ERROR_INVALID_SOURCE_FEED),
+        SOURCE_FEEDS, sizeof(SOURCE_FEEDS) / sizeof(SOURCE_FEEDS[0])),
+      // Seconds
+      numberField<uint32_t>(
+        "requestPeriod", offsetof(TickerSettingsValues, requestPeriod), 1,
+        UINT32_MAX, 60,
+        error(TickerSettingsValidationResult::ERROR_INVALID_REQUEST_PERIOD)),
+      // Milliseconds
+      numberField<uint16_t>(
+        "scrollPeriod", offsetof(TickerSettingsValues, scrollPeriod), 1,
+        UINT16_MAX, 30,
+        error(TickerSettingsValidationResult::ERROR_INVALID_SCROLL_PERIOD)),
+      numberField<uint8_t>(
+        "displayBrightness", offsetof(TickerSettingsValues, displayBrightness),
+        1, 15, 7,
+        error(
+          TickerSettingsValidationResult::ERROR_INVALID_DISPLAY_BRIGHTNESS)),
+      numberField<uint8_t>(
+        "matrixModulesCount",
+        offsetof(TickerSettingsValues, matrixModulesCount), 1,
+        MAX_MATRIX_MODULES_COUNT, 4,
+        error(
+          TickerSettingsValidationResult::ERROR_INVALID_MATRIX_MODULES_COUNT)),
+      boolField("showSparklines", offsetof(TickerSettingsValues, showSparklines),
+                false),
+      // Milliseconds
+      numberField<uint16_t>(
+        "connectTimeout", offsetof(TickerSettingsValues, connectTimeout), 100,
+        60000, 5000,
+        error(TickerSettingsValidationResult::ERROR_INVALID_CONNECT_TIMEOUT)),
+      // Milliseconds
+      numberField<uint16_t>(
+        "firstByteTimeout", offsetof(TickerSettingsValues, firstByteTimeout),
+        100, 60000, 5000,
+        error(
+          TickerSettingsValidationResult::ERROR_INVALID_FIRST_BYTE_TIMEOUT)),
+      // Milliseconds
+      numberField<uint32_t>(
+        "pollTimeout", offsetof(TickerSettingsValues, pollTimeout), 1000,
+        600000, 15000,
+        error(TickerSettingsValidationResult::ERROR_INVALID_POLL_TIMEOUT)),
+      stringField(
+        "cryptoLocation", offsetof(TickerSettingsValues, cryptoLocation),
+        CRYPTO_LOCATION_MAX_LEN, 1, "us",
+        error(TickerSettingsValidationResult::ERROR_INVALID_CRYPTO_LOCATION),
+        CRYPTO_LOCATIONS,
+        sizeof(CRYPTO_LOCATIONS) / sizeof(CRYPTO_LOCATIONS[0])),
+      // Seconds
+      numberField<uint32_t>(
+        "cryptoRequestPeriod",
+        offsetof(TickerSettingsValues, cryptoRequestPeriod), 1, UINT32_MAX, 60,
+        error(TickerSettingsValidationResult::
+                ERROR_INVALID_CRYPTO_REQUEST_PERIOD)),
+      // Seconds
+      numberField<uint32_t>(
+        "fastRequestPeriod", offsetof(TickerSettingsValues, fastRequestPeriod),
+        1, UINT32_MAX, 15,
+        error(
+          TickerSettingsValidationResult::ERROR_INVALID_FAST_REQUEST_PERIOD)),
+      // Seconds
+      numberField<uint32_t>(
+        "slowRequestPeriod", offsetof(TickerSettingsValues, slowRequestPeriod),
+        1, UINT32_MAX, 300,
+        error(
+          TickerSettingsValidationResult::ERROR_INVALID_SLOW_REQUEST_PERIOD)),
+      stringField(
+        "logLevel", offsetof(TickerSettingsValues, logLevel), LOG_LEVEL_MAX_LEN,
+        1, "info",
+        error(TickerSettingsValidationResult::ERROR_INVALID_LOG_LEVEL),
+        LOG_LEVELS, sizeof(LOG_LEVELS) / sizeof(LOG_LEVELS[0])),
+    };
+
+    constexpr SettingsSchema TICKER_SETTINGS_SCHEMA =
+      makeSchema<TickerSettingsValues>(TICKER_SETTINGS_FIELDS);
+  } // namespace
 
-  void TickerSettings::loadValuesFromDocument(const JsonDocument& doc) {
-    strncpy(this->apcaApiKeyId, doc["apcaApiKeyId"].as<const char*>(),
-            APCA_API_KEY_ID_MAX_LEN);
-    strncpy(this->apcaApiSecretKey, doc["apcaApiSecretKey"].as<const char*>(),
-            APCA_API_SECRET_KEY_MAX_LEN);
-    strncpy(this->symbols, doc["symbols"].as<const char*>(),
-            SYMBOLS_STRING_MAX_LEN);
-    strncpy(this->sourceFeed, doc["sourceFeed"].as<const char*>(),
-            SOURCE_FEED_MAX_LEN);
-    this->requestPeriod = doc["requestPeriod"] | 60; // Default to 60 seconds
-    this->scrollPeriod = doc["scrollPeriod"] | 30;   // Default to 30 ms
-    this->displayBrightness = doc["displayBrightness"] | 7; // Default to 7
+  const SettingsSchema& TickerSettings::getSchema() const {
+    return TICKER_SETTINGS_SCHEMA;
   }
 } // Settings
@@ -15,6 +15,10 @@ namespace Settings {
   const size_t SYMBOLS_STRING_MAX_LEN = 256;
   const uint16_t MAX_SYMBOLS_COUNT = 32;
   const size_t SOURCE_FEED_MAX_LEN = 16;
+  const size_t CRYPTO_LOCATION_MAX_LEN = 8;
+  const size_t LOG_LEVEL_MAX_LEN = 8;
+  // Matches MAX_FRAMEBUFFER_COLUMNS in MD_MAX72xx_Framebuffer.h
+  const uint8_t MAX_MATRIX_MODULES_COUNT = 8;
 
   enum class TickerSettingsValidationResult {
     OK = 0,
@@ -24,21 +28,20 @@ namespace Settings {
     ERROR_INVALID_SOURCE_FEED = 4,
     ERROR_INVALID_REQUEST_PERIOD = 5,
     ERROR_INVALID_SCROLL_PERIOD = 6,
-    ERROR_INVALID_DISPLAY_BRIGHTNESS = 7
+    ERROR_INVALID_DISPLAY_BRIGHTNESS = 7,
+    ERROR_INVALID_MATRIX_MODULES_COUNT = 8,
+    ERROR_INVALID_CONNECT_TIMEOUT = 9,
+    ERROR_INVALID_FIRST_BYTE_TIMEOUT = 10,
+    ERROR_INVALID_POLL_TIMEOUT = 11,
+    ERROR_INVALID_CRYPTO_LOCATION = 12,
+    ERROR_INVALID_CRYPTO_REQUEST_PERIOD = 13,
+    ERROR_INVALID_FAST_REQUEST_PERIOD = 14,
+    ERROR_INVALID_SLOW_REQUEST_PERIOD = 15,
+    ERROR_INVALID_LOG_LEVEL = 16
   };
 
-  class TickerSettings : public BaseSettings {
-    public:
-      TickerSettings() = default;
-      ~TickerSettings() = default;
-
-      /**
-       * @brief Validate a JSON document containing Stock Ticker settings.
-       *
-       * @return 0 on success, nonzero otherwise.
-       */
-      uint8_t validateSettings(JsonDocument& doc) override;
-
+  // Standard layout so the schema can use offsetof()
+  struct TickerSettingsValues {
       /**
        * @brief Alpaca Markets API key ID. Required.
        */
@@ -49,6 +52,11 @@ namespace Settings {
       char apcaApiSecretKey[APCA_API_SECRET_KEY_MAX_LEN] = "";
       /**
        * @brief Comma-separated list of symbols to subscribe to. Required.
+       *
+       * Crypto pairs are written with a slash, like "BTC/USD", and can be
+       * mixed in with stocks. Each symbol can end with how often to refresh
+       * it, ":fast", ":normal" or ":slow", like "AAPL:fast,KO:slow". Symbols
+       * without one are normal.
        */
       char symbols[SYMBOLS_STRING_MAX_LEN] = "";
       /**
@@ -59,9 +67,9 @@ namespace Settings {
        */
       char sourceFeed[SOURCE_FEED_MAX_LEN] = "iex";
       /**
-       * @brief Request period in seconds. (how long to wait between each
-       *  request to the Alpaca Markets API) Must be a natural number. Defaults
-       *  to 60. (seconds)
+       * @brief Request period in seconds for normal stocks. (how long to wait
+       *  between each request to the Alpaca Markets API) Must be a natural
+       *  number. Defaults to 60. (seconds)
        *
        * Free account has 200 requests / min so in theory 0.3 seconds is the
        * minimum, but 1 second is plenty fast for anyone using this.
@@ -78,10 +86,88 @@ namespace Settings {
        *  number between 1 and 15. Defaults to 7.
        */
       uint8_t displayBrightness = 7;
+      /**
+       * @brief How many **groups of four** 8x8 MAX7219 modules are connected.
+       *  Must be a natural number between 1 and 8. Defaults to 4.
+       *
+       * 1, 2, 4 and 8 have a faster display flush, other lengths work but use
+       * the generic one.
+       */
+      uint8_t matrixModulesCount = 4;
+      /**
+       * @brief Whether to show a sparkline of recent prices after each
+       *  symbol. Defaults to false.
+       */
+      bool showSparklines = false;
+      /**
+       * @brief How long to wait to connect to the server (including TLS) in
+       *  milliseconds. Must be between 100 and 60000. Defaults to 5000.
+       */
+      uint16_t connectTimeout = 5000;
+      /**
+       * @brief How long to wait for the response to start after sending the
+       *  request in milliseconds. Must be between 100 and 60000. Defaults to
+       *  5000.
+       */
+      uint16_t firstByteTimeout = 5000;
+      /**
+       * @brief Most time a whole poll can take, every request in it from
+       *  connecting to the last byte of the response, in milliseconds. Must be
+       *  between 1000 and 600000. Defaults to 15000.
+       *
+       * Symbols that were fully read when it runs out still get their new
+       * price, the rest (and any batches not yet requested) are marked
+       * stale.
+       */
+      uint32_t pollTimeout = 15000;
+      /**
+       * @brief Which crypto exchanges to get crypto prices from, either "us",
+       *  "us-1" or "eu-1". Defaults to "us".
+       */
+      char cryptoLocation[CRYPTO_LOCATION_MAX_LEN] = "us";
+      /**
+       * @brief Crypto request period in seconds for normal crypto. Must be a
+       *  natural number. Defaults to 60. (seconds)
+       *
+       * Crypto trades around the clock, so it is requested on its own
+       * schedule. When stocks are due at the same time both go in one poll.
+       */
+      uint32_t cryptoRequestPeriod = 60;
+      /**
+       * @brief Request period in seconds for fast symbols, stocks or crypto.
+       *  Must be a natural number. Defaults to 15. (seconds)
+       */
+      uint32_t fastRequestPeriod = 15;
+      /**
+       * @brief Request period in seconds for slow symbols, stocks or crypto.
+       *  Must be a natural number. Defaults to 300. (seconds)
+       *
+       * Symbols due around the same time share a request, so slow symbols
+       * mostly ride along with faster ones instead of adding requests.
+       */
+      uint32_t slowRequestPeriod = 300;
+      /**
+       * @brief Most detailed log lines to send to the serial port, either
+       *  "none", "error", "warn", "info" or "debug". Defaults to "info".
+       *
+       * Lines more detailed than LOG_LEVEL aren't built in at all, so
+       * "debug" only does something if LOG_LEVEL allows it.
+       */
+      char logLevel[LOG_LEVEL_MAX_LEN] = "info";
+  };
+
+  class TickerSettings : public BaseSettings, public TickerSettingsValues {
+    public:
+      TickerSettings() = default;
+      ~TickerSettings() = default;
 
     protected:
-      void saveValuesToDocument(JsonDocument& doc) override;
-      void loadValuesFromDocument(const JsonDocument& doc) override;
+      const SettingsSchema& getSchema() const override;
+
+      uint8_t* getValues() override {
+        return reinterpret_cast<uint8_t*>(
+          static_cast<TickerSettingsValues*>(this));
+      }
 
       const char* getSettingsName() const override {
         return "Ticker";
@@ -18,18 +18,8 @@ namespace Settings {
     ERROR_INVALID_PASSWORD = 2
   };
 
-  class WiFiSettings : public BaseSettings {
-    public:
-      WiFiSettings() = default;
-      ~WiFiSettings() = default;
-
-      /**
-       * @brief Validate a JSON document containing WiFi settings.
-       *
-       * @return 0 on success, nonzero otherwise.
-       */
-      uint8_t validateSettings(JsonDocument& doc) override;
-
+  // Standard layout so the schema can use offsetof()
+  struct WiFiSettingsValues {
       /**
        * @brief WiFi SSID. Required.
        */
@@ -38,10 +28,20 @@ namespace Settings {
        * @brief WiFi password. Required. (but can be empty string)
        */
       char password[MAX_PASSWORD_LENGTH] = "";
+  };
+
+  class WiFiSettings : public BaseSettings, public WiFiSettingsValues {
+    public:
+      WiFiSettings() = default;
+      ~WiFiSettings() = default;
 
     protected:
-      void saveValuesToDocument(JsonDocument& doc) override;
-      void loadValuesFromDocument(const JsonDocument& doc) override;
+      const SettingsSchema& getSchema() const override;
+
+      uint8_t* getValues() override {
+        return reinterpret_cast<uint8_t*>(
+          static_cast<WiFiSettingsValues*>(this));
+      }
 
       const char* getSettingsName() const override {
         return "WiFi";
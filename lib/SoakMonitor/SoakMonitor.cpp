@@ -0,0 +1,106 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#include <SoakMonitor.h>
+#include <malloc.h>
+
+namespace SoakMonitor {
+  /**
+   * @brief Start watching, call before the first update().
+   */
+  void SoakMonitor::begin() {
+    this->started = true;
+    this->lastLoopTime = millis();
+    // The first report is the baseline, after setup() has allocated
+    // everything it keeps
+    this->nextReportTime = this->lastLoopTime;
+  }
+
+  /**
+   * @brief Call once per loop(), measures the time since the last call and
+   *  logs a report when one is due.
+   */
+  void SoakMonitor::update() {
+    if (!this->started) {
+      return;
+    }
+    const uint32_t now = millis();
+    if (now < this->lastLoopTime) {
+      this->wrapCount++;
+      LOG_WARN("millis() wrapped (%lu times)", this->wrapCount);
+    }
+    const uint32_t gap = now - this->lastLoopTime;
+    this->lastLoopTime = now;
+    this->maxLoopGap = max(this->maxLoopGap, gap);
+    this->maxLoopGapEver = max(this->maxLoopGapEver, gap);
+    this->loopCount++;
+
+    if (static_cast<int32_t>(now - this->nextReportTime) >= 0) {
+      this->nextReportTime = now + SOAK_REPORT_PERIOD;
+      this->report();
+    }
+  }
+
+  /**
+   * @brief Measure the heap.
+   *
+   * Finding the largest free block takes a few malloc() and free() calls,
+   * which is fine every few minutes but not every loop.
+   *
+   * @return HeapStats
+   */
+  HeapStats SoakMonitor::getHeapStats() {
+    HeapStats stats = {};
+    stats.freeBytes = rp2040.getFreeHeap();
+    const struct mallinfo info = mallinfo();
+    stats.freeChunks = info.ordblks;
+
+    // Binary search for the biggest allocation that succeeds
+    uint32_t low = 0;
+    uint32_t high = stats.freeBytes;
+    while (low < high) {
+      const uint32_t mid = low + (high - low + 1) / 2;
+      void* block = malloc(mid);
+      if (block != nullptr) {
+        free(block);
+        low = mid;
+      } else {
+        high = mid - 1;
+      }
+    }
+    stats.largestFreeBlock = low;
+    return stats;
+  }
+
+  void SoakMonitor::report() {
+    const HeapStats heap = getHeapStats();
+    if (!this->hasBaseline) {
+      this->hasBaseline = true;
+      this->baseline = heap;
+      this->worst = heap;
+    }
+    this->worst.freeBytes = min(this->worst.freeBytes, heap.freeBytes);
+    this->worst.largestFreeBlock =
+      min(this->worst.largestFreeBlock, heap.largestFreeBlock);
+    this->worst.freeChunks = max(this->worst.freeChunks, heap.freeChunks);
+
+    const uint32_t uptimeMinutes =
+      static_cast<uint32_t>(this->getUptime() / (60 * 1000));
+    LOG_INFO(
+      "Soak: up %lu min, heap free %lu (%+ld since start, worst %lu), largest "
+      "block %lu (%+ld, worst %lu), %lu free chunks (worst %lu)",
+      uptimeMinutes, heap.freeBytes,
+      static_cast<int32_t>(heap.freeBytes - this->baseline.freeBytes),
+      this->worst.freeBytes, heap.largestFreeBlock,
+      static_cast<int32_t>(heap.largestFreeBlock -
+                           this->baseline.largestFreeBlock),
+      this->worst.largestFreeBlock, heap.freeChunks, this->worst.freeChunks);
+    LOG_INFO("Soak: %lu loops, longest loop %lu ms (worst %lu ms), "
+             "millis() wrapped %lu times",
+             this->loopCount, this->maxLoopGap, this->maxLoopGapEver,
+             this->wrapCount);
+    this->maxLoopGap = 0;
+    this->loopCount = 0;
+  }
+} // SoakMonitor
@@ -0,0 +1,75 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_SOAKMONITOR_H
+#define PICO2W_STOCK_TICKER_SOAKMONITOR_H
+
+#include <Arduino.h>
+#include <Log.h>
+
+namespace SoakMonitor {
+  const uint32_t SOAK_REPORT_PERIOD = 10 * 60 * 1000;
+
+  /**
+   * @brief A snapshot of the heap.
+   */
+  struct HeapStats {
+      uint32_t freeBytes;
+      // Biggest single allocation that would succeed right now
+      uint32_t largestFreeBlock;
+      // How many pieces the free memory is in, grows with fragmentation
+      uint32_t freeChunks;
+  };
+
+  /**
+   * @brief Watches for slow problems on a unit that runs for months: heap
+   *  fragmentation creeping up from polling, and the main loop stalling
+   *  (which would also stall every millis() deadline) around a millis()
+   *  wrap.
+   *
+   * Everything is compared against a baseline taken at the first report, and
+   * a summary is logged every SOAK_REPORT_PERIOD.
+   */
+  class SoakMonitor {
+    public:
+      SoakMonitor() = default;
+      ~SoakMonitor() = default;
+
+      void begin();
+      void update();
+
+      static HeapStats getHeapStats();
+
+      /**
+       * @brief Get how long the device has been up, unlike millis() this
+       *  doesn't wrap.
+       *
+       * @return uint64_t Milliseconds.
+       */
+      uint64_t getUptime() const {
+        return (static_cast<uint64_t>(this->wrapCount) << 32) |
+               this->lastLoopTime;
+      }
+
+    protected:
+      bool started = false;
+      uint32_t lastLoopTime = 0;
+      uint32_t wrapCount = 0;
+      uint32_t nextReportTime = 0;
+
+      // Longest time between two update() calls since the last report and
+      // since boot
+      uint32_t maxLoopGap = 0;
+      uint32_t maxLoopGapEver = 0;
+      uint32_t loopCount = 0;
+
+      HeapStats baseline = {};
+      HeapStats worst = {};
+      bool hasBaseline = false;
+
+      void report();
+  };
+} // SoakMonitor
+
+#endif // PICO2W_STOCK_TICKER_SOAKMONITOR_H
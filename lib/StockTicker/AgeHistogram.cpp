@@ -0,0 +1,48 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#include <AgeHistogram.h>
+
+namespace StockTicker {
+  const uint32_t AgeHistogram::BUCKET_LIMITS[AGE_HISTOGRAM_BUCKETS - 1] = {
+    1, 2, 5, 10, 30, 60, 5 * 60, 20 * 60, 60 * 60};
+
+  /**
+   * @brief Count one price's age.
+   *
+   * @param age Seconds from the exchange to the display.
+   */
+  void AgeHistogram::record(uint32_t age) {
+    uint8_t bucket = 0;
+    while (bucket < AGE_HISTOGRAM_BUCKETS - 1 &&
+           age >= BUCKET_LIMITS[bucket]) {
+      bucket++;
+    }
+    if (this->counts[bucket] < UINT16_MAX) {
+      this->counts[bucket]++;
+    }
+  }
+
+  /**
+   * @brief Write the counts of every bucket, like "<1s:0 <2s:4 ... >=3600s:0".
+   *
+   * @param str Where to write them.
+   * @param maxLen The size of str, including the null terminator.
+   * @return size_t The number of characters written, not including the null
+   *  terminator.
+   */
+  size_t AgeHistogram::print(char* str, size_t maxLen) const {
+    size_t len = 0;
+    for (uint8_t i = 0; i < AGE_HISTOGRAM_BUCKETS && len < maxLen; i++) {
+      const int written =
+        i < AGE_HISTOGRAM_BUCKETS - 1
+          ? snprintf(str + len, maxLen - len, "%s<%lus:%u", i > 0 ? " " : "",
+                     BUCKET_LIMITS[i], this->counts[i])
+          : snprintf(str + len, maxLen - len, " >=%lus:%u",
+                     BUCKET_LIMITS[i - 1], this->counts[i]);
+      len = min(len + static_cast<size_t>(max(written, 0)), maxLen - 1);
+    }
+    return len;
+  }
+} // StockTicker
@@ -0,0 +1,53 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_AGEHISTOGRAM_H
+#define PICO2W_STOCK_TICKER_AGEHISTOGRAM_H
+
+#include <Arduino.h>
+
+namespace StockTicker {
+  const uint8_t AGE_HISTOGRAM_BUCKETS = 10;
+
+  /**
+   * @brief Counts how old one symbol's prices were when they made it to the
+   *  display, from the exchange's timestamp to the display string being
+   *  updated.
+   *
+   * Buckets grow roughly 2-3x each so both a live feed (seconds) and a
+   * delayed one (15 minutes) land in buckets of their own. Counts stop at
+   * UINT16_MAX instead of wrapping.
+   */
+  class AgeHistogram {
+    public:
+      void record(uint32_t age);
+      size_t print(char* str, size_t maxLen) const;
+
+      /**
+       * @brief Forget all samples.
+       */
+      void clear() {
+        memset(this->counts, 0, sizeof(this->counts));
+      }
+
+      /**
+       * @brief Get how many samples are in a bucket.
+       *
+       * @param bucket 0 to AGE_HISTOGRAM_BUCKETS - 1.
+       * @return uint16_t
+       */
+      uint16_t getCount(uint8_t bucket) const {
+        return bucket < AGE_HISTOGRAM_BUCKETS ? this->counts[bucket] : 0;
+      }
+
+      // Seconds each bucket but the last is under, the last is everything
+      // older
+      static const uint32_t BUCKET_LIMITS[AGE_HISTOGRAM_BUCKETS - 1];
+
+    protected:
+      uint16_t counts[AGE_HISTOGRAM_BUCKETS] = {};
+  };
+} // StockTicker
+
+#endif // PICO2W_STOCK_TICKER_AGEHISTOGRAM_H
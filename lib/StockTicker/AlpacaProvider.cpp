@@ -0,0 +1,157 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#include <AlpacaProvider.h>
+#include <DeadlineStream.h>
+#include <StockTicker.h>
+
+namespace StockTicker {
+  /**
+   * @brief Initialize with the account and feed to use.
+   *
+   * @param apiKeyId Your Alpaca Markets API key ID.
+   * @param apiSecretKey Your Alpaca Markets API secret key.
+   * @param feed What feed to use. Either "sip", "iex", "delayed_sip", "boats",
+   *  "overnight", or "otc". Only iex or delayed_sip are available with a free
+   *  account. The default is "iex".
+   * @param cryptoLocation Which crypto exchanges to use. Either "us", "us-1"
+   *  or "eu-1". The default is "us".
+   */
+  void AlpacaProvider::begin(const char* apiKeyId, const char* apiSecretKey,
+                             const char* feed /* = "iex" */,
+                             const char* cryptoLocation /* = "us" */) {
+    this->apcaApiKeyId = apiKeyId;
+    this->apcaApiSecretKey = apiSecretKey;
+    this->sourceFeed = feed;
+    this->cryptoLocation = cryptoLocation;
+    this->dnsCache.begin(MARKET_DATA_HOST);
+    this->secureClient.setCache(&this->dnsCache);
+  }
+
+  /**
+   * @brief Look up the market data host ahead of time so it isn't part of the
+   *  request. lwIP keeps the answer for the record's TTL, which is much longer
+   *  than any lead.
+   */
+  void AlpacaProvider::prefetch(uint32_t lead) {
+    if (WiFi.status() != WL_CONNECTED) {
+      return;
+    }
+    if (this->dnsCache.prefetch()) {
+      LOG_DEBUG("Prefetched %s in %lu us", MARKET_DATA_HOST,
+                this->dnsCache.getLastLookupTime());
+    }
+  }
+
+  int32_t AlpacaProvider::sendRequest(const ProviderRequest& request) {
+    this->gzipped = false;
+    if (WiFi.status() != WL_CONNECTED) {
+      return PROVIDER_ERROR_NO_NETWORK;
+    }
+    // https://data.alpaca.markets/v2/stocks/snapshots?symbols={SYMBOLS}&feed={FEED}
+    // https://data.alpaca.markets/v1beta3/crypto/{LOCATION}/snapshots?symbols={SYMBOLS}
+    this->secureClient.setInsecure();
+    // HTTP/1.1 so the connection can be kept open, HttpBodyStream takes care
+    // of chunked bodies
+    this->httpsClient.useHTTP10(false);
+    this->httpsClient.setReuse(true);
+    // Connecting includes the TLS handshake, the read timeout is how long to
+    // wait for the status line once the request is sent
+    this->httpsClient.setConnectTimeout(request.connectTimeout);
+    this->httpsClient.setTimeout(request.firstByteTimeout);
+    // Room for every symbol to be a pair with an escaped slash
+    const size_t MAX_URL_LEN = 80 + MAX_SYMBOLS_STRING_LEN * 2;
+    char url[MAX_URL_LEN];
+    if (request.assetClass == AssetClass::CRYPTO) {
+      size_t len = snprintf(url, MAX_URL_LEN,
+                            "https://%s/v1beta3/crypto/%s/snapshots?symbols=",
+                            MARKET_DATA_HOST, this->cryptoLocation);
+      for (const char* p = request.symbols; *p != '\0' && len < MAX_URL_LEN - 4;
+           p++) {
+        if (*p == '/') {
+          memcpy(url + len, "%2F", 3);
+          len += 3;
+        } else {
+          url[len++] = *p;
+        }
+      }
+      url[len] = '\0';
+    } else {
+      snprintf(url, MAX_URL_LEN,
+               "https://%s/v2/stocks/snapshots?symbols=%s&feed=%s",
+               MARKET_DATA_HOST, request.symbols, this->sourceFeed);
+    }
+    LOG_DEBUG("Requesting %s", url);
+    // The client looks the host up through dnsCache when it has to connect
+    if (!this->httpsClient.begin(this->secureClient, url)) {
+      return PROVIDER_ERROR_INIT_FAILED;
+    }
+    this->httpsClient.addHeader("Accept", "application/json");
+    #ifdef REQUEST_GZIP
+    this->httpsClient.addHeader("Accept-Encoding", "gzip");
+    #endif
+    const char* responseHeaders[] = {"Content-Encoding", "Transfer-Encoding",
+                                     "Date"};
+    this->httpsClient.collectHeaders(responseHeaders, 3);
+    this->httpsClient.addHeader("Apca-Api-Key-Id", this->apcaApiKeyId);
+    this->httpsClient.addHeader("Apca-Api-Secret-Key", this->apcaApiSecretKey);
+    // Forget a lookup from a request that failed before reading it
+    DNSCacheResult dnsResult;
+    this->secureClient.takeLookup(dnsResult);
+    const int32_t statusCode = this->httpsClient.GET();
+    this->lastDnsTime = 0;
+    if (this->secureClient.takeLookup(dnsResult)) {
+      this->lastDnsTime = this->dnsCache.getLastLookupTime();
+      switch (dnsResult) {
+        case DNSCacheResult::RESOLVED:
+          LOG_DEBUG("DNS: resolved in %lu us", this->lastDnsTime);
+          break;
+        case DNSCacheResult::FALLBACK:
+          LOG_WARN("DNS: lookup failed after %lu us, using last good address",
+                   this->lastDnsTime);
+          break;
+        case DNSCacheResult::FAILED:
+          LOG_WARN("DNS: lookup failed after %lu us", this->lastDnsTime);
+          break;
+      }
+    }
+    if (statusCode > 0) {
+      const uint32_t date =
+        parseHttpDate(this->httpsClient.header("Date").c_str());
+      if (date != 0) {
+        this->serverDate = date;
+        this->serverDateMillis = millis();
+      }
+      this->body.begin(
+        this->httpsClient.getStream(),
+        this->httpsClient.header("Transfer-Encoding") == "chunked",
+        this->httpsClient.getSize());
+    }
+    #ifdef REQUEST_GZIP
+    this->gzipped = statusCode == 200 &&
+                    this->httpsClient.header("Content-Encoding") == "gzip";
+    #endif
+    return statusCode;
+  }
+
+  /**
+   * @brief Read whatever is left of the response so the connection can be
+   *  used for the next request, or close it if that can't be done quickly.
+   */
+  void AlpacaProvider::endRequest() {
+    bool reusable = this->body.isBounded();
+    if (reusable) {
+      DeadlineStream drain(this->body, millis() + DRAIN_TIMEOUT);
+      while (!this->body.isDone() && drain.read() >= 0) {
+      }
+      reusable = this->body.isDone();
+    }
+    if (!reusable) {
+      // Left over bytes would be read as the next response
+      this->httpsClient.setReuse(false);
+    }
+    this->httpsClient.end();
+    this->httpsClient.setReuse(true);
+  }
+} // StockTicker
@@ -0,0 +1,120 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_ALPACAPROVIDER_H
+#define PICO2W_STOCK_TICKER_ALPACAPROVIDER_H
+
+#ifndef REQUEST_GZIP
+  #define REQUEST_GZIP
+#endif
+
+#include <AlpacaSnapshots.h>
+#include <Arduino.h>
+#include <DNSCache.h>
+#include <HTTPClient.h>
+#include <HttpBodyStream.h>
+#include <Log.h>
+#include <MarketDataProvider.h>
+#include <WiFi.h>
+
+namespace StockTicker {
+  const char* const MARKET_DATA_HOST = "data.alpaca.markets";
+
+  // How long to wait for the rest of a response nobody read, so the
+  // connection can be used again
+  const uint32_t DRAIN_TIMEOUT = 500;
+
+  /**
+   * @brief Gets quotes from Alpaca Markets' Market Data API stock and crypto
+   *  snapshots endpoints.
+   *
+   * The connection is kept open between requests, so a poll's stock and
+   * crypto requests go back to back over one TLS session, and the next poll
+   * can use it too if the server hasn't closed it by then.
+   */
+  class AlpacaProvider : public MarketDataProvider {
+    public:
+      AlpacaProvider() = default;
+      ~AlpacaProvider() override = default;
+
+      void begin(const char* apiKeyId, const char* apiSecretKey,
+                 const char* feed = "iex", const char* cryptoLocation = "us");
+
+      const char* getName() const override {
+        return "Alpaca";
+      }
+
+      void prefetch(uint32_t lead) override;
+
+      bool supports(AssetClass assetClass) const override {
+        return true;
+      }
+
+      int32_t sendRequest(const ProviderRequest& request) override;
+
+      Stream& getBody() override {
+        return this->body;
+      }
+
+      bool isBodyGzipped() override {
+        return this->gzipped;
+      }
+
+      int32_t getBodySize() override {
+        // Chunked bodies don't say, count what has come in so far instead
+        const int32_t size = this->httpsClient.getSize();
+        return size >= 0 ? size : static_cast<int32_t>(this->body.getBytesIn());
+      }
+
+      DeserializationError parseBody(Stream& body,
+                                     const ProviderRequest& request,
+                                     QuoteSink& sink) override {
+        return request.assetClass == AssetClass::CRYPTO
+                 ? parseAlpacaCryptoSnapshots(body, request.arena, sink)
+                 : parseAlpacaSnapshots(body, request.arena, sink);
+      }
+
+      StockTickerStatus mapError(int32_t code, uint32_t elapsed,
+                                 const ProviderRequest& request) override {
+        return mapAlpacaError(code, elapsed, request);
+      }
+
+      uint32_t getServerTime() override {
+        return this->serverDate != 0
+                 ? this->serverDate + (millis() - this->serverDateMillis) / 1000
+                 : 0;
+      }
+
+      void endRequest() override;
+
+      /**
+       * @brief Get how long looking up the market data host took in the last
+       *  request, 0 if it reused the open connection.
+       *
+       * @return uint32_t Microseconds.
+       */
+      uint32_t getLastDnsTime() const {
+        return this->lastDnsTime;
+      }
+
+    protected:
+      const char* apcaApiKeyId = nullptr;
+      const char* apcaApiSecretKey = nullptr;
+      const char* sourceFeed = nullptr;
+      const char* cryptoLocation = nullptr;
+
+      HTTPClient httpsClient;
+      DNSCachedClient secureClient;
+      HttpBodyStream body;
+      bool gzipped = false;
+      // Date header of the last response, and millis() when it came
+      uint32_t serverDate = 0;
+      uint32_t serverDateMillis = 0;
+
+      DNSCache dnsCache;
+      uint32_t lastDnsTime = 0;
+  };
+} // StockTicker
+
+#endif // PICO2W_STOCK_TICKER_ALPACAPROVIDER_H
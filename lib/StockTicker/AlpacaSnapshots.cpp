@@ -0,0 +1,310 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#include <AlpacaSnapshots.h>
+#include <StockTicker.h>
+
+namespace StockTicker {
+  namespace {
+    bool isJsonSpace(int c) {
+      return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    /**
+     * @brief Read the next character that isn't whitespace.
+     *
+     * @return int The character, or -1 if the stream ended.
+     */
+    int readNonSpace(Stream& stream) {
+      int c;
+      do {
+        c = stream.read();
+      } while (isJsonSpace(c));
+      return c;
+    }
+
+    /**
+     * @brief Read the rest of a JSON string after its opening quote, escapes
+     *  are kept as the escaped character. A string too long for str is cut.
+     *
+     * @return false if the stream ended first.
+     */
+    bool readString(Stream& stream, char* str, size_t maxLen) {
+      size_t len = 0;
+      while (true) {
+        int c = stream.read();
+        if (c == '\\') {
+          c = stream.read();
+        } else if (c == '"') {
+          break;
+        }
+        if (c < 0) {
+          return false;
+        }
+        if (len < maxLen - 1) {
+          str[len++] = static_cast<char>(c);
+        }
+      }
+      str[len] = '\0';
+      return true;
+    }
+
+    DeserializationError unexpected(int c) {
+      return c < 0 ? DeserializationError::IncompleteInput
+                   : DeserializationError::InvalidInput;
+    }
+
+    /**
+     * @brief Count the days from 1970-01-01 to a date in the proleptic
+     *  Gregorian calendar.
+     */
+    int32_t daysFromCivil(int32_t year, uint32_t month, uint32_t day) {
+      year -= month <= 2;
+      const int32_t era = (year >= 0 ? year : year - 399) / 400;
+      const uint32_t yearOfEra = static_cast<uint32_t>(year - era * 400);
+      const uint32_t dayOfYear =
+        (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+      const uint32_t dayOfEra =
+        yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+      return era * 146097 + static_cast<int32_t>(dayOfEra) - 719468;
+    }
+
+    uint32_t toEpoch(uint32_t year, uint32_t month, uint32_t day,
+                     uint32_t hour, uint32_t minute, uint32_t second) {
+      return static_cast<uint32_t>(daysFromCivil(year, month, day)) * 86400 +
+             hour * 3600 + minute * 60 + second;
+    }
+
+    /**
+     * @brief Parse an RFC 3339 timestamp like "2024-01-02T15:59:59.123Z",
+     *  fractions of a second are dropped.
+     *
+     * @return uint32_t Seconds since 1970 UTC, or 0 if it doesn't parse.
+     */
+    uint32_t parseRfc3339(const char* str) {
+      if (str == nullptr) {
+        return 0;
+      }
+      uint32_t year, month, day, hour, minute, second;
+      int consumed = 0;
+      if (sscanf(str, "%4lu-%2lu-%2luT%2lu:%2lu:%2lu%n", &year, &month, &day,
+                 &hour, &minute, &second, &consumed) != 6) {
+        return 0;
+      }
+      const char* rest = str + consumed;
+      while (*rest == '.' || (*rest >= '0' && *rest <= '9')) {
+        rest++;
+      }
+      int32_t offset = 0;
+      uint32_t offsetHours, offsetMinutes;
+      if ((*rest == '+' || *rest == '-') &&
+          sscanf(rest + 1, "%2lu:%2lu", &offsetHours, &offsetMinutes) == 2) {
+        offset = static_cast<int32_t>(offsetHours * 3600 + offsetMinutes * 60);
+        offset = *rest == '-' ? -offset : offset;
+      }
+      return toEpoch(year, month, day, hour, minute, second) - offset;
+    }
+  } // namespace
+
+  /**
+   * @brief Parse a snapshots response one symbol at a time, each symbol's
+   *  quote goes to the sink as soon as its snapshot is read.
+   *
+   * Only one snapshot is in memory at a time, and if the response is cut off
+   * (like by a deadline) every symbol before that still gets its quote.
+   *
+   * @param body The response body.
+   * @param arena Where each snapshot's document is allocated, rewound after
+   *  each one.
+   * @param sink Where the quotes go.
+   * @return DeserializationError Ok if the whole response was read.
+   */
+  DeserializationError parseAlpacaSnapshots(Stream& body, PollArena* arena,
+                                            QuoteSink& sink) {
+    int c = readNonSpace(body);
+    if (c != '{') {
+      return unexpected(c);
+    }
+    c = readNonSpace(body);
+    while (c != '}') {
+      if (c != '"') {
+        return unexpected(c);
+      }
+      char symbol[MAX_ID_LEN];
+      if (!readString(body, symbol, sizeof(symbol))) {
+        return DeserializationError::IncompleteInput;
+      }
+      c = readNonSpace(body);
+      if (c != ':') {
+        return unexpected(c);
+      }
+      const size_t arenaMark = arena->getUsed();
+      {
+        JsonDocument snapshot(arena);
+        // Stops right after the snapshot's closing brace
+        const DeserializationError error = deserializeJson(snapshot, body);
+        if (error) {
+          return error;
+        }
+        JsonObject daily_bar = snapshot["dailyBar"];
+        float open_price = daily_bar["o"]; // Start of day price
+        float close_price = daily_bar["c"]; // End of day / current price
+        // When the price is from, the daily bar's time is only the start of
+        // its day so the latest trade is better
+        const char* trade_time = snapshot["latestTrade"]["t"];
+        const char* bar_time = daily_bar["t"];
+        sink.addQuote(symbol, close_price, close_price - open_price,
+                      ((close_price - open_price) / open_price) * 100.0f,
+                      parseRfc3339(trade_time != nullptr ? trade_time
+                                                         : bar_time));
+      }
+      arena->rewind(arenaMark);
+      c = readNonSpace(body);
+      if (c == ',') {
+        c = readNonSpace(body);
+      } else if (c != '}') {
+        return unexpected(c);
+      }
+    }
+    return DeserializationError::Ok;
+  }
+
+  /**
+   * @brief Parse a crypto snapshots response, which is a stock snapshots
+   *  response inside a "snapshots" key, one symbol at a time.
+   *
+   * @param body The response body.
+   * @param arena Where each snapshot's document is allocated.
+   * @param sink Where the quotes go.
+   * @return DeserializationError Ok if the whole response was read.
+   */
+  DeserializationError parseAlpacaCryptoSnapshots(Stream& body,
+                                                  PollArena* arena,
+                                                  QuoteSink& sink) {
+    int c = readNonSpace(body);
+    if (c != '{') {
+      return unexpected(c);
+    }
+    c = readNonSpace(body);
+    while (c != '}') {
+      if (c != '"') {
+        return unexpected(c);
+      }
+      char key[16];
+      if (!readString(body, key, sizeof(key))) {
+        return DeserializationError::IncompleteInput;
+      }
+      c = readNonSpace(body);
+      if (c != ':') {
+        return unexpected(c);
+      }
+      if (strcmp(key, "snapshots") == 0) {
+        const DeserializationError error =
+          parseAlpacaSnapshots(body, arena, sink);
+        if (error) {
+          return error;
+        }
+      } else {
+        // Anything else is skipped without being kept
+        const size_t arenaMark = arena->getUsed();
+        {
+          JsonDocument filter(arena);
+          filter.set(false);
+          JsonDocument skipped(arena);
+          const DeserializationError error = deserializeJson(
+            skipped, body, DeserializationOption::Filter(filter));
+          if (error) {
+            return error;
+          }
+        }
+        arena->rewind(arenaMark);
+      }
+      c = readNonSpace(body);
+      if (c == ',') {
+        c = readNonSpace(body);
+      } else if (c != '}') {
+        return unexpected(c);
+      }
+    }
+    return DeserializationError::Ok;
+  }
+
+  /**
+   * @brief Parse an HTTP date like "Tue, 02 Jan 2024 15:59:59 GMT".
+   *
+   * @return uint32_t Seconds since 1970 UTC, or 0 if it doesn't parse.
+   */
+  uint32_t parseHttpDate(const char* str) {
+    static const char MONTHS[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+    char monthName[4];
+    uint32_t year, day, hour, minute, second;
+    if (sscanf(str, "%*3s, %2lu %3s %4lu %2lu:%2lu:%2lu", &day, monthName,
+               &year, &hour, &minute, &second) != 6) {
+      return 0;
+    }
+    const char* found = strstr(MONTHS, monthName);
+    if (found == nullptr || (found - MONTHS) % 3 != 0) {
+      return 0;
+    }
+    return toEpoch(year, (found - MONTHS) / 3 + 1, day, hour, minute,
+                   second);
+  }
+
+  /**
+   * @brief Turn what a request for Alpaca snapshots returned into a status,
+   *  logging what went wrong. Shared by every provider that stands in for
+   *  Alpaca, so they fail the same way.
+   *
+   * @param code An HTTP status code other than 200, or a negative error from
+   *  HTTPClient or MarketDataProvider.
+   * @param elapsed Milliseconds the request took.
+   * @param request The request that failed.
+   * @return StockTickerStatus
+   */
+  StockTickerStatus mapAlpacaError(int32_t code, uint32_t elapsed,
+                                   const ProviderRequest& request) {
+    switch (code) {
+      case PROVIDER_ERROR_NO_NETWORK:
+        LOG_ERROR("No WiFi connection, cannot update stock prices.");
+        return StockTickerStatus::ERROR_NO_WIFI;
+      case PROVIDER_ERROR_INIT_FAILED:
+        LOG_ERROR("Failed to initialize request");
+        return StockTickerStatus::ERROR_INIT_REQUEST_FAILED;
+      case HTTPC_ERROR_CONNECTION_FAILED:
+        if (elapsed >= request.connectTimeout) {
+          LOG_ERROR("Connect deadline of %lu ms expired",
+                    request.connectTimeout);
+          return StockTickerStatus::ERROR_CONNECT_TIMEOUT;
+        }
+        LOG_ERROR("Connection failed, check WiFi connection");
+        return StockTickerStatus::ERROR_CONNECTION_FAILED;
+      case HTTPC_ERROR_SEND_HEADER_FAILED:
+        LOG_ERROR("Failed to send header, check WiFi connection");
+        return StockTickerStatus::ERROR_SEND_HEADER_FAILED;
+      case HTTPC_ERROR_SEND_PAYLOAD_FAILED:
+        LOG_ERROR("Failed to send payload, check WiFi connection");
+        return StockTickerStatus::ERROR_SEND_PAYLOAD_FAILED;
+      case HTTPC_ERROR_READ_TIMEOUT:
+        LOG_ERROR("First byte deadline of %lu ms expired",
+                  request.firstByteTimeout);
+        return StockTickerStatus::ERROR_FIRST_BYTE_TIMEOUT;
+      case 400:
+        LOG_ERROR("Bad request, check API key and secret");
+        return StockTickerStatus::ERROR_BAD_REQUEST;
+      case 403:
+        LOG_ERROR("Forbidden, check API key and secret");
+        return StockTickerStatus::ERROR_FORBIDDEN;
+      case 429:
+        LOG_ERROR("Too many requests, check request period");
+        return StockTickerStatus::ERROR_TOO_MANY_REQUESTS;
+      case 500:
+        LOG_ERROR("Internal server error, check Alpaca Markets' "
+          "Slack or Community Forum and try again later");
+        return StockTickerStatus::ERROR_INTERNAL_SERVER_ERROR;
+      default:
+        LOG_ERROR("Unknown error, status code: %d", code);
+        return StockTickerStatus::ERROR_UNKNOWN;
+    }
+  }
+} // StockTicker
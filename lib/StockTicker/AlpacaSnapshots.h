@@ -0,0 +1,28 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_ALPACASNAPSHOTS_H
+#define PICO2W_STOCK_TICKER_ALPACASNAPSHOTS_H
+
+#include <Arduino.h>
+#include <HTTPClient.h>
+#include <Log.h>
+#include <MarketDataProvider.h>
+
+// Reading Alpaca Markets' snapshots responses and turning its errors into a
+// status, apart from AlpacaProvider so the providers that stand in for it
+// (MockProvider, ReplayProvider) don't bring in the network with it.
+
+namespace StockTicker {
+  DeserializationError parseAlpacaSnapshots(Stream& body, PollArena* arena,
+                                            QuoteSink& sink);
+  DeserializationError parseAlpacaCryptoSnapshots(Stream& body,
+                                                  PollArena* arena,
+                                                  QuoteSink& sink);
+  uint32_t parseHttpDate(const char* str);
+  StockTickerStatus mapAlpacaError(int32_t code, uint32_t elapsed,
+                                   const ProviderRequest& request);
+} // StockTicker
+
+#endif // PICO2W_STOCK_TICKER_ALPACASNAPSHOTS_H
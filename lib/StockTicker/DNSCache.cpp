@@ -0,0 +1,91 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#include <DNSCache.h>
+
+namespace StockTicker {
+  /**
+   * @brief Set which host to look up, forgetting the address from before.
+   *
+   * @param hostname The host, must stay valid while the cache is used.
+   */
+  void DNSCache::begin(const char* hostname) {
+    this->hostname = hostname;
+    this->hasAddress = false;
+    this->lastLookupTime = 0;
+  }
+
+  /**
+   * @brief Look the host up, falling back to the last good address for up to
+   *  DNS_FALLBACK_MAX_AGE if that fails.
+   *
+   * @param address Where to put the address.
+   * @return DNSCacheResult Where the address came from.
+   */
+  DNSCacheResult DNSCache::resolve(IPAddress& address) {
+    if (this->lookup()) {
+      address = this->address;
+      return DNSCacheResult::RESOLVED;
+    }
+    if (!this->hasAddress ||
+        millis() - this->resolvedAt >= DNS_FALLBACK_MAX_AGE) {
+      return DNSCacheResult::FAILED;
+    }
+    address = this->address;
+    return DNSCacheResult::FALLBACK;
+  }
+
+  /**
+   * @brief Look the host up ahead of a request, so lwIP has it when the
+   *  request connects.
+   *
+   * @return true if the lookup worked.
+   */
+  bool DNSCache::prefetch() {
+    return this->lookup();
+  }
+
+  bool DNSCache::lookup() {
+    const uint32_t start = micros();
+    IPAddress resolved;
+    const bool ok =
+      WiFi.hostByName(this->hostname, resolved, DNS_LOOKUP_TIMEOUT) == 1;
+    this->lastLookupTime = micros() - start;
+    if (ok) {
+      this->address = resolved;
+      this->hasAddress = true;
+      this->resolvedAt = millis();
+    } else {
+      LOG_WARN("DNS lookup for %s failed after %lu us", this->hostname,
+               this->lastLookupTime);
+    }
+    return ok;
+  }
+
+  /**
+   * @brief Connect to a host, looking it up through the cache if it is the
+   *  cache's host.
+   *
+   * @return int 1 if connected, 0 if not.
+   */
+  int DNSCachedClient::connect(const char* host, uint16_t port) {
+    if (this->dnsCache == nullptr ||
+        strcmp(host, this->dnsCache->getHostname()) != 0) {
+      return WiFiClientSecure::connect(host, port);
+    }
+    IPAddress address;
+    this->lookupResult = this->dnsCache->resolve(address);
+    this->lookedUp = true;
+    switch (this->lookupResult) {
+      case DNSCacheResult::RESOLVED:
+        // lwIP answers the name from its table now, and it's kept for SNI
+        return WiFiClientSecure::connect(host, port);
+      case DNSCacheResult::FALLBACK:
+        return WiFiClientSecure::connect(address, port);
+      case DNSCacheResult::FAILED:
+        break;
+    }
+    return 0;
+  }
+} // StockTicker
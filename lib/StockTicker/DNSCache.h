@@ -0,0 +1,112 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_DNSCACHE_H
+#define PICO2W_STOCK_TICKER_DNSCACHE_H
+
+#include <Arduino.h>
+#include <Log.h>
+#include <WiFi.h>
+#include <WiFiClientSecure.h>
+
+namespace StockTicker {
+  // How long after the last good lookup its address is still used when
+  // lookups fail. Not a TTL, lwIP keeps the record's own.
+  const uint32_t DNS_FALLBACK_MAX_AGE = 60 * 60 * 1000;
+  const uint32_t DNS_LOOKUP_TIMEOUT = 2000;
+
+  enum class DNSCacheResult {
+    // Looked up, from lwIP's table if the record's TTL hasn't run out
+    RESOLVED,
+    // Lookup failed, using the last address that worked
+    FALLBACK,
+    // Lookup failed and there is nothing to fall back to
+    FAILED
+  };
+
+  /**
+   * @brief Looks up one host and keeps the last address that worked.
+   *
+   * WiFi.hostByName() doesn't give the record's TTL, but lwIP's own table
+   * keeps each answer for it, so every lookup goes through lwIP and only
+   * costs a round trip once the record has expired. Prefetching right before
+   * a request takes that round trip out of the request.
+   */
+  class DNSCache {
+    public:
+      DNSCache() = default;
+      ~DNSCache() = default;
+
+      void begin(const char* hostname);
+      DNSCacheResult resolve(IPAddress& address);
+      bool prefetch();
+
+      const char* getHostname() const {
+        return this->hostname;
+      }
+
+      /**
+       * @brief Get how long the last lookup took.
+       *
+       * @return uint32_t Microseconds.
+       */
+      uint32_t getLastLookupTime() const {
+        return this->lastLookupTime;
+      }
+
+    protected:
+      const char* hostname = nullptr;
+      IPAddress address;
+      // If address has ever been resolved, it stays as the fallback
+      bool hasAddress = false;
+      uint32_t resolvedAt = 0;
+      uint32_t lastLookupTime = 0;
+
+      bool lookup();
+  };
+
+  /**
+   * @brief A TLS client that looks its host up through a DNSCache when it
+   *  connects, so the lookup is timed and a failed one can fall back to the
+   *  last good address.
+   *
+   * Connecting by name keeps the name for SNI. The fallback has to connect
+   * by address, without SNI, since the client can't take both. The Host
+   * header comes from the URL either way.
+   */
+  class DNSCachedClient : public WiFiClientSecure {
+    public:
+      /**
+       * @brief Set the cache to look up its host through, other hosts are
+       *  connected to as usual.
+       */
+      void setCache(DNSCache* dnsCache) {
+        this->dnsCache = dnsCache;
+      }
+
+      using WiFiClientSecure::connect;
+      int connect(const char* host, uint16_t port) override;
+
+      /**
+       * @brief Check if connect() looked the host up since the last call,
+       *  which it doesn't when the open connection is reused.
+       *
+       * @param result Set to how the lookup went, if there was one.
+       * @return true if there was a lookup.
+       */
+      bool takeLookup(DNSCacheResult& result) {
+        result = this->lookupResult;
+        const bool lookedUp = this->lookedUp;
+        this->lookedUp = false;
+        return lookedUp;
+      }
+
+    protected:
+      DNSCache* dnsCache = nullptr;
+      bool lookedUp = false;
+      DNSCacheResult lookupResult = DNSCacheResult::FAILED;
+  };
+} // StockTicker
+
+#endif // PICO2W_STOCK_TICKER_DNSCACHE_H
@@ -0,0 +1,62 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#include <DeadlineStream.h>
+
+namespace StockTicker {
+  /**
+   * @brief Wrap a stream.
+   *
+   * @param source Where the data comes from.
+   * @param deadline The millis() time to stop reading at.
+   */
+  DeadlineStream::DeadlineStream(Stream& source, uint32_t deadline)
+      : source(source), deadline(deadline),
+        stallTimeout(source.getTimeout()) {
+    // read() already waits on the source, don't wait again on top of that
+    this->setTimeout(0);
+  }
+
+  /**
+   * @brief Give the source back its own timeout.
+   */
+  DeadlineStream::~DeadlineStream() {
+    this->source.setTimeout(this->stallTimeout);
+  }
+
+  int DeadlineStream::available() {
+    return this->expired ? 0 : this->source.available();
+  }
+
+  /**
+   * @brief Read a byte, waiting for it until the source's timeout or the
+   *  deadline, whichever is first.
+   *
+   * @return int The byte, or -1 if none came in time.
+   */
+  int DeadlineStream::read() {
+    if (this->expired) {
+      return -1;
+    }
+    const int32_t remaining = static_cast<int32_t>(this->deadline - millis());
+    if (remaining > 0) {
+      this->source.setTimeout(
+        min(static_cast<uint32_t>(remaining), this->stallTimeout));
+      uint8_t c;
+      if (this->source.readBytes(&c, 1) == 1) {
+        return c;
+      }
+      if (static_cast<int32_t>(millis() - this->deadline) < 0) {
+        return -1; // Stalled or closed before the deadline
+      }
+    }
+    this->expired = true;
+    LOG_WARN("Poll deadline expired while reading response");
+    return -1;
+  }
+
+  int DeadlineStream::peek() {
+    return this->expired ? -1 : this->source.peek();
+  }
+} // StockTicker
@@ -0,0 +1,52 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_DEADLINESTREAM_H
+#define PICO2W_STOCK_TICKER_DEADLINESTREAM_H
+
+#include <Arduino.h>
+#include <Log.h>
+
+namespace StockTicker {
+  /**
+   * @brief Stops reading from a stream at a fixed time, so a server sending a
+   *  byte every so often can't keep a read going forever.
+   *
+   * Each read still waits at most the source's own timeout, so a closed
+   * connection ends the read early without counting as the deadline. Put it
+   * right on the connection, under any buffering, so a buffer refilling
+   * can't wait past the deadline either.
+   */
+  class DeadlineStream : public Stream {
+    public:
+      DeadlineStream(Stream& source, uint32_t deadline);
+      ~DeadlineStream();
+
+      int available() override;
+      int read() override;
+      int peek() override;
+
+      size_t write(uint8_t) override {
+        return 0; // Read only
+      }
+
+      /**
+       * @brief Check if a read ran into the deadline.
+       *
+       * @return true if the deadline passed.
+       */
+      bool hasExpired() const {
+        return this->expired;
+      }
+
+    protected:
+      Stream& source;
+      uint32_t deadline;
+      // The source's timeout before it was shortened to fit the deadline
+      uint32_t stallTimeout;
+      bool expired = false;
+  };
+} // StockTicker
+
+#endif // PICO2W_STOCK_TICKER_DEADLINESTREAM_H
@@ -0,0 +1,125 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#include <HttpBodyStream.h>
+
+namespace StockTicker {
+  /**
+   * @brief Start reading a new body, right after the response headers.
+   *
+   * @param source The connection.
+   * @param chunked If the response has "Transfer-Encoding: chunked".
+   * @param size The Content-Length, or -1 if there wasn't one. Ignored if
+   *  chunked.
+   */
+  void HttpBodyStream::begin(Stream& source, bool chunked, int32_t size) {
+    this->source = &source;
+    this->chunked = chunked;
+    this->bounded = chunked || size >= 0;
+    this->chunkRemaining = 0;
+    this->lineLen = 0;
+    this->bytesIn = 0;
+    if (chunked) {
+      this->state = State::SIZE;
+    } else {
+      // Without a length the body goes on until the connection closes
+      this->chunkRemaining = size >= 0 ? size : UINT32_MAX;
+      this->state = size == 0 ? State::DONE : State::DATA;
+    }
+    // For anything wrapping this to wait as long as the connection would
+    this->setTimeout(source.getTimeout());
+  }
+
+  int HttpBodyStream::available() {
+    this->skipFraming();
+    if (this->state != State::DATA) {
+      return 0;
+    }
+    return static_cast<int>(min(
+      static_cast<uint32_t>(max(this->source->available(), 0)),
+      this->chunkRemaining));
+  }
+
+  int HttpBodyStream::read() {
+    this->skipFraming();
+    if (this->state != State::DATA) {
+      return -1;
+    }
+    const int c = this->source->read();
+    if (c < 0) {
+      return -1;
+    }
+    this->bytesIn++;
+    if (this->bounded && --this->chunkRemaining == 0) {
+      this->state = this->chunked ? State::DATA_END : State::DONE;
+    }
+    return c;
+  }
+
+  int HttpBodyStream::peek() {
+    this->skipFraming();
+    return this->state == State::DATA ? this->source->peek() : -1;
+  }
+
+  /**
+   * @brief Consume chunk sizes, line breaks and trailers that have arrived,
+   *  until there is body data to read or nothing more has arrived.
+   */
+  void HttpBodyStream::skipFraming() {
+    while (this->state != State::DATA && this->state != State::DONE &&
+           this->source->available() > 0) {
+      const int c = this->source->read();
+      if (c < 0) {
+        return;
+      }
+      this->bytesIn++;
+      switch (this->state) {
+        case State::SIZE:
+          if (c >= '0' && c <= '9') {
+            this->chunkRemaining = this->chunkRemaining * 16 + (c - '0');
+          } else if (c >= 'a' && c <= 'f') {
+            this->chunkRemaining = this->chunkRemaining * 16 + (c - 'a' + 10);
+          } else if (c >= 'A' && c <= 'F') {
+            this->chunkRemaining = this->chunkRemaining * 16 + (c - 'A' + 10);
+          } else if (c == '\n') {
+            this->endSizeLine();
+          } else if (c != '\r') {
+            this->state = State::EXTENSION;
+          }
+          break;
+        case State::EXTENSION:
+          if (c == '\n') {
+            this->endSizeLine();
+          }
+          break;
+        case State::DATA_END:
+          if (c == '\n') {
+            this->chunkRemaining = 0;
+            this->state = State::SIZE;
+          }
+          break;
+        case State::TRAILER:
+          if (c == '\n') {
+            if (this->lineLen == 0) {
+              this->state = State::DONE;
+            }
+            this->lineLen = 0;
+          } else if (c != '\r') {
+            this->lineLen++;
+          }
+          break;
+        default:
+          break;
+      }
+    }
+  }
+
+  /**
+   * @brief A chunk size line ended, a size of 0 is the last chunk.
+   */
+  void HttpBodyStream::endSizeLine() {
+    this->lineLen = 0;
+    this->state = this->chunkRemaining > 0 ? State::DATA : State::TRAILER;
+  }
+} // StockTicker
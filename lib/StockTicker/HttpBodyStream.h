@@ -0,0 +1,91 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_HTTPBODYSTREAM_H
+#define PICO2W_STOCK_TICKER_HTTPBODYSTREAM_H
+
+#include <Arduino.h>
+
+namespace StockTicker {
+  /**
+   * @brief Reads exactly one HTTP/1.1 response body from a connection, taking
+   *  the chunked transfer encoding off if it has one.
+   *
+   * It stops at the end of the body instead of when the connection closes,
+   * so the connection can be kept open for the next request. Like the
+   * connection, reads don't wait, -1 just means nothing is there yet.
+   */
+  class HttpBodyStream : public Stream {
+    public:
+      HttpBodyStream() = default;
+
+      void begin(Stream& source, bool chunked, int32_t size);
+
+      int available() override;
+      int read() override;
+      int peek() override;
+
+      size_t write(uint8_t) override {
+        return 0; // Read only
+      }
+
+      /**
+       * @brief Check if the whole body has been read.
+       *
+       * @return true if the end of the body was reached.
+       */
+      bool isDone() const {
+        return this->state == State::DONE;
+      }
+
+      /**
+       * @brief Check if the end of the body can be found without the
+       *  connection closing.
+       *
+       * @return true if it has a length or is chunked.
+       */
+      bool isBounded() const {
+        return this->bounded;
+      }
+
+      /**
+       * @brief Get how many bytes have been taken from the connection,
+       *  including chunk framing.
+       *
+       * @return uint32_t
+       */
+      uint32_t getBytesIn() const {
+        return this->bytesIn;
+      }
+
+    protected:
+      enum class State {
+        // Chunk size line
+        SIZE,
+        // Chunk extension after the size, ignored
+        EXTENSION,
+        // Body bytes, chunkRemaining of them left
+        DATA,
+        // Line break after a chunk's data
+        DATA_END,
+        // Trailer lines after the last chunk, up to an empty line
+        TRAILER,
+        DONE
+      };
+
+      Stream* source = nullptr;
+      State state = State::DONE;
+      bool chunked = false;
+      bool bounded = false;
+      uint32_t chunkRemaining = 0;
+      // Characters on the current trailer line
+      uint16_t lineLen = 0;
+      uint32_t bytesIn = 0;
+
+      void skipFraming();
+      void endSizeLine();
+  };
+} // StockTicker
+
+#endif // PICO2W_STOCK_TICKER_HTTPBODYSTREAM_H
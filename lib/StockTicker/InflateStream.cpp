@@ -0,0 +1,428 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#include <InflateStream.h>
+
+namespace StockTicker {
+  namespace {
+    // Only one InflateStream is used at a time, and 32 KB is too much for the
+    // stack
+    uint8_t window[INFLATE_WINDOW_SIZE];
+
+    const uint8_t GZIP_FLAG_HEADER_CRC = 0x02;
+    const uint8_t GZIP_FLAG_EXTRA = 0x04;
+    const uint8_t GZIP_FLAG_NAME = 0x08;
+    const uint8_t GZIP_FLAG_COMMENT = 0x10;
+
+    // RFC 1951 3.2.5
+    const uint16_t LENGTH_BASES[29] = {3,  4,  5,  6,   7,   8,   9,   10,
+                                       11, 13, 15, 17,  19,  23,  27,  31,
+                                       35, 43, 51, 59,  67,  83,  99,  115,
+                                       131, 163, 195, 227, 258};
+    const uint8_t LENGTH_EXTRA_BITS[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1,
+                                           1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+                                           4, 4, 4, 4, 5, 5, 5, 5, 0};
+    const uint16_t DISTANCE_BASES[30] = {
+      1,    2,    3,    4,    5,    7,     9,     13,    17,  25,
+      33,   49,   65,   97,   129,  193,   257,   385,   513, 769,
+      1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+    const uint8_t DISTANCE_EXTRA_BITS[30] = {0, 0, 0, 0, 1, 1, 2,  2,  3,  3,
+                                             4, 4, 5, 5, 6, 6, 7,  7,  8,  8,
+                                             9, 9, 10, 10, 11, 11, 12, 12, 13,
+                                             13};
+    // RFC 1951 3.2.7
+    const uint8_t CODE_LENGTH_ORDER[19] = {16, 17, 18, 0, 8,  7, 9,  6, 10, 5,
+                                           11, 4,  12, 3, 13, 2, 14, 1, 15};
+  } // namespace
+
+  InflateStream::HuffmanTree InflateStream::literalTree;
+  InflateStream::HuffmanTree InflateStream::distanceTree;
+
+  /**
+   * @brief Wrap a stream of gzip data.
+   *
+   * @param source Where the compressed data comes from, its timeout is used
+   *  while waiting for more.
+   */
+  InflateStream::InflateStream(Stream& source) : source(source) {
+    // read() already waits on the source, don't wait again on top of that
+    this->setTimeout(0);
+  }
+
+  int InflateStream::available() {
+    if (this->peeked >= 0) {
+      return 1;
+    }
+    return this->state == State::DONE || this->state == State::FAILED ? 0 : 1;
+  }
+
+  int InflateStream::read() {
+    if (this->peeked >= 0) {
+      const int c = this->peeked;
+      this->peeked = -1;
+      return c;
+    }
+    return this->nextByte();
+  }
+
+  int InflateStream::peek() {
+    if (this->peeked < 0) {
+      this->peeked = static_cast<int16_t>(this->nextByte());
+    }
+    return this->peeked;
+  }
+
+  /**
+   * @brief Read whatever is left after the parser stopped, up to and
+   *  including the trailer, to check it.
+   *
+   * @return true if everything decompressed and matched the trailer.
+   */
+  bool InflateStream::finish() {
+    this->peeked = -1;
+    while (this->nextByte() >= 0) {}
+    return this->state == State::DONE;
+  }
+
+  /**
+   * @brief Decompress the next byte.
+   *
+   * @return int The byte, or -1 at the end of the stream or on an error.
+   */
+  int InflateStream::nextByte() {
+    while (true) {
+      switch (this->state) {
+        case State::GZIP_HEADER:
+          this->state =
+            this->readGzipHeader() ? State::BLOCK_HEADER : State::FAILED;
+          break;
+        case State::BLOCK_HEADER:
+          if (this->finalBlock) {
+            this->state = State::GZIP_TRAILER;
+          } else if (!this->readBlockHeader()) {
+            this->state = State::FAILED;
+          }
+          break;
+        case State::STORED_BLOCK: {
+          if (this->storedRemaining == 0) {
+            this->state = State::BLOCK_HEADER;
+            break;
+          }
+          const uint8_t b = this->getBits(8);
+          if (this->inputFailed) {
+            this->state = State::FAILED;
+            break;
+          }
+          this->storedRemaining--;
+          return this->emit(b);
+        }
+        case State::HUFFMAN_BLOCK: {
+          if (this->copyRemaining > 0) {
+            this->copyRemaining--;
+            return this->emit(
+              window[(this->windowPos - this->copyDistance) &
+                     (INFLATE_WINDOW_SIZE - 1)]);
+          }
+          const int16_t symbol = this->decodeSymbol(this->literalTree);
+          if (symbol < 0 || this->inputFailed) {
+            this->state = State::FAILED;
+            break;
+          }
+          if (symbol < 256) {
+            return this->emit(static_cast<uint8_t>(symbol));
+          }
+          if (symbol == 256) {
+            this->state = State::BLOCK_HEADER; // End of block
+            break;
+          }
+          const uint16_t lengthCode = symbol - 257;
+          if (lengthCode >= 29) {
+            this->state = State::FAILED;
+            break;
+          }
+          const uint16_t length = LENGTH_BASES[lengthCode] +
+                                  this->getBits(LENGTH_EXTRA_BITS[lengthCode]);
+          const int16_t distanceCode = this->decodeSymbol(this->distanceTree);
+          if (distanceCode < 0 || distanceCode >= 30) {
+            this->state = State::FAILED;
+            break;
+          }
+          const uint16_t distance =
+            DISTANCE_BASES[distanceCode] +
+            this->getBits(DISTANCE_EXTRA_BITS[distanceCode]);
+          if (this->inputFailed || distance > this->bytesOut) {
+            this->state = State::FAILED; // Refers to before the start
+            break;
+          }
+          this->copyRemaining = length;
+          this->copyDistance = distance;
+          break;
+        }
+        case State::GZIP_TRAILER:
+          this->state =
+            this->readGzipTrailer() ? State::DONE : State::FAILED;
+          break;
+        case State::DONE:
+          return -1;
+        case State::FAILED:
+          return -1;
+      }
+    }
+  }
+
+  uint8_t InflateStream::emit(uint8_t b) {
+    window[this->windowPos] = b;
+    this->windowPos = (this->windowPos + 1) & (INFLATE_WINDOW_SIZE - 1);
+    this->bytesOut++;
+    this->crc = Checksum::crc32(&b, 1, this->crc);
+    return b;
+  }
+
+  /**
+   * @brief Get the next compressed byte, refilling the input buffer with as
+   *  much as is already available.
+   *
+   * @return int The byte, or -1 if the source ended or timed out.
+   */
+  int InflateStream::nextInputByte() {
+    if (this->inputPos == this->inputLen) {
+      const int available = this->source.available();
+      // Wait for at least one byte, but not more than is there
+      const size_t wanted = constrain(available, 1,
+                                      static_cast<int>(sizeof(this->input)));
+      this->inputLen = this->source.readBytes(this->input, wanted);
+      this->inputPos = 0;
+      if (this->inputLen == 0) {
+        this->inputFailed = true;
+        return -1;
+      }
+      this->bytesIn += this->inputLen;
+    }
+    return this->input[this->inputPos++];
+  }
+
+  /**
+   * @brief Read bits least significant first, sets inputFailed and returns 0
+   *  if the input ran out.
+   */
+  uint32_t InflateStream::getBits(uint8_t count) {
+    while (this->bitCount < count) {
+      const int b = this->nextInputByte();
+      if (b < 0) {
+        return 0;
+      }
+      this->bitBuffer |= static_cast<uint32_t>(b) << this->bitCount;
+      this->bitCount += 8;
+    }
+    const uint32_t bits = this->bitBuffer & ((1UL << count) - 1);
+    this->bitBuffer >>= count;
+    this->bitCount -= count;
+    return bits;
+  }
+
+  /**
+   * @brief Decode one symbol a bit at a time.
+   *
+   * @return int16_t The symbol, or -1 if the code is invalid.
+   */
+  int16_t InflateStream::decodeSymbol(const HuffmanTree& tree) {
+    int32_t sum = 0;
+    int32_t code = 0;
+    uint8_t length = 0;
+    do {
+      code = 2 * code + static_cast<int32_t>(this->getBits(1));
+      if (++length == 16 || this->inputFailed) {
+        return -1;
+      }
+      sum += tree.counts[length];
+      code -= tree.counts[length];
+    } while (code >= 0);
+    return static_cast<int16_t>(tree.symbols[sum + code]);
+  }
+
+  bool InflateStream::readGzipHeader() {
+    const uint8_t id1 = this->getBits(8);
+    const uint8_t id2 = this->getBits(8);
+    const uint8_t method = this->getBits(8);
+    const uint8_t flags = this->getBits(8);
+    if (this->inputFailed || id1 != 0x1F || id2 != 0x8B || method != 8) {
+      LOG_ERROR("Response is not gzip");
+      return false;
+    }
+    this->getBits(16); // Modification time
+    this->getBits(16);
+    this->getBits(8); // Extra flags
+    this->getBits(8); // OS
+    if (flags & GZIP_FLAG_EXTRA) {
+      uint16_t extraLength = this->getBits(16);
+      while (extraLength-- > 0 && !this->inputFailed) {
+        this->getBits(8);
+      }
+    }
+    if (flags & GZIP_FLAG_NAME) {
+      while (this->getBits(8) != 0 && !this->inputFailed) {}
+    }
+    if (flags & GZIP_FLAG_COMMENT) {
+      while (this->getBits(8) != 0 && !this->inputFailed) {}
+    }
+    if (flags & GZIP_FLAG_HEADER_CRC) {
+      this->getBits(16);
+    }
+    return !this->inputFailed;
+  }
+
+  bool InflateStream::readGzipTrailer() {
+    // The trailer starts on a byte boundary
+    this->getBits(this->bitCount % 8);
+    // Little endian, low half first
+    uint32_t crc = this->getBits(16);
+    crc |= this->getBits(16) << 16;
+    uint32_t size = this->getBits(16);
+    size |= this->getBits(16) << 16;
+    if (this->inputFailed) {
+      return false;
+    }
+    // The size is modulo 2^32, like bytesOut
+    if (crc != this->crc || size != this->bytesOut) {
+      LOG_ERROR("Response doesn't match its gzip trailer (CRC %08lx, %lu "
+                "bytes instead of %08lx, %lu bytes)",
+                this->crc, this->bytesOut, crc, size);
+      return false;
+    }
+    return true;
+  }
+
+  bool InflateStream::readBlockHeader() {
+    this->finalBlock = this->getBits(1);
+    const uint8_t type = this->getBits(2);
+    if (this->inputFailed) {
+      return false;
+    }
+    switch (type) {
+      case 0: {
+        // Stored blocks start on a byte boundary
+        this->getBits(this->bitCount % 8);
+        const uint16_t length = this->getBits(16);
+        const uint16_t inverseLength = this->getBits(16);
+        if (this->inputFailed || length != static_cast<uint16_t>(~inverseLength)) {
+          return false;
+        }
+        this->storedRemaining = length;
+        this->state = State::STORED_BLOCK;
+        return true;
+      }
+      case 1:
+        this->buildFixedTrees();
+        this->state = State::HUFFMAN_BLOCK;
+        return true;
+      case 2:
+        if (!this->readDynamicTrees()) {
+          return false;
+        }
+        this->state = State::HUFFMAN_BLOCK;
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  void InflateStream::buildFixedTrees() {
+    uint8_t lengths[288];
+    memset(lengths, 8, 144);
+    memset(lengths + 144, 9, 256 - 144);
+    memset(lengths + 256, 7, 280 - 256);
+    memset(lengths + 280, 8, 288 - 280);
+    buildTree(this->literalTree, lengths, 288);
+    memset(lengths, 5, 30);
+    buildTree(this->distanceTree, lengths, 30);
+  }
+
+  bool InflateStream::readDynamicTrees() {
+    const uint16_t literalCount = this->getBits(5) + 257;
+    const uint8_t distanceCount = this->getBits(5) + 1;
+    const uint8_t codeLengthCount = this->getBits(4) + 4;
+    if (this->inputFailed || literalCount > 286 || distanceCount > 30) {
+      return false;
+    }
+
+    uint8_t lengths[288 + 32] = {0};
+    for (uint8_t i = 0; i < codeLengthCount; i++) {
+      lengths[CODE_LENGTH_ORDER[i]] = this->getBits(3);
+    }
+    // The code length code only lives until the real trees are built, so
+    // borrow the distance tree for it
+    if (!buildTree(this->distanceTree, lengths, 19)) {
+      return false;
+    }
+
+    memset(lengths, 0, 19);
+    uint16_t i = 0;
+    while (i < literalCount + distanceCount) {
+      const int16_t symbol = this->decodeSymbol(this->distanceTree);
+      if (symbol < 0 || this->inputFailed) {
+        return false;
+      }
+      uint8_t repeatLength = 0;
+      uint8_t repeatCount;
+      if (symbol < 16) {
+        lengths[i++] = symbol;
+        continue;
+      } else if (symbol == 16) {
+        if (i == 0) {
+          return false; // Nothing to repeat
+        }
+        repeatLength = lengths[i - 1];
+        repeatCount = 3 + this->getBits(2);
+      } else if (symbol == 17) {
+        repeatCount = 3 + this->getBits(3);
+      } else {
+        repeatCount = 11 + this->getBits(7);
+      }
+      if (i + repeatCount > literalCount + distanceCount) {
+        return false;
+      }
+      memset(lengths + i, repeatLength, repeatCount);
+      i += repeatCount;
+    }
+    if (lengths[256] == 0) {
+      return false; // No end of block code
+    }
+    return buildTree(this->literalTree, lengths, literalCount) &&
+           buildTree(this->distanceTree, lengths + literalCount, distanceCount);
+  }
+
+  /**
+   * @brief Build a canonical Huffman tree from code lengths.
+   *
+   * @return false if the lengths describe more codes than can exist.
+   */
+  bool InflateStream::buildTree(HuffmanTree& tree, const uint8_t* lengths,
+                                uint16_t count) {
+    memset(tree.counts, 0, sizeof(tree.counts));
+    for (uint16_t i = 0; i < count; i++) {
+      tree.counts[lengths[i]]++;
+    }
+    tree.counts[0] = 0;
+
+    int32_t left = 1;
+    uint16_t offsets[16];
+    uint16_t total = 0;
+    for (uint8_t length = 0; length < 16; length++) {
+      if (length > 0) {
+        left = left * 2 - tree.counts[length];
+        if (left < 0) {
+          return false; // Over-subscribed
+        }
+      }
+      offsets[length] = total;
+      total += tree.counts[length];
+    }
+    for (uint16_t i = 0; i < count; i++) {
+      if (lengths[i] != 0) {
+        tree.symbols[offsets[lengths[i]]++] = i;
+      }
+    }
+    return true;
+  }
+} // StockTicker
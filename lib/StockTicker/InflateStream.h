@@ -0,0 +1,130 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_INFLATESTREAM_H
+#define PICO2W_STOCK_TICKER_INFLATESTREAM_H
+
+#include <Arduino.h>
+#include <Checksum.h>
+#include <Log.h>
+
+namespace StockTicker {
+  // Deflate can refer back up to 32 KB and gzip doesn't say if the encoder
+  // used less, so the window can't be any smaller
+  const uint8_t INFLATE_WINDOW_BITS = 15;
+  const size_t INFLATE_WINDOW_SIZE = 1 << INFLATE_WINDOW_BITS;
+  const size_t INFLATE_INPUT_BUFFER_SIZE = 64;
+
+  /**
+   * @brief Decompresses a gzip stream one byte at a time as it is read, so a
+   *  compressed response can be parsed without buffering it.
+   *
+   * Only one can be used at a time since they share a static window and
+   * Huffman trees. The CRC of what was decompressed and its size are checked
+   * against the trailer at the end, the stream fails if they don't match.
+   * The JSON parser stops before the trailer, call finish() after it.
+   */
+  class InflateStream : public Stream {
+    public:
+      explicit InflateStream(Stream& source);
+
+      int available() override;
+      int read() override;
+      int peek() override;
+      bool finish();
+
+      size_t write(uint8_t) override {
+        return 0; // Read only
+      }
+
+      /**
+       * @brief Get how many compressed bytes were read from the source.
+       *
+       * @return uint32_t
+       */
+      uint32_t getBytesIn() const {
+        return this->bytesIn;
+      }
+
+      /**
+       * @brief Get how many bytes were decompressed.
+       *
+       * @return uint32_t
+       */
+      uint32_t getBytesOut() const {
+        return this->bytesOut;
+      }
+
+      /**
+       * @brief Check if the stream was corrupted or ended early.
+       *
+       * @return true if decompression failed.
+       */
+      bool hasFailed() const {
+        return this->state == State::FAILED;
+      }
+
+    protected:
+      enum class State {
+        GZIP_HEADER,
+        BLOCK_HEADER,
+        STORED_BLOCK,
+        HUFFMAN_BLOCK,
+        GZIP_TRAILER,
+        DONE,
+        FAILED
+      };
+
+      // Canonical Huffman code as counts of codes of each length and the
+      // symbols sorted by code
+      // clang-format off
+      struct HuffmanTree {
+          uint16_t counts[16];
+          uint16_t symbols[288];
+      };
+      // clang-format on
+
+      Stream& source;
+      State state = State::GZIP_HEADER;
+
+      uint8_t input[INFLATE_INPUT_BUFFER_SIZE];
+      uint8_t inputPos = 0;
+      uint8_t inputLen = 0;
+      uint32_t bitBuffer = 0;
+      uint8_t bitCount = 0;
+      bool inputFailed = false;
+
+      bool finalBlock = false;
+      uint16_t storedRemaining = 0;
+      uint16_t copyRemaining = 0;
+      uint16_t copyDistance = 0;
+      // Shared like the window so an instance is small enough for the stack
+      static HuffmanTree literalTree;
+      static HuffmanTree distanceTree;
+
+      uint16_t windowPos = 0;
+      int16_t peeked = -1;
+      uint32_t bytesIn = 0;
+      uint32_t bytesOut = 0;
+      // Of everything emitted so far, for the trailer
+      uint32_t crc = 0;
+
+      int nextByte();
+      uint8_t emit(uint8_t b);
+
+      int nextInputByte();
+      uint32_t getBits(uint8_t count);
+      int16_t decodeSymbol(const HuffmanTree& tree);
+
+      bool readGzipHeader();
+      bool readGzipTrailer();
+      bool readBlockHeader();
+      bool readDynamicTrees();
+      void buildFixedTrees();
+      static bool buildTree(HuffmanTree& tree, const uint8_t* lengths,
+                            uint16_t count);
+  };
+} // StockTicker
+
+#endif // PICO2W_STOCK_TICKER_INFLATESTREAM_H
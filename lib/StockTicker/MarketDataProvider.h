@@ -0,0 +1,208 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_MARKETDATAPROVIDER_H
+#define PICO2W_STOCK_TICKER_MARKETDATAPROVIDER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <PollArena.h>
+
+namespace StockTicker {
+  // Returned by MarketDataProvider::sendRequest() when there is no network to
+  // send it on, HTTPClient's own errors are -1 to -11
+  const int32_t PROVIDER_ERROR_NO_NETWORK = -100;
+  // Returned by MarketDataProvider::sendRequest() when the request couldn't be
+  // set up, like from a URL that doesn't parse
+  const int32_t PROVIDER_ERROR_INIT_FAILED = -101;
+
+  /**
+   * @brief Status codes for the StockTicker class.
+   */
+  enum class StockTickerStatus {
+    OK,
+    ERROR_NO_WIFI,
+    ERROR_INIT_REQUEST_FAILED,
+    ERROR_CONNECTION_FAILED,
+    ERROR_SEND_HEADER_FAILED,
+    ERROR_SEND_PAYLOAD_FAILED,
+    ERROR_BAD_JSON_RESPONSE,
+    ERROR_BAD_REQUEST,
+    ERROR_FORBIDDEN,
+    ERROR_TOO_MANY_REQUESTS,
+    ERROR_INTERNAL_SERVER_ERROR,
+    // Couldn't connect (including TLS) within the connect deadline
+    ERROR_CONNECT_TIMEOUT,
+    // Response didn't start within the first byte deadline
+    ERROR_FIRST_BYTE_TIMEOUT,
+    // Whole request took longer than the poll deadline, symbols read before
+    // it were still updated
+    ERROR_POLL_TIMEOUT,
+    ERROR_UNKNOWN
+  };
+
+  /**
+   * @brief What kind of symbols a request is for, each is its own request.
+   */
+  enum class AssetClass {
+    EQUITY,
+    // Trades around the clock, symbols are pairs like "BTC/USD"
+    CRYPTO
+  };
+
+  /**
+   * @brief Receives the quotes a provider parses out of a response.
+   */
+  class QuoteSink {
+    public:
+      /**
+       * @brief Take the latest quote for a symbol.
+       *
+       * @param symbol The symbol.
+       * @param price The current price.
+       * @param change The change since the start of the day.
+       * @param changePercent The change since the start of the day in
+       *  percent.
+       * @param exchangeTime Seconds since 1970 UTC the exchange gave the
+       *  price, 0 if the response didn't say.
+       */
+      virtual void addQuote(const char* symbol, float price, float change,
+                            float changePercent, uint32_t exchangeTime) = 0;
+
+    protected:
+      ~QuoteSink() = default;
+  };
+
+  /**
+   * @brief What a poll asks a provider for.
+   */
+  struct ProviderRequest {
+      AssetClass assetClass;
+      // Comma-separated symbols, all of assetClass
+      const char* symbols;
+      // Milliseconds to connect, including TLS
+      uint32_t connectTimeout;
+      // Milliseconds from sending the request to the start of the response
+      uint32_t firstByteTimeout;
+      // millis() time the whole poll has to be done by, shared by all of its
+      // requests
+      uint32_t deadline;
+      // Per-poll scratch memory, everything in it is freed after the poll
+      PollArena* arena;
+  };
+
+  /**
+   * @brief Somewhere StockTicker can get quotes from.
+   *
+   * A poll calls sendRequest(), then parseBody() with getBody() (after
+   * StockTicker wraps it with its deadline, buffering and decompression) if
+   * it returned 200, or mapError() if it didn't, and always endRequest().
+   * A poll can make more than one request back to back, one per asset class.
+   */
+  class MarketDataProvider {
+    public:
+      virtual ~MarketDataProvider() = default;
+
+      /**
+       * @brief Get a short name for logs.
+       *
+       * @return const char*
+       */
+      virtual const char* getName() const = 0;
+
+      /**
+       * @brief Called in the last moments before a request, to get anything
+       *  slow (like a DNS lookup) out of the way.
+       *
+       * @param lead Milliseconds until the request.
+       */
+      virtual void prefetch(uint32_t lead) {}
+
+      /**
+       * @brief Check if quotes for an asset class can be requested.
+       *
+       * @param assetClass The asset class.
+       * @return true if it is supported.
+       */
+      virtual bool supports(AssetClass assetClass) const {
+        return assetClass == AssetClass::EQUITY;
+      }
+
+      /**
+       * @brief Send the request for a poll and wait for the response to
+       *  start.
+       *
+       * @param request What to ask for.
+       * @return int32_t An HTTP status code, or a negative error.
+       */
+      virtual int32_t sendRequest(const ProviderRequest& request) = 0;
+
+      /**
+       * @brief Get the response body of the current request.
+       *
+       * @return Stream&
+       */
+      virtual Stream& getBody() = 0;
+
+      /**
+       * @brief Check if the response body is gzipped.
+       *
+       * @return true if it has to be inflated before parsing.
+       */
+      virtual bool isBodyGzipped() {
+        return false;
+      }
+
+      /**
+       * @brief Get the length of the response body as sent.
+       *
+       * @return int32_t Bytes, or -1 if not known.
+       */
+      virtual int32_t getBodySize() {
+        return -1;
+      }
+
+      /**
+       * @brief Parse a response body, giving each quote to the sink as soon
+       *  as it is read.
+       *
+       * @param body The body, already inflated if it was gzipped.
+       * @param request The request it answers.
+       * @param sink Where the quotes go.
+       * @return DeserializationError Ok if the whole body was read.
+       */
+      virtual DeserializationError parseBody(Stream& body,
+                                             const ProviderRequest& request,
+                                             QuoteSink& sink) = 0;
+
+      /**
+       * @brief Turn what sendRequest() returned into a status.
+       *
+       * @param code What sendRequest() returned, never 200.
+       * @param elapsed Milliseconds sendRequest() took.
+       * @param request The request that failed.
+       * @return StockTickerStatus
+       */
+      virtual StockTickerStatus mapError(int32_t code, uint32_t elapsed,
+                                         const ProviderRequest& request) = 0;
+
+      /**
+       * @brief Get the time now according to the server, from the last
+       *  response.
+       *
+       * @return uint32_t Seconds since 1970 UTC, or 0 if not known.
+       */
+      virtual uint32_t getServerTime() {
+        return 0;
+      }
+
+      /**
+       * @brief Finish the current request, after this getBody() can't be
+       *  used.
+       */
+      virtual void endRequest() {}
+  };
+} // StockTicker
+
+#endif // PICO2W_STOCK_TICKER_MARKETDATAPROVIDER_H
@@ -0,0 +1,136 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#include <AlpacaSnapshots.h>
+#include <Checksum.h>
+#include <MockProvider.h>
+#include <StockTicker.h>
+
+namespace StockTicker {
+  namespace {
+    // Spreads the bits of x so nearby seeds and polls give unrelated values
+    uint32_t mix(uint32_t x) {
+      x ^= x >> 16;
+      x *= 0x7FEB352D;
+      x ^= x >> 15;
+      x *= 0x846CA68B;
+      x ^= x >> 16;
+      return x;
+    }
+  } // namespace
+
+  /**
+   * @brief Start a new response.
+   *
+   * @param symbols Comma-separated symbols, must stay valid while reading.
+   * @param seed Picks the prices.
+   * @param poll Which poll this is, prices move a little between polls.
+   */
+  void MockSnapshotStream::begin(const char* symbols, uint32_t seed,
+                                 uint32_t poll) {
+    this->nextSymbol = symbols;
+    this->seed = seed;
+    this->poll = poll;
+    this->first = true;
+    this->chunkPos = 0;
+    this->bytesRead = 0;
+    strcpy(this->chunk, "{");
+    this->chunkLen = 1;
+  }
+
+  int MockSnapshotStream::available() {
+    if (this->chunkPos == this->chunkLen && !this->fillChunk()) {
+      return 0;
+    }
+    return this->chunkLen - this->chunkPos;
+  }
+
+  int MockSnapshotStream::read() {
+    if (this->chunkPos == this->chunkLen && !this->fillChunk()) {
+      return -1;
+    }
+    this->bytesRead++;
+    return static_cast<uint8_t>(this->chunk[this->chunkPos++]);
+  }
+
+  int MockSnapshotStream::peek() {
+    if (this->chunkPos == this->chunkLen && !this->fillChunk()) {
+      return -1;
+    }
+    return static_cast<uint8_t>(this->chunk[this->chunkPos]);
+  }
+
+  /**
+   * @brief Write the next symbol's snapshot (or the closing brace) into the
+   *  chunk.
+   *
+   * @return false if the whole response has been read.
+   */
+  bool MockSnapshotStream::fillChunk() {
+    if (this->nextSymbol == nullptr) {
+      return false;
+    }
+    const char* end = strchr(this->nextSymbol, ',');
+    size_t len =
+      end != nullptr ? end - this->nextSymbol : strlen(this->nextSymbol);
+    while (len >= MAX_ID_LEN && end != nullptr) {
+      // Too long to be tracked, like stockSymbolsCount() skip it
+      this->nextSymbol = end + 1;
+      end = strchr(this->nextSymbol, ',');
+      len = end != nullptr ? end - this->nextSymbol : strlen(this->nextSymbol);
+    }
+    if (len == 0 || len >= MAX_ID_LEN) {
+      strcpy(this->chunk, "}");
+      this->chunkLen = 1;
+      this->chunkPos = 0;
+      this->nextSymbol = nullptr;
+      return true;
+    }
+    // Each symbol gets its own price between $1 and $1000, moving up to 5%
+    // from the open each poll
+    const uint32_t symbolHash = Checksum::crc32(this->nextSymbol, len);
+    const float open = 1.0f + static_cast<float>(mix(symbolHash ^ this->seed) %
+                                                 99900) / 100.0f;
+    const int32_t move =
+      static_cast<int32_t>(mix(symbolHash ^ this->seed ^ mix(this->poll)) %
+                           1001) - 500;
+    const float close = open * (1.0f + static_cast<float>(move) / 10000.0f);
+    const int written = snprintf(
+      this->chunk, sizeof(this->chunk),
+      "%s\"%.*s\":{\"dailyBar\":{\"o\":%.2f,\"c\":%.2f}}",
+      this->first ? "" : ",", static_cast<int>(len), this->nextSymbol, open,
+      close);
+    this->chunkLen = min(static_cast<size_t>(max(written, 0)),
+                         sizeof(this->chunk) - 1);
+    this->chunkPos = 0;
+    this->first = false;
+    this->nextSymbol = end != nullptr ? end + 1 : this->nextSymbol + len;
+    return true;
+  }
+
+  int32_t MockProvider::sendRequest(const ProviderRequest& request) {
+    this->pollCount++;
+    if (this->latency > 0) {
+      delay(this->latency);
+    }
+    if (this->errorPeriod > 0 && this->pollCount % this->errorPeriod == 0) {
+      return 500;
+    }
+    this->body.begin(request.symbols, this->seed, this->pollCount);
+    return 200;
+  }
+
+  DeserializationError MockProvider::parseBody(Stream& body,
+                                               const ProviderRequest& request,
+                                               QuoteSink& sink) {
+    return parseAlpacaSnapshots(body, request.arena, sink);
+  }
+
+  StockTickerStatus MockProvider::mapError(int32_t code, uint32_t elapsed,
+                                           const ProviderRequest& request) {
+    LOG_WARN("Mock provider failed poll %lu with %d", this->pollCount,
+             code);
+    return mapAlpacaError(code, elapsed, request);
+  }
+} // StockTicker
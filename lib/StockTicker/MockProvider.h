@@ -0,0 +1,108 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_MOCKPROVIDER_H
+#define PICO2W_STOCK_TICKER_MOCKPROVIDER_H
+
+#include <Arduino.h>
+#include <Log.h>
+#include <MarketDataProvider.h>
+
+namespace StockTicker {
+  /**
+   * @brief Writes a made up snapshots response for a list of symbols as it is
+   *  read, one symbol at a time.
+   */
+  class MockSnapshotStream : public Stream {
+    public:
+      MockSnapshotStream() = default;
+
+      void begin(const char* symbols, uint32_t seed, uint32_t poll);
+
+      int available() override;
+      int read() override;
+      int peek() override;
+
+      size_t write(uint8_t) override {
+        return 0; // Read only
+      }
+
+      /**
+       * @brief Get how many bytes have been read.
+       *
+       * @return uint32_t
+       */
+      uint32_t getBytesRead() const {
+        return this->bytesRead;
+      }
+
+    protected:
+      // Fits the longest symbol's snapshot
+      char chunk[96] = "";
+      uint8_t chunkPos = 0;
+      uint8_t chunkLen = 0;
+      // Next symbol to write, nullptr once the closing brace is written
+      const char* nextSymbol = nullptr;
+      bool first = true;
+      uint32_t seed = 0;
+      uint32_t poll = 0;
+      uint32_t bytesRead = 0;
+
+      bool fillChunk();
+  };
+
+  /**
+   * @brief Makes up quotes without a network, for testing and benchmarking
+   *  everything after the request.
+   *
+   * The same seed always gives the same prices for the same symbols and poll
+   * number. The response is in Alpaca's stock snapshots format (for crypto
+   * too) so it goes through the same parser.
+   */
+  class MockProvider : public MarketDataProvider {
+    public:
+      /**
+       * @brief Create a mock provider.
+       *
+       * @param seed Picks the prices.
+       * @param latency Milliseconds to wait before each response, to stand in
+       *  for the network.
+       * @param errorPeriod If not 0, every this many polls fail with a 500.
+       */
+      explicit MockProvider(uint32_t seed = 1, uint32_t latency = 0,
+                            uint32_t errorPeriod = 0)
+          : seed(seed), latency(latency), errorPeriod(errorPeriod) {}
+
+      ~MockProvider() override = default;
+
+      const char* getName() const override {
+        return "Mock";
+      }
+
+      bool supports(AssetClass assetClass) const override {
+        return true;
+      }
+
+      int32_t sendRequest(const ProviderRequest& request) override;
+
+      Stream& getBody() override {
+        return this->body;
+      }
+
+      DeserializationError parseBody(Stream& body,
+                                     const ProviderRequest& request,
+                                     QuoteSink& sink) override;
+      StockTickerStatus mapError(int32_t code, uint32_t elapsed,
+                                 const ProviderRequest& request) override;
+
+    protected:
+      uint32_t seed;
+      uint32_t latency;
+      uint32_t errorPeriod;
+      uint32_t pollCount = 0;
+      MockSnapshotStream body;
+  };
+} // StockTicker
+
+#endif // PICO2W_STOCK_TICKER_MOCKPROVIDER_H
@@ -0,0 +1,98 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#include <PollArena.h>
+
+namespace StockTicker {
+  /**
+   * @brief Allocate from the end of the arena.
+   *
+   * @param size Number of bytes.
+   * @return void* The memory, or nullptr if the arena is full.
+   */
+  void* PollArena::allocate(size_t size) {
+    if (size > POLL_ARENA_SIZE ||
+        blockSize(size) > POLL_ARENA_SIZE - this->used) {
+      this->outOfMemory(size);
+      return nullptr;
+    }
+    BlockHeader* header = reinterpret_cast<BlockHeader*>(this->buffer +
+                                                         this->used);
+    header->size = size;
+    this->used += blockSize(size);
+    this->highWaterMark = max(this->highWaterMark, this->used);
+    this->lastBlock = header;
+    return header + 1;
+  }
+
+  /**
+   * @brief Free an allocation, only the newest one actually gives its memory
+   *  back before reset().
+   *
+   * @param ptr The allocation, nullptr is ignored.
+   */
+  void PollArena::deallocate(void* ptr) {
+    if (ptr == nullptr) {
+      return;
+    }
+    BlockHeader* header = static_cast<BlockHeader*>(ptr) - 1;
+    if (header == this->lastBlock) {
+      this->used -= blockSize(header->size);
+      // Whatever was before it can't be found again, it stays until reset()
+      this->lastBlock = nullptr;
+    }
+  }
+
+  /**
+   * @brief Resize an allocation, in place if it is the newest one, otherwise
+   *  by copying it to a new one.
+   *
+   * @param ptr The allocation, or nullptr to allocate.
+   * @param newSize The new number of bytes.
+   * @return void* The memory, or nullptr if the arena is full (ptr is still
+   *  valid then).
+   */
+  void* PollArena::reallocate(void* ptr, size_t newSize) {
+    if (ptr == nullptr) {
+      return this->allocate(newSize);
+    }
+    BlockHeader* header = static_cast<BlockHeader*>(ptr) - 1;
+    if (header == this->lastBlock) {
+      const size_t start = reinterpret_cast<uint8_t*>(header) - this->buffer;
+      if (newSize > POLL_ARENA_SIZE ||
+          blockSize(newSize) > POLL_ARENA_SIZE - start) {
+        this->outOfMemory(newSize);
+        return nullptr;
+      }
+      header->size = newSize;
+      this->used = start + blockSize(newSize);
+      this->highWaterMark = max(this->highWaterMark, this->used);
+      return ptr;
+    }
+    if (newSize <= header->size) {
+      return ptr; // Can't give the rest back anyway
+    }
+    void* moved = this->allocate(newSize);
+    if (moved != nullptr) {
+      memcpy(moved, ptr, header->size);
+    }
+    return moved;
+  }
+
+  /**
+   * @brief Get how much of the arena an allocation takes up.
+   */
+  size_t PollArena::blockSize(size_t size) {
+    const size_t aligned =
+      (size + POLL_ARENA_ALIGNMENT - 1) & ~(POLL_ARENA_ALIGNMENT - 1);
+    return sizeof(BlockHeader) + aligned;
+  }
+
+  void PollArena::outOfMemory(size_t size) {
+    this->failureCount++;
+    LOG_ERROR("Poll arena out of memory: %u bytes requested with %u of "
+              "%u bytes used, increase POLL_ARENA_SIZE",
+              size, this->used, POLL_ARENA_SIZE);
+  }
+} // StockTicker
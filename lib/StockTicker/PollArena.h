@@ -0,0 +1,119 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_POLLARENA_H
+#define PICO2W_STOCK_TICKER_POLLARENA_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <Log.h>
+
+namespace StockTicker {
+  // Enough for the snapshots of every symbol plus the read buffer, check the
+  // high-water mark logged after each poll before changing it
+  const size_t POLL_ARENA_SIZE = 48 * 1024;
+  const size_t POLL_ARENA_ALIGNMENT = 8;
+
+  /**
+   * @brief A fixed block of memory that per-poll allocations are bumped out
+   *  of and all freed at once, so polling doesn't fragment the heap.
+   *
+   * Freeing or resizing the newest allocation is done in place, anything else
+   * is only given back by reset(). Allocations fail once the arena is full
+   * instead of falling back to the heap.
+   */
+  class PollArena : public ArduinoJson::Allocator {
+    public:
+      PollArena() = default;
+      ~PollArena() = default;
+
+      void* allocate(size_t size) override;
+      void deallocate(void* ptr) override;
+      void* reallocate(void* ptr, size_t newSize) override;
+
+      /**
+       * @brief Free everything, nothing allocated from the arena can be used
+       *  after this.
+       */
+      void reset() {
+        this->used = 0;
+        this->lastBlock = nullptr;
+      }
+
+      /**
+       * @brief Free everything allocated since getUsed() returned mark,
+       *  nothing allocated after that can be used after this.
+       *
+       * @param mark A value getUsed() returned earlier in the same poll.
+       */
+      void rewind(size_t mark) {
+        this->used = min(mark, this->used);
+        this->lastBlock = nullptr;
+      }
+
+      /**
+       * @brief Get how many bytes are allocated, including headers and
+       *  padding.
+       *
+       * @return size_t
+       */
+      size_t getUsed() const {
+        return this->used;
+      }
+
+      /**
+       * @brief Get the most bytes that have been allocated at once since
+       *  boot.
+       *
+       * @return size_t
+       */
+      size_t getHighWaterMark() const {
+        return this->highWaterMark;
+      }
+
+      /**
+       * @brief Get how many allocations failed since boot.
+       *
+       * @return uint32_t
+       */
+      uint32_t getFailureCount() const {
+        return this->failureCount;
+      }
+
+    protected:
+      // clang-format off
+      struct alignas(POLL_ARENA_ALIGNMENT) BlockHeader {
+          size_t size;
+      };
+      // clang-format on
+
+      alignas(POLL_ARENA_ALIGNMENT) uint8_t buffer[POLL_ARENA_SIZE];
+      size_t used = 0;
+      size_t highWaterMark = 0;
+      uint32_t failureCount = 0;
+      // Header of the newest allocation, the only one that can grow in place
+      BlockHeader* lastBlock = nullptr;
+
+      static size_t blockSize(size_t size);
+      void outOfMemory(size_t size);
+  };
+
+  /**
+   * @brief Lets StreamUtils' buffering streams take their buffer from a
+   *  PollArena.
+   */
+  struct PollArenaStreamAllocator {
+      PollArena* arena = nullptr;
+
+      void* allocate(size_t size) {
+        return this->arena->allocate(size);
+      }
+
+      void deallocate(void* ptr) {
+        this->arena->deallocate(ptr);
+      }
+  };
+} // StockTicker
+
+#endif // PICO2W_STOCK_TICKER_POLLARENA_H
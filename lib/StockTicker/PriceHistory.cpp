@@ -0,0 +1,84 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#include <PriceHistory.h>
+
+namespace StockTicker {
+  /**
+   * @brief Add the newest price to the history, dropping the oldest one if
+   *  full.
+   *
+   * A jump too big for a 16-bit delta in the current unit makes the unit
+   * bigger until it fits.
+   *
+   * @param price The price in dollars.
+   */
+  void SymbolHistory::append(float price) {
+    const int32_t cents = static_cast<int32_t>(lroundf(price * 100.0f));
+    if (this->count == 0) {
+      this->lastCents = cents;
+      this->count = 1;
+      return;
+    }
+    int32_t delta = this->toUnits(cents) - this->toUnits(this->lastCents);
+    while (delta < INT16_MIN || delta > INT16_MAX) {
+      this->rescale(this->scaleShift + 1);
+      delta = this->toUnits(cents) - this->toUnits(this->lastCents);
+    }
+    const uint16_t deltaCount = this->count - 1;
+    if (deltaCount == PRICE_HISTORY_CAPACITY) {
+      // Full, overwrite the oldest delta
+      this->deltas[this->head] = static_cast<int16_t>(delta);
+      this->head = (this->head + 1) % PRICE_HISTORY_CAPACITY;
+    } else {
+      this->deltas[(this->head + deltaCount) % PRICE_HISTORY_CAPACITY] =
+        static_cast<int16_t>(delta);
+      this->count++;
+    }
+    this->lastCents = cents;
+  }
+
+  /**
+   * @brief Get the stored prices in cents, oldest first.
+   *
+   * @param samples Where to write the prices.
+   * @param maxSamples How many prices fit in samples, only the newest are
+   *  written if there are more than that.
+   * @return uint16_t The number of prices written.
+   */
+  uint16_t SymbolHistory::getSamples(int32_t* samples,
+                                     uint16_t maxSamples) const {
+    const uint16_t written = min(this->count, maxSamples);
+    if (written == 0) {
+      return 0;
+    }
+    // Walk backwards from the newest price, undoing one delta at a time
+    int32_t units = this->toUnits(this->lastCents);
+    samples[written - 1] = this->lastCents;
+    for (uint16_t i = 1; i < written; i++) {
+      const uint16_t deltaIndex = this->count - 1 - i;
+      units -= this->deltas[(this->head + deltaIndex) % PRICE_HISTORY_CAPACITY];
+      samples[written - 1 - i] = units * (1 << this->scaleShift);
+    }
+    return written;
+  }
+
+  /**
+   * @brief Switch to a bigger unit, rounding every sample but the newest to
+   *  it and working out the deltas again. They get smaller, so they still
+   *  fit.
+   *
+   * @param newScaleShift The new unit is 2^newScaleShift cents.
+   */
+  void SymbolHistory::rescale(uint16_t newScaleShift) {
+    int32_t samples[MAX_SAMPLES];
+    const uint16_t sampleCount = this->getSamples(samples, MAX_SAMPLES);
+    this->scaleShift = newScaleShift;
+    this->head = 0;
+    for (uint16_t i = 1; i < sampleCount; i++) {
+      this->deltas[i - 1] = static_cast<int16_t>(
+        this->toUnits(samples[i]) - this->toUnits(samples[i - 1]));
+    }
+  }
+} // StockTicker
@@ -0,0 +1,97 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_PRICEHISTORY_H
+#define PICO2W_STOCK_TICKER_PRICEHISTORY_H
+
+#include <Arduino.h>
+
+namespace StockTicker {
+  // RAM set aside for the price histories of all symbols together
+  const size_t PRICE_HISTORY_RAM_BUDGET = 5 * 1024;
+  // Must match MAX_SYMBOLS in StockTicker.h, checked there
+  const uint16_t PRICE_HISTORY_SYMBOLS = 64;
+  // Bytes of each history that are not deltas (lastCents, head, count and
+  // scaleShift)
+  const size_t PRICE_HISTORY_OVERHEAD =
+    sizeof(int32_t) + 3 * sizeof(uint16_t);
+  // How many deltas fit in each symbol's share of the budget
+  const uint16_t PRICE_HISTORY_CAPACITY =
+    (PRICE_HISTORY_RAM_BUDGET / PRICE_HISTORY_SYMBOLS -
+     PRICE_HISTORY_OVERHEAD) /
+    sizeof(int16_t);
+
+  /**
+   * @brief Fixed capacity history of one symbol's prices.
+   *
+   * Only the newest price is kept in full (in cents), older ones are stored as
+   * the 16-bit difference to the price after them in a ring buffer, so a
+   * history holds PRICE_HISTORY_CAPACITY + 1 samples. Appending is O(1) and
+   * nothing is allocated.
+   *
+   * Differences are counted in units of 2^scaleShift cents. A symbol starts
+   * at one cent, and the first jump too big for 16 bits ($327.67 at one
+   * cent, easy for crypto) doubles the unit until it fits, rounding the
+   * older samples to it. So expensive symbols keep their history at a
+   * coarser step instead of losing it.
+   */
+  class SymbolHistory {
+    public:
+      void append(float price);
+      uint16_t getSamples(int32_t* samples, uint16_t maxSamples) const;
+
+      /**
+       * @brief Forget all samples.
+       */
+      void clear() {
+        this->head = 0;
+        this->count = 0;
+        this->scaleShift = 0;
+      }
+
+      /**
+       * @brief Get how many samples are stored, including the newest one.
+       *
+       * @return uint16_t The number of samples.
+       */
+      uint16_t getSampleCount() const {
+        return this->count;
+      }
+
+      static const uint16_t MAX_SAMPLES = PRICE_HISTORY_CAPACITY + 1;
+
+    protected:
+      // Newest price in cents
+      int32_t lastCents = 0;
+      // Index of the oldest delta
+      uint16_t head = 0;
+      // Number of samples, one more than the number of deltas if not 0
+      uint16_t count = 0;
+      // Deltas are in units of 2^scaleShift cents
+      uint16_t scaleShift = 0;
+      // deltas[(head + i) % CAPACITY] is sample i + 1 minus sample i, in units
+      int16_t deltas[PRICE_HISTORY_CAPACITY];
+
+      /**
+       * @brief Round a price in cents to the current unit.
+       */
+      int32_t toUnits(int32_t cents) const {
+        return this->scaleShift == 0
+                 ? cents
+                 : (cents + (1 << (this->scaleShift - 1))) >> this->scaleShift;
+      }
+
+      void rescale(uint16_t newScaleShift);
+  };
+
+  static_assert(sizeof(SymbolHistory) ==
+                  PRICE_HISTORY_OVERHEAD +
+                    PRICE_HISTORY_CAPACITY * sizeof(int16_t),
+                "SymbolHistory should not have padding");
+  static_assert(sizeof(SymbolHistory) * PRICE_HISTORY_SYMBOLS <=
+                  PRICE_HISTORY_RAM_BUDGET,
+                "Price histories do not fit in PRICE_HISTORY_RAM_BUDGET");
+} // StockTicker
+
+#endif // PICO2W_STOCK_TICKER_PRICEHISTORY_H
@@ -0,0 +1,206 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#include <Checksum.h>
+#include <FatFS.h>
+#include <PriceStore.h>
+
+namespace StockTicker {
+  /**
+   * @brief Read the newest intact record from the file. The filesystem must
+   *  already be mounted, like by Settings::loadAllFromDisk().
+   *
+   * @return true if there was one.
+   */
+  bool PriceStore::load() {
+    this->hasRecord = false;
+    this->nextSlot = 0;
+    File file = FatFS.open(this->path, "r");
+    if (!file) {
+      LOG_INFO("No saved prices to restore");
+      return false;
+    }
+    RecordHeader headers[PRICE_STORE_SLOT_COUNT];
+    bool untried[PRICE_STORE_SLOT_COUNT];
+    for (uint8_t slot = 0; slot < PRICE_STORE_SLOT_COUNT; slot++) {
+      untried[slot] =
+        file.seek(slot * SLOT_SIZE) &&
+        file.read(reinterpret_cast<uint8_t*>(&headers[slot]),
+                  sizeof(RecordHeader)) == sizeof(RecordHeader) &&
+        headers[slot].magic == PRICE_STORE_MAGIC &&
+        headers[slot].payloadSize <= MAX_PAYLOAD_SIZE;
+    }
+    // Newest first, a torn one falls back to the one before it
+    while (true) {
+      int8_t newest = -1;
+      for (uint8_t slot = 0; slot < PRICE_STORE_SLOT_COUNT; slot++) {
+        if (untried[slot] &&
+            (newest < 0 || static_cast<int32_t>(headers[slot].sequence -
+                                                headers[newest].sequence) > 0)) {
+          newest = slot;
+        }
+      }
+      if (newest < 0) {
+        break;
+      }
+      untried[newest] = false;
+      const RecordHeader& slotHeader = headers[newest];
+      if (file.seek(newest * SLOT_SIZE + sizeof(RecordHeader)) &&
+          file.read(this->payload, slotHeader.payloadSize) ==
+            slotHeader.payloadSize &&
+          slotHeader.crc == recordCrc(slotHeader, this->payload)) {
+        this->header = slotHeader;
+        this->hasRecord = true;
+        this->nextSlot = (newest + 1) % PRICE_STORE_SLOT_COUNT;
+        break;
+      }
+      LOG_WARN("Saved prices in slot %d are torn or corrupted", newest);
+    }
+    file.close();
+    if (!this->hasRecord) {
+      LOG_WARN("No intact saved prices to restore");
+    }
+    return this->hasRecord;
+  }
+
+  /**
+   * @brief Restore prices from the newest record, and mark them stale.
+   *  Symbols that aren't in the price table or already have a price are
+   *  ignored. Doesn't touch the filesystem.
+   *
+   * @param prices The price table, with symbol IDs already filled in.
+   * @param count How many symbols are in the price table.
+   * @return uint16_t How many symbols had their price restored.
+   */
+  uint16_t PriceStore::restore(SymbolPrice* prices, uint16_t count) const {
+    if (!this->hasRecord) {
+      return 0;
+    }
+    uint16_t restoredCount = 0;
+    const uint8_t* ptr = this->payload;
+    for (uint16_t i = 0; i < this->header.entryCount; i++) {
+      const uint8_t idLen = *ptr++;
+      char id[MAX_ID_LEN] = "";
+      memcpy(id, ptr, min(idLen, static_cast<uint8_t>(MAX_ID_LEN - 1)));
+      ptr += idLen;
+      for (uint16_t j = 0; j < count; j++) {
+        if (strcmp(prices[j].id, id) == 0) {
+          if (prices[j].price > 0) {
+            break; // Already has a newer price
+          }
+          memcpy(&prices[j].price, ptr, sizeof(float));
+          memcpy(&prices[j].change, ptr + sizeof(float), sizeof(float));
+          memcpy(&prices[j].changePercent, ptr + 2 * sizeof(float),
+                 sizeof(float));
+          prices[j].stale = true;
+          restoredCount++;
+          break;
+        }
+      }
+      ptr += 3 * sizeof(float);
+    }
+    LOG_INFO("Restored %d saved prices", restoredCount);
+    return restoredCount;
+  }
+
+  /**
+   * @brief Save the symbols that have data over the oldest slot. Mounts and
+   *  unmounts the filesystem.
+   *
+   * @param prices The price table.
+   * @param count How many symbols are in the price table.
+   * @return true if the record was written.
+   */
+  bool PriceStore::save(const SymbolPrice* prices, uint16_t count) {
+    RecordHeader record = {PRICE_STORE_MAGIC, this->header.sequence + 1, 0, 0,
+                           0};
+    uint8_t* ptr = this->payload;
+    for (uint16_t i = 0; i < count; i++) {
+      if (prices[i].price <= 0) {
+        continue; // No data yet, nothing worth saving
+      }
+      const uint8_t idLen = strnlen(prices[i].id, MAX_ID_LEN - 1);
+      *ptr++ = idLen;
+      memcpy(ptr, prices[i].id, idLen);
+      ptr += idLen;
+      memcpy(ptr, &prices[i].price, sizeof(float));
+      ptr += sizeof(float);
+      memcpy(ptr, &prices[i].change, sizeof(float));
+      ptr += sizeof(float);
+      memcpy(ptr, &prices[i].changePercent, sizeof(float));
+      ptr += sizeof(float);
+      record.entryCount++;
+    }
+    if (record.entryCount == 0) {
+      return false;
+    }
+    record.payloadSize = ptr - this->payload;
+    record.crc = recordCrc(record, this->payload);
+    // Restored from memory from now on, even if writing it fails
+    this->header = record;
+    this->hasRecord = true;
+
+    if (!FatFS.begin()) {
+      LOG_ERROR("Failed to init FatFS to save prices");
+      return false;
+    }
+    const bool ok = this->writeSlot();
+    FatFS.end();
+    LOG_INFO("%s %d prices to %s slot %d", ok ? "Saved" : "Failed to save",
+             record.entryCount, this->path, this->nextSlot);
+    if (ok) {
+      this->nextSlot = (this->nextSlot + 1) % PRICE_STORE_SLOT_COUNT;
+    }
+    return ok;
+  }
+
+  /**
+   * @brief Write the record to the next slot, creating the file at its full
+   *  size first if it isn't already.
+   */
+  bool PriceStore::writeSlot() {
+    File file = FatFS.open(this->path, "r+");
+    if (!file || file.size() != FILE_SIZE) {
+      // Only ever the first save, or after the file was changed over USB
+      LOG_INFO("Creating %s with %d slots", this->path,
+               PRICE_STORE_SLOT_COUNT);
+      file.close();
+      file = FatFS.open(this->path, "w");
+      if (!file) {
+        return false;
+      }
+      const uint8_t zeros[64] = {};
+      for (size_t written = 0; written < FILE_SIZE;
+           written += sizeof(zeros)) {
+        if (file.write(zeros, sizeof(zeros)) != sizeof(zeros)) {
+          file.close();
+          return false;
+        }
+      }
+      file.close();
+      file = FatFS.open(this->path, "r+");
+      this->nextSlot = 0;
+    }
+    bool ok = false;
+    if (file) {
+      ok = file.seek(this->nextSlot * SLOT_SIZE) &&
+           file.write(reinterpret_cast<const uint8_t*>(&this->header),
+                      sizeof(RecordHeader)) == sizeof(RecordHeader) &&
+           file.write(this->payload, this->header.payloadSize) ==
+             this->header.payloadSize;
+      file.close();
+    }
+    return ok;
+  }
+
+  /**
+   * @brief Calculate the CRC of a record, not including the CRC itself.
+   */
+  uint32_t PriceStore::recordCrc(const RecordHeader& header,
+                                 const uint8_t* payload) {
+    const uint32_t crc =
+      Checksum::crc32(&header, offsetof(RecordHeader, crc));
+    return Checksum::crc32(payload, header.payloadSize, crc);
+  }
+} // StockTicker
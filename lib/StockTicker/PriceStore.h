@@ -0,0 +1,93 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_PRICESTORE_H
+#define PICO2W_STOCK_TICKER_PRICESTORE_H
+
+#include <Arduino.h>
+#include <Log.h>
+#include <StockTicker.h>
+
+namespace StockTicker {
+  const char* const PRICE_STORE_PATH = "prices.bin";
+  // Records go round this many slots, so a save cut short by a reboot still
+  // leaves the one before it
+  const uint8_t PRICE_STORE_SLOT_COUNT = 4;
+  // Slots start on a sector so a save only writes its own slot's sectors
+  const size_t PRICE_STORE_SECTOR_SIZE = 512;
+  const uint32_t PRICE_STORE_MAGIC = 0x50524353; // "PRCS"
+  // How often to save prices after a successful request
+  const uint32_t PRICE_STORE_PERIOD = 5 * 60 * 1000;
+
+  /**
+   * @brief Saves the price table to a file of fixed size slots with a CRC
+   *  each, so prices can be shown right after a reboot.
+   *
+   * The file is created at its full size once, after that each save
+   * overwrites the oldest slot in place. The file never grows or gets
+   * truncated, so its clusters stay allocated and the FAT isn't written
+   * again, only the slot's sectors and the file's directory entry are.
+   *
+   * Each record is a header followed by one entry per symbol with data: a
+   * length prefixed symbol and the price, change and change percent. The
+   * newest record is kept in memory, so it is read from the filesystem once
+   * at boot (with load(), while the settings have it mounted) and restoring
+   * it after that doesn't touch the filesystem.
+   *
+   * StockTicker only calls restore() and save(), which are virtual so a test
+   * can keep prices in memory instead.
+   */
+  class PriceStore {
+    public:
+      /**
+       * @brief Constructor for PriceStore.
+       *
+       * @param path The file to save to, must stay valid.
+       */
+      explicit PriceStore(const char* path = PRICE_STORE_PATH)
+          : path(path) {
+      }
+      virtual ~PriceStore() = default;
+
+      bool load();
+      virtual uint16_t restore(SymbolPrice* prices, uint16_t count) const;
+      virtual bool save(const SymbolPrice* prices, uint16_t count);
+
+      // Length byte, longest symbol, price, change and change percent
+      static const size_t MAX_ENTRY_SIZE = 1 + MAX_ID_LEN + 3 * sizeof(float);
+      static const size_t MAX_PAYLOAD_SIZE = MAX_SYMBOLS * MAX_ENTRY_SIZE;
+
+    protected:
+      // clang-format off
+      struct RecordHeader {
+          uint32_t magic;
+          // One more than the record before, the highest intact one is the
+          // newest
+          uint32_t sequence;
+          uint16_t payloadSize;
+          uint16_t entryCount;
+          uint32_t crc;
+      };
+      // clang-format on
+
+      static const size_t SLOT_SIZE =
+        (sizeof(RecordHeader) + MAX_PAYLOAD_SIZE + PRICE_STORE_SECTOR_SIZE -
+         1) /
+        PRICE_STORE_SECTOR_SIZE * PRICE_STORE_SECTOR_SIZE;
+      static const size_t FILE_SIZE = SLOT_SIZE * PRICE_STORE_SLOT_COUNT;
+
+      const char* path;
+      // The newest record, loaded or saved
+      RecordHeader header = {};
+      uint8_t payload[MAX_PAYLOAD_SIZE];
+      bool hasRecord = false;
+      uint8_t nextSlot = 0;
+
+      bool writeSlot();
+      static uint32_t recordCrc(const RecordHeader& header,
+                                const uint8_t* payload);
+  };
+} // StockTicker
+
+#endif // PICO2W_STOCK_TICKER_PRICESTORE_H
@@ -0,0 +1,35 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#include <AlpacaSnapshots.h>
+#include <ReplayProvider.h>
+
+namespace StockTicker {
+  int32_t ReplayProvider::sendRequest(const ProviderRequest& request) {
+    if (this->count == 0) {
+      this->current = nullptr;
+      return PROVIDER_ERROR_INIT_FAILED;
+    }
+    if (this->latency > 0) {
+      delay(this->latency);
+    }
+    this->current = &this->responses[this->next];
+    this->next = (this->next + 1) % this->count;
+    this->body.begin(this->current->body, this->current->bodyLength);
+    return this->current->statusCode;
+  }
+
+  DeserializationError ReplayProvider::parseBody(
+    Stream& body, const ProviderRequest& request, QuoteSink& sink) {
+    return request.assetClass == AssetClass::CRYPTO
+             ? parseAlpacaCryptoSnapshots(body, request.arena, sink)
+             : parseAlpacaSnapshots(body, request.arena, sink);
+  }
+
+  StockTickerStatus ReplayProvider::mapError(int32_t code, uint32_t elapsed,
+                                             const ProviderRequest& request) {
+    LOG_WARN("Replayed response has status code %d", code);
+    return mapAlpacaError(code, elapsed, request);
+  }
+} // StockTicker
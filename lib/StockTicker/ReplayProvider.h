@@ -0,0 +1,131 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_REPLAYPROVIDER_H
+#define PICO2W_STOCK_TICKER_REPLAYPROVIDER_H
+
+#include <Arduino.h>
+#include <Log.h>
+#include <MarketDataProvider.h>
+
+namespace StockTicker {
+  /**
+   * @brief Reads from a block of memory.
+   */
+  class MemoryStream : public Stream {
+    public:
+      MemoryStream() = default;
+
+      /**
+       * @brief Start reading a new block.
+       *
+       * @param data The bytes, must stay valid while reading.
+       * @param length How many bytes there are.
+       */
+      void begin(const uint8_t* data, size_t length) {
+        this->data = data;
+        this->length = length;
+        this->pos = 0;
+      }
+
+      int available() override {
+        return static_cast<int>(this->length - this->pos);
+      }
+
+      int read() override {
+        return this->pos < this->length ? this->data[this->pos++] : -1;
+      }
+
+      int peek() override {
+        return this->pos < this->length ? this->data[this->pos] : -1;
+      }
+
+      size_t write(uint8_t) override {
+        return 0; // Read only
+      }
+
+    protected:
+      const uint8_t* data = nullptr;
+      size_t length = 0;
+      size_t pos = 0;
+  };
+
+  /**
+   * @brief One recorded response to replay.
+   */
+  struct RecordedResponse {
+      // HTTP status code, the body is only used for 200
+      int32_t statusCode;
+      const uint8_t* body;
+      size_t bodyLength;
+      // If the body is gzipped as it was sent
+      bool gzipped;
+  };
+
+  /**
+   * @brief Plays back recorded Alpaca snapshots responses in order, starting
+   *  over after the last one, so a real day's responses can be run through
+   *  everything after the request again and again.
+   *
+   * Bodies can be captured with LOG_JSON_PARSED, or saved gzipped to replay
+   * the decompression too. Stock and crypto requests take the next response
+   * alike, so record them in the order they were polled.
+   */
+  class ReplayProvider : public MarketDataProvider {
+    public:
+      /**
+       * @brief Create a replay provider.
+       *
+       * @param responses The responses, must stay valid while it is used.
+       * @param count How many responses there are.
+       * @param latency Milliseconds to wait before each response, to stand in
+       *  for the network.
+       */
+      ReplayProvider(const RecordedResponse* responses, size_t count,
+                     uint32_t latency = 0)
+          : responses(responses), count(count), latency(latency) {}
+
+      ~ReplayProvider() override = default;
+
+      const char* getName() const override {
+        return "Replay";
+      }
+
+      bool supports(AssetClass assetClass) const override {
+        return true;
+      }
+
+      int32_t sendRequest(const ProviderRequest& request) override;
+
+      Stream& getBody() override {
+        return this->body;
+      }
+
+      bool isBodyGzipped() override {
+        return this->current != nullptr && this->current->gzipped;
+      }
+
+      int32_t getBodySize() override {
+        return this->current != nullptr
+                 ? static_cast<int32_t>(this->current->bodyLength)
+                 : -1;
+      }
+
+      DeserializationError parseBody(Stream& body,
+                                     const ProviderRequest& request,
+                                     QuoteSink& sink) override;
+      StockTickerStatus mapError(int32_t code, uint32_t elapsed,
+                                 const ProviderRequest& request) override;
+
+    protected:
+      const RecordedResponse* responses;
+      size_t count;
+      uint32_t latency;
+      size_t next = 0;
+      const RecordedResponse* current = nullptr;
+      MemoryStream body;
+  };
+} // StockTicker
+
+#endif // PICO2W_STOCK_TICKER_REPLAYPROVIDER_H
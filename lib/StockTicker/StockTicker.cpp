@@ -2,6 +2,7 @@
 // Created by ckyiu on 7/8/2025.
 //
 
+#include <PriceStore.h>
 #include <StockTicker.h>
 
 namespace StockTicker {
@@ -12,7 +13,8 @@ namespace StockTicker {
     char* rest = str;
     uint16_t symbolCount = 0;
     while ((token = strtok_r(rest, ",", &rest))) {
-      if (strlen(token) < MAX_ID_LEN) {
+      SymbolTier tier;
+      if (splitSymbolTier(token, tier) && strlen(token) < MAX_ID_LEN) {
         //        strncpy(allSymbolPrices[this->symbolCount].id, token,
         //        MAX_ID_LEN);
         //        // If price is negative than no data yet
@@ -27,275 +29,872 @@ namespace StockTicker {
     return symbolCount;
   }
 
+  /**
+   * @brief Take the tier off the end of a symbol from the symbols list, like
+   *  "AAPL:fast". Either "fast", "normal" or "slow".
+   *
+   * @param token The symbol, cut at the separator if it has a tier.
+   * @param tier Set to the tier, NORMAL if it didn't have one.
+   * @return false if the tier isn't one of them.
+   */
+  bool splitSymbolTier(char* token, SymbolTier& tier) {
+    tier = SymbolTier::NORMAL;
+    char* separator = strchr(token, SYMBOL_TIER_SEPARATOR);
+    if (separator == nullptr) {
+      return true;
+    }
+    *separator = '\0';
+    const char* name = separator + 1;
+    if (strcmp(name, "fast") == 0) {
+      tier = SymbolTier::FAST;
+    } else if (strcmp(name, "slow") == 0) {
+      tier = SymbolTier::SLOW;
+    } else if (strcmp(name, "normal") != 0) {
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Check if a symbol is a crypto pair, which Alpaca writes with a
+   *  slash like "BTC/USD".
+   *
+   * @param symbol The symbol.
+   * @return true if it is crypto.
+   */
+  bool isCryptoSymbol(const char* symbol) {
+    return strchr(symbol, '/') != nullptr;
+  }
+
   /**
    * @brief Initialize with parameters
    *
    * This function initializes the StockTicker with a comma-separated list of
-   * stocks, (up to a configured maximum) the feed to use, and the time between
-   * each request.
+   * stocks and crypto pairs (up to a configured maximum) and the time between
+   * each request for each. Prices saved before the last reboot are restored
+   * from the price store (if there is one) and marked stale until they are
+   * requested again.
    *
-   * @param apiKeyId Your Alpaca Markets API key ID.
-   * @param apiSecretKey Your Alpaca Markets API secret key.
-   * @param symbolsString The comma-separated list of stocks to track.
-   * @param feed What feed to use. Either "sip", "iex", "delayed_sip", "boats",
-   *  "overnight", or "otc". Only iex or delayed_sip are available with a free
-   *  account. The default is "iex".
-   * @param request The time between each request in milliseconds. The default
-   *  is 60 seconds.
+   * It can be called again to apply new settings, symbols that were already
+   * being tracked keep their prices and history.
+   *
+   * @param symbolsString The comma-separated list of stocks to track, symbols
+   *  with a slash (like "BTC/USD") are crypto. Each can end with a tier like
+   *  "AAPL:fast".
+   * @param request The time between each request for NORMAL stocks in
+   *  milliseconds. The default is 60 seconds.
+   * @param cryptoRequest The time between each request for NORMAL crypto in
+   *  milliseconds. The default is 60 seconds.
    */
-  void StockTicker::begin(const char* apiKeyId, const char* apiSecretKey,
-                          const char* symbolsString,
-                          const char* feed /* = "iex" */,
-                          uint32_t request /* = 60 * 1000*/) {
-    this->apcaApiKeyId = apiKeyId;
-    this->apcaApiSecretKey = apiSecretKey;
-    this->sourceFeed = feed;
+  void StockTicker::begin(const char* symbolsString,
+                          uint32_t request /* = 60 * 1000*/,
+                          uint32_t cryptoRequest /* = 60 * 1000*/) {
     this->requestPeriod = request;
-    // Parse comma-separated symbols string
+    this->cryptoRequestPeriod = cryptoRequest;
+    this->setSymbols(symbolsString);
+    this->prefetched = false;
+    // Show the prices from before the last reboot until the first request
+    if (this->priceStore != nullptr) {
+      this->priceStore->restore(this->allSymbolPrices, this->symbolCount);
+    }
+    LOG_DEBUG("Price histories use %u bytes (%u samples per symbol)",
+              this->getHistoryMemoryUsage(), SymbolHistory::MAX_SAMPLES);
+    this->status = StockTickerStatus::OK;
+    // Deadlines are compared as signed differences, so "now" has to be
+    // millis() rather than 0 or they'd be in the future after 24.8 days
+    this->refreshOnNextUpdate(); // Update as soon as possible
+    this->rateCredit = RATE_LIMIT_WINDOW;
+    this->lastCreditTime = millis();
+    // Save after the first successful request
+    this->nextPersistTime = millis();
+    this->lastAgeReport = millis();
+  }
+
+  /**
+   * @brief Add somewhere to get quotes from. With more than one, each poll
+   *  uses whichever has been fastest, trying the others again now and then.
+   *
+   * @param provider The provider, must stay valid while the StockTicker is
+   *  used.
+   * @return false if there is no room for another provider.
+   */
+  bool StockTicker::addProvider(MarketDataProvider* provider) {
+    if (this->providerCount >= MAX_PROVIDERS) {
+      LOG_WARN("No room for provider %s", provider->getName());
+      return false;
+    }
+    this->providers[this->providerCount++] = {provider, 0, 0, false};
+    return true;
+  }
+
+  /**
+   * @brief Pick the provider for the next poll.
+   *
+   * Providers that haven't been used yet go first. After that it's the one
+   * with the lowest average latency, except every PROVIDER_PROBE_PERIOD polls
+   * when it's the one used longest ago, so a provider that was slow once
+   * isn't left out forever.
+   *
+   * @param assetClass What the poll is for, only providers that support it
+   *  are picked.
+   * @return int8_t The provider's slot, or -1 if none support assetClass.
+   */
+  int8_t StockTicker::pickProvider(AssetClass assetClass) const {
+    int8_t best = -1;
+    const bool probe = this->pollCount % PROVIDER_PROBE_PERIOD == 0;
+    for (uint8_t i = 0; i < this->providerCount; i++) {
+      const ProviderSlot& slot = this->providers[i];
+      if (!slot.provider->supports(assetClass)) {
+        continue;
+      }
+      if (!slot.measured) {
+        return i;
+      }
+      if (best < 0 ||
+          (probe ? slot.lastUsedPoll < this->providers[best].lastUsedPoll
+                 : slot.averageLatency <
+                     this->providers[best].averageLatency)) {
+        best = i;
+      }
+    }
+    return best;
+  }
+
+  /**
+   * @brief Add a poll's latency to its provider's average.
+   */
+  void StockTicker::recordLatency(int8_t slot, uint32_t latency) {
+    ProviderSlot& providerSlot = this->providers[slot];
+    providerSlot.averageLatency =
+      providerSlot.measured ? (3 * providerSlot.averageLatency + latency) / 4
+                            : latency;
+    providerSlot.measured = true;
+    providerSlot.lastUsedPoll = this->pollCount;
+    LOG_DEBUG("Provider %s: %lu ms (average %lu ms)",
+              providerSlot.provider->getName(), latency,
+              providerSlot.averageLatency);
+  }
+
+  /**
+   * @brief Replace the tracked symbols with a comma-separated list.
+   *
+   * The table is rearranged in place into the new order. Symbols in both the
+   * old and new list keep their price and history, new symbols start with no
+   * data and symbols no longer in the list are dropped.
+   *
+   * @param symbolsString The comma-separated list of stocks to track.
+   */
+  void StockTicker::setSymbols(const char* symbolsString) {
     this->symbols = symbolsString;
-    memset(this->allSymbolPrices, 0, sizeof(this->allSymbolPrices));
     // Temp string for strtok_r
     char str[MAX_SYMBOLS_STRING_LEN];
     strncpy(str, this->symbols, MAX_SYMBOLS_STRING_LEN);
+    str[MAX_SYMBOLS_STRING_LEN - 1] = '\0';
     char* token;
     char* rest = str;
-    this->symbolCount = 0;
-    while ((token = strtok_r(rest, ",", &rest)) &&
-           this->symbolCount < MAX_SYMBOLS) {
-      if (strlen(token) < MAX_ID_LEN) {
-        strncpy(this->allSymbolPrices[this->symbolCount].id, token, MAX_ID_LEN);
-        // If price is negative than no data yet
-        allSymbolPrices[this->symbolCount].price = -1;
-        Serial1.printf("Symbol '%s' initialized at index %d\n", token,
-                       this->symbolCount);
-        this->symbolCount++;
+    // Old symbols that haven't been placed yet are in [newCount, oldEnd)
+    uint16_t oldEnd = this->symbolCount;
+    uint16_t newCount = 0;
+    while ((token = strtok_r(rest, ",", &rest)) && newCount < MAX_SYMBOLS) {
+      SymbolTier tier;
+      if (!splitSymbolTier(token, tier)) {
+        LOG_WARN("Symbol '%s' has an unknown tier, skipping.", token);
+        continue;
+      }
+      if (strlen(token) >= MAX_ID_LEN) {
+        LOG_WARN("Symbol '%s' is too long, skipping.", token);
+        continue;
+      }
+      uint16_t found = oldEnd;
+      for (uint16_t i = newCount; i < oldEnd; i++) {
+        if (strcmp(this->allSymbolPrices[i].id, token) == 0) {
+          found = i;
+          break;
+        }
+      }
+      if (found < oldEnd) {
+        this->swapSymbols(newCount, found);
+        LOG_DEBUG("Symbol '%s' kept at index %d", token, newCount);
       } else {
-        Serial1.printf("Symbol '%s' is too long, skipping.\n", token);
+        if (newCount < oldEnd && oldEnd < MAX_SYMBOLS) {
+          // Move the old symbol in this slot out of the way, it might still be
+          // further down the new list
+          this->swapSymbols(newCount, oldEnd);
+          oldEnd++;
+        }
+        SymbolPrice& symbolPrice = this->allSymbolPrices[newCount];
+        memset(&symbolPrice, 0, sizeof(symbolPrice));
+        strncpy(symbolPrice.id, token, MAX_ID_LEN);
+        // If price is negative than no data yet
+        symbolPrice.price = -1;
+        this->priceHistories[newCount].clear();
+        this->ageHistograms[newCount].clear();
+        LOG_DEBUG("Symbol '%s' initialized at index %d", token,
+                  newCount);
       }
+      this->schedules[newCount].tier = tier;
+      newCount++;
     }
-    this->nextRequestTime = 0; // Update as soon as possible
+    this->symbolCount = newCount;
   }
 
-  #define RESCHEDULE_MACRO()                                                     \
-  {                                                                            \
-    Serial1.printf("Next request in %d seconds", this->requestPeriod / 1000);  \
-    this->nextRequestTime = millis() + this->requestPeriod;                    \
+  /**
+   * @brief Swap two symbols in the table, along with their histories,
+   *  schedules and age histograms.
+   */
+  void StockTicker::swapSymbols(uint16_t a, uint16_t b) {
+    if (a == b) {
+      return;
+    }
+    const SymbolPrice tempPrice = this->allSymbolPrices[a];
+    this->allSymbolPrices[a] = this->allSymbolPrices[b];
+    this->allSymbolPrices[b] = tempPrice;
+    const SymbolHistory tempHistory = this->priceHistories[a];
+    this->priceHistories[a] = this->priceHistories[b];
+    this->priceHistories[b] = tempHistory;
+    const SymbolSchedule tempSchedule = this->schedules[a];
+    this->schedules[a] = this->schedules[b];
+    this->schedules[b] = tempSchedule;
+    const AgeHistogram tempAges = this->ageHistograms[a];
+    this->ageHistograms[a] = this->ageHistograms[b];
+    this->ageHistograms[b] = tempAges;
+  }
+
+  /**
+   * @brief Get how often a symbol is refreshed, from its tier.
+   *
+   * @param index The symbol's index.
+   * @return uint32_t Milliseconds.
+   */
+  uint32_t StockTicker::getSymbolPeriod(uint16_t index) const {
+    switch (this->schedules[index].tier) {
+      case SymbolTier::FAST:
+        return this->fastRequestPeriod;
+      case SymbolTier::SLOW:
+        return this->slowRequestPeriod;
+      default:
+        return isCryptoSymbol(this->allSymbolPrices[index].id)
+                 ? this->cryptoRequestPeriod
+                 : this->requestPeriod;
+    }
+  }
+
+  /**
+   * @brief Add the credit that came back since last time, up to the whole
+   *  window.
+   *
+   * @return true if there is enough for another request.
+   */
+  bool StockTicker::refillRateCredit() {
+    const uint32_t now = millis();
+    const uint32_t elapsed = min(now - this->lastCreditTime, RATE_LIMIT_WINDOW);
+    this->rateCredit = min(this->rateCredit + elapsed, RATE_LIMIT_WINDOW);
+    this->lastCreditTime = now;
+    return this->rateCredit >= RATE_LIMIT_WINDOW / RATE_LIMIT_REQUESTS;
+  }
+
+  /**
+   * @brief Find the symbol that is due first.
+   *
+   * @return uint16_t Its index, 0 if there are no symbols.
+   */
+  uint16_t StockTicker::getSoonestSymbol() const {
+    uint16_t soonest = 0;
+    for (uint16_t i = 1; i < this->symbolCount; i++) {
+      if (static_cast<int32_t>(this->schedules[i].nextDue -
+                               this->schedules[soonest].nextDue) < 0) {
+        soonest = i;
+      }
+    }
+    return soonest;
+  }
+
+  /**
+   * @brief Get when update() next has something to do: getting the provider
+   *  ready, requesting the soonest due symbol, or the rate limit letting that
+   *  request through.
+   *
+   * @return uint32_t millis() time, in the past if update() has something to
+   *  do now.
+   */
+  uint32_t StockTicker::getNextUpdateTime() const {
+    if (this->providerCount == 0 || this->symbolCount == 0) {
+      // Nothing to request, begin() or addProvider() come first anyway
+      return millis() + PROVIDER_PREFETCH_LEAD;
+    }
+    uint32_t next = this->schedules[this->getSoonestSymbol()].nextDue;
+    if (!this->prefetched) {
+      next -= PROVIDER_PREFETCH_LEAD;
+    }
+    // Credit comes back a millisecond per millisecond
+    const uint32_t cost = RATE_LIMIT_WINDOW / RATE_LIMIT_REQUESTS;
+    if (this->rateCredit < cost) {
+      const uint32_t credited = this->lastCreditTime + cost - this->rateCredit;
+      if (static_cast<int32_t>(credited - next) > 0) {
+        next = credited;
+      }
+    }
+    return next;
   }
+
   /**
    * @brief Update the StockTicker.
    *
    * This function should be called periodically to update the StockTicker. It
    * will check if it's time to make a request to the API and update the symbol
    * prices accordingly.
+   *
+   * Each symbol is refreshed on its own tier's period. When any symbol is
+   * due, every symbol due within a fraction of its period comes along, so
+   * slower symbols ride on the requests of faster ones. Stocks and crypto are
+   * requested back to back, and the display and saved prices are updated
+   * once for the whole poll.
    */
   void StockTicker::update() {
-    if (static_cast<int32_t>(millis() - this->nextRequestTime) < 0) {
-      return; // Not time to request yet
+    if (this->providerCount == 0 || this->symbolCount == 0) {
+      return;
     }
-    Serial1.println("Time to request data from Alpaca Markets API");
-
-    if (WiFi.status() != WL_CONNECTED) {
-      Serial1.println("No WiFi connection, cannot update stock prices.");
-      this->status = StockTickerStatus::ERROR_NO_WIFI;
-      RESCHEDULE_MACRO()
+    const uint32_t now = millis();
+    const uint16_t soonest = this->getSoonestSymbol();
+    const int32_t untilRequest =
+      static_cast<int32_t>(this->schedules[soonest].nextDue - now);
+    if (untilRequest > 0) {
+      // Not time to request yet, but let the provider get slow things out of
+      // the way so they aren't part of the request
+      if (!this->prefetched &&
+          untilRequest <= static_cast<int32_t>(PROVIDER_PREFETCH_LEAD)) {
+        this->prefetched = true;
+        const int8_t slot =
+          this->pickProvider(isCryptoSymbol(this->allSymbolPrices[soonest].id)
+                               ? AssetClass::CRYPTO
+                               : AssetClass::EQUITY);
+        if (slot >= 0) {
+          this->providers[slot].provider->prefetch(untilRequest);
+        }
+      }
+      return;
+    }
+    if (!this->refillRateCredit()) {
+      // Wait for room under the rate limit, the symbols stay due
       return;
     }
+    this->prefetched = false;
+    this->status = StockTickerStatus::OK;
+
+    #ifdef LOG_FREE_MEMORY
+    LOG_DEBUG("Free memory before request: heap %d kb, stack %d kb",
+              rp2040.getFreeHeap() / 1024, rp2040.getFreeStack() / 1024);
+    #endif
+    // In case the last poll returned before its reset
+    this->pollArena.reset();
+    memset(this->committed, 0, sizeof(this->committed));
+    // Anything due soon comes along now instead of needing its own request
+    bool batched[MAX_SYMBOLS] = {};
+    uint16_t batchedCount = 0;
+    for (uint16_t i = 0; i < this->symbolCount; i++) {
+      const int32_t untilDue =
+        static_cast<int32_t>(this->schedules[i].nextDue - now);
+      if (untilDue <= static_cast<int32_t>(this->getSymbolPeriod(i) /
+                                           BATCH_AHEAD_DIVISOR)) {
+        batched[i] = true;
+        batchedCount++;
+      }
+    }
+    // One deadline for every request of the poll, however many batches it
+    // takes
+    const uint32_t deadline = now + this->pollTimeout;
+    uint16_t requestCount =
+      this->requestBatches(AssetClass::EQUITY, batched, deadline);
+    requestCount += this->requestBatches(AssetClass::CRYPTO, batched, deadline);
+    this->pollCount++;
+    LOG_DEBUG("Poll took %u requests for %u of %u symbols",
+              requestCount, batchedCount, this->symbolCount);
 
+    // One commit for everything this poll got
+    uint16_t committedCount = 0;
+    for (uint16_t i = 0; i < this->symbolCount; i++) {
+      committedCount += this->committed[i];
+    }
+    if (committedCount > 0 && this->priceStore != nullptr) {
+      // Each symbol shows its new price as it next scrolls in
+      if (static_cast<int32_t>(millis() - this->nextPersistTime) >= 0) {
+        this->priceStore->save(this->allSymbolPrices, this->symbolCount);
+        this->nextPersistTime = millis() + PRICE_STORE_PERIOD;
+      }
+    }
+    if (millis() - this->lastAgeReport >= AGE_REPORT_PERIOD) {
+      this->logAgeHistograms();
+    }
+    LOG_DEBUG("Poll arena: %u of %u bytes used, high-water mark %u bytes, "
+              "%lu failed allocations since boot",
+              this->pollArena.getUsed(), POLL_ARENA_SIZE,
+              this->pollArena.getHighWaterMark(),
+              this->pollArena.getFailureCount());
+    this->pollArena.reset();
     #ifdef LOG_FREE_MEMORY
-    Serial1.printf("Free memory before request: heap %d kb, stack %d kb\n",
-                   rp2040.getFreeHeap() / 1024, rp2040.getFreeStack() / 1024);
+    LOG_DEBUG("Free memory after request: heap %d kb, stack %d kb",
+              rp2040.getFreeHeap() / 1024, rp2040.getFreeStack() / 1024);
     #endif
+  }
+
+  /**
+   * @brief Request every batched symbol of an asset class, packing as many
+   *  into each request as the symbols string allows. Each symbol requested is
+   *  rescheduled, whether or not its request worked.
+   *
+   * @param assetClass The asset class.
+   * @param batched Symbols (by index) to request, cleared as they are.
+   *  Symbols left over when the rate limit runs out or the deadline passes
+   *  stay set and due.
+   * @param deadline millis() time the poll has to be done by.
+   * @return uint16_t How many requests were made.
+   */
+  uint16_t StockTicker::requestBatches(AssetClass assetClass, bool* batched,
+                                       uint32_t deadline) {
+    uint16_t requestCount = 0;
+    while (true) {
+      char batchSymbols[MAX_SYMBOLS_STRING_LEN];
+      size_t len = 0;
+      bool inBatch[MAX_SYMBOLS] = {};
+      uint16_t count = 0;
+      for (uint16_t i = 0; i < this->symbolCount; i++) {
+        const char* id = this->allSymbolPrices[i].id;
+        if (!batched[i] ||
+            isCryptoSymbol(id) != (assetClass == AssetClass::CRYPTO)) {
+          continue;
+        }
+        const size_t idLen = strlen(id);
+        // Comma, symbol and terminator
+        if (len + (len > 0) + idLen + 1 > sizeof(batchSymbols)) {
+          continue; // Goes in the next request
+        }
+        if (len > 0) {
+          batchSymbols[len++] = ',';
+        }
+        memcpy(batchSymbols + len, id, idLen);
+        len += idLen;
+        inBatch[i] = true;
+        count++;
+      }
+      if (count == 0) {
+        return requestCount;
+      }
+      batchSymbols[len] = '\0';
+      if (static_cast<int32_t>(millis() - deadline) >= 0) {
+        // Out of date now, but they get their request next poll
+        uint16_t leftCount = 0;
+        for (uint16_t i = 0; i < this->symbolCount; i++) {
+          if (batched[i] && isCryptoSymbol(this->allSymbolPrices[i].id) ==
+                              (assetClass == AssetClass::CRYPTO)) {
+            this->allSymbolPrices[i].stale = true;
+            leftCount++;
+          }
+        }
+        LOG_WARN("Poll deadline of %lu ms expired, %u symbols wait for the "
+                 "next poll",
+                 this->pollTimeout, leftCount);
+        this->status = StockTickerStatus::ERROR_POLL_TIMEOUT;
+        return requestCount;
+      }
+      if (!this->refillRateCredit()) {
+        LOG_WARN("Rate limit reached, %u symbols wait for the next "
+                 "poll",
+                 count);
+        return requestCount;
+      }
+      this->rateCredit -= RATE_LIMIT_WINDOW / RATE_LIMIT_REQUESTS;
+      this->requestQuotes(assetClass, batchSymbols, inBatch, deadline);
+      requestCount++;
+      for (uint16_t i = 0; i < this->symbolCount; i++) {
+        if (inBatch[i]) {
+          batched[i] = false;
+          this->schedules[i].nextDue = millis() + this->getSymbolPeriod(i);
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Request the quotes for one asset class and parse them into the
+   *  table, marking each updated symbol in committed. The display isn't
+   *  updated.
+   *
+   * @param assetClass The asset class.
+   * @param symbols Comma-separated symbols, all of assetClass.
+   * @param inBatch Which symbols (by index) are in symbols.
+   * @param deadline millis() time the poll has to be done by, before now.
+   */
+  void StockTicker::requestQuotes(AssetClass assetClass, const char* symbols,
+                                  const bool* inBatch, uint32_t deadline) {
+    const char* className =
+      assetClass == AssetClass::CRYPTO ? "crypto" : "stock";
+    const int8_t slot = this->pickProvider(assetClass);
+    if (slot < 0) {
+      LOG_WARN("No provider for %s quotes", className);
+      return;
+    }
+    MarketDataProvider* provider = this->providers[slot].provider;
+    LOG_DEBUG("Time to request %s data from %s", className,
+              provider->getName());
+    const uint32_t requestStartTime = millis();
+    // Connecting and waiting for the response can't run past the poll's
+    // deadline either
+    const int32_t untilDeadline =
+      static_cast<int32_t>(deadline - requestStartTime);
+    const uint32_t remaining = untilDeadline > 0 ? untilDeadline : 0;
+    const ProviderRequest request = {
+      assetClass, symbols, min(this->connectTimeout, remaining),
+      min(this->firstByteTimeout, remaining), deadline, &this->pollArena};
+    bool succeeded = false;
     {
-      // Scope to destroy client and parser to print free memory after request
-      // https://data.alpaca.markets/v2/stocks/snapshots?symbols={SYMBOLS}&feed={FEED}
-      HTTPClient httpsClient;
-      httpsClient.setInsecure();
-      httpsClient.useHTTP10(true);
-      const size_t MAX_URL_LEN = 80 + MAX_SYMBOLS_STRING_LEN;
-      char url[MAX_URL_LEN];
-      snprintf(
-        url, MAX_URL_LEN,
-        "https://data.alpaca.markets/v2/stocks/snapshots?symbols=%s&feed=%s",
-        this->symbols, this->sourceFeed);
-      Serial1.printf("Requesting %s\n", url);
-      if (httpsClient.begin(url)) {
-        httpsClient.addHeader("Accept", "application/json");
-        httpsClient.addHeader("Apca-Api-Key-Id", this->apcaApiKeyId);
-        httpsClient.addHeader("Apca-Api-Secret-Key", this->apcaApiSecretKey);
-        int32_t statusCode = httpsClient.GET();
+      // Scope to destroy the stream wrappers before the request ends
+      const int32_t statusCode = provider->sendRequest(request);
+      #ifdef LOG_FREE_MEMORY
+      LOG_DEBUG(
+        "Free memory after sending request: heap %d kb, stack %d kb",
+        rp2040.getFreeHeap() / 1024, rp2040.getFreeStack() / 1024);
+      #endif
+      // Everything left of the poll's budget goes to reading the body. Under
+      // the buffer, so refilling it can't wait past the deadline.
+      DeadlineStream deadlineBody(provider->getBody(), request.deadline);
+      #ifdef BUFFER_JSON_READING
+      BasicReadBufferingStream<PollArenaStreamAllocator> bufferedBody(
+        deadlineBody, 256, PollArenaStreamAllocator{&this->pollArena});
+      Stream& body = bufferedBody;
+      #else
+      Stream& body = deadlineBody;
+      #endif
+      if (statusCode == 200) {
+        // OK
+        const bool gzipped = provider->isBodyGzipped();
+        // Inflated as it is parsed, the whole response is never in memory
+        InflateStream inflater(body);
+        Stream& jsonSource = gzipped ? static_cast<Stream&>(inflater) : body;
+        const uint32_t parseStartTime = millis();
+        #ifdef LOG_JSON_PARSED
+        LOG_DEBUG("JSON read:");
+        ReadLoggingStream loggingStream(jsonSource, Log::logger);
+        DeserializationError error =
+          provider->parseBody(loggingStream, request, *this);
+        Log::logger.println();
+        #else
+        DeserializationError error =
+          provider->parseBody(jsonSource, request, *this);
+        #endif
+        // The parser stops at the end of the document, the trailer after it
+        // says if that was what the server sent
+        if (gzipped && !error) {
+          inflater.finish();
+        }
+        const uint32_t parseEndTime = millis();
+        // Bytes on air is the body only, headers are the same either way
+        const uint32_t bodySize =
+          static_cast<uint32_t>(max(provider->getBodySize(), 0));
+        LOG_DEBUG(
+          "Response %s: %lu bytes on air, %lu bytes of JSON, radio on for "
+          "%lu ms, parse took %lu ms",
+          gzipped ? "gzipped" : "not compressed",
+          gzipped ? inflater.getBytesIn() : bodySize,
+          gzipped ? inflater.getBytesOut() : bodySize,
+          parseEndTime - requestStartTime, parseEndTime - parseStartTime);
+        if (gzipped && inflater.hasFailed() && !deadlineBody.hasExpired()) {
+          LOG_ERROR("Failed to decompress response");
+        }
         #ifdef LOG_FREE_MEMORY
-        Serial1.printf(
-          "Free memory after sending request: heap %d kb, stack %d kb\n",
+        LOG_DEBUG(
+          "Free memory after JSON parse: heap %d kb, stack %d kb",
           rp2040.getFreeHeap() / 1024, rp2040.getFreeStack() / 1024);
         #endif
-        #ifdef BUFFER_JSON_READING
-        ReadBufferingClient bufferedClient(httpsClient.getStream(), 256);
-        #endif
-        if (statusCode == 200) {
-          // OK
-          JsonDocument doc;
-          #ifdef LOG_JSON_PARSED
-          Serial1.println("JSON read:");
-          #ifdef BUFFER_JSON_READING
-          ReadLoggingStream loggingStream(bufferedClient, Serial1);
-          #else
-          ReadLoggingStream loggingStream(httpsClient.getStream(), Serial1);
-          #endif
-          DeserializationError error = deserializeJson(doc, loggingStream);
-          Serial1.println("");
-          #else
-          #ifdef BUFFER_JSON_READING
-          DeserializationError error = deserializeJson(doc, bufferedClient);
-          #else
-          DeserializationError error =
-            deserializeJson(doc, httpsClient.getStream());
-          #endif
-          #endif
-          #ifdef LOG_FREE_MEMORY
-          Serial1.printf(
-            "Free memory after JSON parse: heap %d kb, stack %d kb\n",
-            rp2040.getFreeHeap() / 1024, rp2040.getFreeStack() / 1024);
-          #endif
-          if (error) {
-            Serial1.printf("Failed to parse JSON: %s\n", error.c_str());
-            this->status = StockTickerStatus::ERROR_BAD_JSON_RESPONSE;
-          } else {
-            for (JsonPair snapshot : doc.as<JsonObject>()) {
-              const char* symbol = snapshot.key().c_str();
-              JsonObject daily_bar = snapshot.value()["dailyBar"];
-              float open_price = daily_bar["o"]; // Start of day price
-              float close_price = daily_bar["c"]; // End of day / current price
-              this->updateSymbolPriceInMemory(
-                symbol, close_price, close_price - open_price,
-                ((close_price - open_price) / open_price) * 100.0f);
+        if (deadlineBody.hasExpired()) {
+          uint16_t batchCount = 0;
+          uint16_t committedCount = 0;
+          for (uint16_t i = 0; i < this->symbolCount; i++) {
+            if (!inBatch[i]) {
+              continue;
             }
-            this->updateDisplayStr();
-          }
-        } else {
-          Serial1.printf("Bad status code: %d\n", statusCode);
-          switch (statusCode) {
-            case HTTPC_ERROR_CONNECTION_FAILED: {
-              Serial1.println("Connection failed, check WiFi connection");
-              this->status = StockTickerStatus::ERROR_CONNECTION_FAILED;
-              break;
+            batchCount++;
+            if (this->committed[i]) {
+              committedCount++;
+            } else {
+              // Keeps its old price but it's out of date now
+              this->allSymbolPrices[i].stale = true;
             }
-            case HTTPC_ERROR_SEND_HEADER_FAILED: {
-              Serial1.println("Failed to send header, check WiFi connection");
-              this->status = StockTickerStatus::ERROR_SEND_HEADER_FAILED;
-              break;
-            }
-            case HTTPC_ERROR_SEND_PAYLOAD_FAILED: {
-              Serial1.println("Failed to send payload, check WiFi connection");
-              this->status = StockTickerStatus::ERROR_SEND_PAYLOAD_FAILED;
-              break;
-            }
-            case 400: {
-              Serial1.println("Bad request, check API key and secret");
-              this->status = StockTickerStatus::ERROR_BAD_REQUEST;
-              break;
-            }
-            case 403: {
-              Serial1.println("Forbidden, check API key and secret");
-              this->status = StockTickerStatus::ERROR_FORBIDDEN;
-              break;
-            }
-            case 429: {
-              Serial1.println("Too many requests, check request period");
-              this->status = StockTickerStatus::ERROR_TOO_MANY_REQUESTS;
-              break;
-            }
-            case 500: {
-              Serial1.println("Internal server error, check Alpaca Markets' "
-                "Slack or Community Forum and try again later");
-              this->status = StockTickerStatus::ERROR_INTERNAL_SERVER_ERROR;
-              break;
+          }
+          LOG_WARN("Poll deadline of %lu ms expired, got %u of %u %s "
+                   "symbols",
+                   this->pollTimeout, committedCount, batchCount, className);
+          this->status = StockTickerStatus::ERROR_POLL_TIMEOUT;
+        } else if (error) {
+          LOG_ERROR("Failed to parse JSON: %s", error.c_str());
+          this->status = StockTickerStatus::ERROR_BAD_JSON_RESPONSE;
+        } else if (gzipped && inflater.hasFailed()) {
+          // Parsed, but not what the server sent. The quotes are already in
+          // the table, so all there is to do is not trust them.
+          for (uint16_t i = 0; i < this->symbolCount; i++) {
+            if (inBatch[i] && this->committed[i]) {
+              this->allSymbolPrices[i].stale = true;
+              this->committed[i] = false;
             }
-            default: {
-              Serial1.printf("Unknown error, status code: %d\n", statusCode);
-              this->status = StockTickerStatus::ERROR_UNKNOWN;
+          }
+          this->status = StockTickerStatus::ERROR_BAD_JSON_RESPONSE;
+        } else {
+          succeeded = true;
+        }
+      } else {
+        LOG_ERROR("Bad status code: %d", statusCode);
+        this->status = provider->mapError(
+          statusCode, millis() - requestStartTime, request);
+        if (statusCode > 0) {
+          // Logged as one line, cut off if it's long
+          char response[MAX_LOG_RESPONSE_LEN];
+          size_t responseLen = 0;
+          while (responseLen < sizeof(response) - 1 && body.available()) {
+            const int c = body.read();
+            if (c < 0) {
               break;
             }
+            response[responseLen++] = static_cast<char>(c);
           }
-          Serial1.println("Response: ");
-          #ifdef BUFFER_JSON_READING
-          while (bufferedClient.available()) {
-            Serial1.write(bufferedClient.read());
-          }
-          #else
-          while (httpsClient.getStream().available()) {
-            Serial1.write(httpsClient.getStream().read());
-          }
-          #endif
-          return;
+          response[responseLen] = '\0';
+          LOG_ERROR("Response: %s", response);
         }
-      } else {
-        Serial1.println("Failed to initialize request");
-        this->status = StockTickerStatus::ERROR_INIT_REQUEST_FAILED;
       }
     }
-    #ifdef LOG_FREE_MEMORY
-    Serial1.printf("Free memory after request: heap %d kb, stack %d kb\n",
-                   rp2040.getFreeHeap() / 1024, rp2040.getFreeStack() / 1024);
-    #endif
-
-    this->status = StockTickerStatus::OK;
-    RESCHEDULE_MACRO()
+    provider->endRequest();
+    const uint32_t serverTime = provider->getServerTime();
+    if (serverTime != 0) {
+      this->clockEpoch = serverTime;
+      this->clockMillis = millis();
+    }
+    // A failed request counts as taking the whole deadline so a provider that
+    // fails fast isn't picked for it
+    this->recordLatency(slot, succeeded ? millis() - requestStartTime
+                                        : this->pollTimeout);
   }
-  #undef RESCHEDULE_MACRO
 
   /**
    * @brief Updates the symbol with new price, change, and change percent
-   * data.
+   * data, and adds the price to its history.
    *
    * @param id The symbol of the stock.
    * @param price The new price of the stock.
    * @param change The change in price of the stock.
    * @param changePercent The change percent of the stock.
+   * @param exchangeTime Seconds since 1970 UTC the exchange gave the price, 0
+   *  if not known.
+   * @return int32_t The symbol's index, or -1 if it isn't being tracked.
    */
-  void StockTicker::updateSymbolPriceInMemory(const char* id, float price,
-                                              float change,
-                                              float changePercent) {
-    for (auto& allSymbolPrice : this->allSymbolPrices) {
+  int32_t StockTicker::updateSymbolPriceInMemory(const char* id, float price,
+                                                 float change,
+                                                 float changePercent,
+                                                 uint32_t exchangeTime) {
+    for (uint16_t i = 0; i < this->symbolCount; i++) {
+      SymbolPrice& allSymbolPrice = this->allSymbolPrices[i];
       if (strcmp(allSymbolPrice.id, id) == 0) {
         allSymbolPrice.price = price;
         allSymbolPrice.change = change;
         allSymbolPrice.changePercent = changePercent;
-        Serial1.printf("Updated symbol %s in symbol data list (price: %.2f, "
-                       "change: %.2f, changePercent: %.2f%%)\n",
-                       allSymbolPrice.id, price, change, changePercent);
-        return;
+        allSymbolPrice.stale = false;
+        allSymbolPrice.exchangeTime = exchangeTime;
+        allSymbolPrice.receivedAt = millis();
+        allSymbolPrice.received = true;
+        allSymbolPrice.displayPending = exchangeTime != 0;
+        this->priceHistories[i].append(price);
+        LOG_DEBUG("Updated symbol %s in symbol data list (price: %.2f, "
+                  "change: %.2f, changePercent: %.2f%%)",
+                  allSymbolPrice.id, price, change, changePercent);
+        return i;
       }
     }
-    Serial1.printf("Symbol %s not found in symbol data list\n", id);
+    LOG_WARN("Symbol %s not found in symbol data list", id);
+    return -1;
   }
 
   /**
-   * @brief Updates the stock string to display.
+   * @brief Take a quote from the provider and mark its symbol as updated by
+   *  this poll.
    */
-  void StockTicker::updateDisplayStr() {
-    memset(displayStr, 0, MAX_DISPLAY_STR_LEN);
-    char* ptr = displayStr;
+  void StockTicker::addQuote(const char* symbol, float price, float change,
+                             float changePercent, uint32_t exchangeTime) {
+    const int32_t index = this->updateSymbolPriceInMemory(
+      symbol, price, change, changePercent, exchangeTime);
+    if (index >= 0) {
+      this->committed[index] = true;
+    }
+  }
+
+  /**
+   * @brief Check if a symbol's price is out of date, either because it was
+   *  restored or cut off a poll and not updated since, or because
+   *  STALE_AFTER_PERIODS of its periods passed without a new one.
+   *
+   * @param index The symbol's index.
+   * @return true if it is stale.
+   */
+  bool StockTicker::isSymbolStale(uint16_t index) const {
+    const SymbolPrice& symbolPrice = this->allSymbolPrices[index];
+    if (symbolPrice.stale) {
+      return true;
+    }
+    return symbolPrice.received &&
+           millis() - symbolPrice.receivedAt >
+             STALE_AFTER_PERIODS * this->getSymbolPeriod(index);
+  }
+
+  /**
+   * @brief Count how old a symbol's price is as it scrolls onto the display,
+   *  if it is a new price. Prices without an exchange time, or before the
+   *  server's time is known, aren't counted.
+   *
+   * @param index The symbol's index.
+   */
+  void StockTicker::recordDisplayAge(uint16_t index) {
+    SymbolPrice& symbolPrice = this->allSymbolPrices[index];
+    const uint32_t now = this->getEpochTime();
+    if (!symbolPrice.displayPending || now == 0) {
+      return;
+    }
+    symbolPrice.displayPending = false;
+    // The server's clock is only to the second, a price can look like it came
+    // from the future
+    this->ageHistograms[index].record(
+      static_cast<int32_t>(now - symbolPrice.exchangeTime) > 0
+        ? now - symbolPrice.exchangeTime
+        : 0);
+  }
+
+  /**
+   * @brief Log every symbol's age histogram.
+   */
+  void StockTicker::logAgeHistograms() {
+    this->lastAgeReport = millis();
+    LOG_INFO("Price age from exchange to display:");
     for (uint16_t i = 0; i < this->symbolCount; i++) {
-      size_t charsWritten = 0;
-      if (allSymbolPrices[i].price > 0) {
-        char sign = '+';
-        if (allSymbolPrices[i].change < 0) {
-          sign = '-';
-        }
-        charsWritten =
-          snprintf(ptr, MAX_SYMBOL_DISPLAY_STR_LEN,
-                   "%s: $%.2f %+.2f%% (%c$%.2f)    ", allSymbolPrices[i].id,
-                   allSymbolPrices[i].price, allSymbolPrices[i].changePercent,
-                   sign, abs(allSymbolPrices[i].change));
+      char histogram[160];
+      this->ageHistograms[i].print(histogram, sizeof(histogram));
+      LOG_INFO("  %s: %s", this->allSymbolPrices[i].id, histogram);
+    }
+  }
+
+  /**
+   * @brief Writes how long ago a stale symbol's price was received, like
+   *  " [12m old]", or " [saved]" if it was restored from before a reboot.
+   *
+   * @param str Where to write it.
+   * @param maxLen The size of str, including the null terminator.
+   * @param index The symbol's index.
+   * @return size_t The number of characters written, not including the null
+   *  terminator.
+   */
+  size_t StockTicker::writeAge(char* str, size_t maxLen, uint16_t index) {
+    const SymbolPrice& symbolPrice = this->allSymbolPrices[index];
+    int written;
+    if (!symbolPrice.received) {
+      written = snprintf(str, maxLen, " [saved]");
+    } else {
+      const uint32_t age = (millis() - symbolPrice.receivedAt) / 1000;
+      if (age < 60) {
+        written = snprintf(str, maxLen, " [%lus old]", age);
+      } else if (age < 60 * 60) {
+        written = snprintf(str, maxLen, " [%lum old]", age / 60);
+      } else if (age < 24 * 60 * 60) {
+        written = snprintf(str, maxLen, " [%luh old]", age / (60 * 60));
       } else {
-        // No data yet cause price is negative
-        charsWritten =
-          snprintf(ptr, MAX_SYMBOL_DISPLAY_STR_LEN, "%s: No data yet...    ",
-                   allSymbolPrices[i].id);
+        written = snprintf(str, maxLen, " [%lud old]", age / (24 * 60 * 60));
+      }
+    }
+    return maxLen > 0 ? min(static_cast<size_t>(max(written, 0)), maxLen - 1)
+                      : 0;
+  }
+
+  /**
+   * @brief Write a symbol's text to scroll from its latest price, stale prices
+   *  are followed by how old they are.
+   *
+   * @param index The symbol's index.
+   * @param str Where to write it.
+   * @param maxLen The size of str, including the null terminator.
+   * @return size_t The number of characters written, not including the null
+   *  terminator.
+   */
+  size_t StockTicker::writeSegment(uint16_t index, char* str, size_t maxLen) {
+    if (index >= this->symbolCount || maxLen == 0) {
+      return 0;
+    }
+    maxLen = min(maxLen, MAX_SYMBOL_DISPLAY_STR_LEN);
+    const SymbolPrice& symbolPrice = this->allSymbolPrices[index];
+    size_t charsWritten = 0;
+    if (symbolPrice.price > 0) {
+      char sign = '+';
+      char arrow = MD_MAX72XX_Font::UP_ARROW;
+      if (symbolPrice.change < 0) {
+        sign = '-';
+        arrow = MD_MAX72XX_Font::DOWN_ARROW;
+      }
+      charsWritten = snprintf(str, maxLen, "%s: $%.2f %c%.2f%% (%c$%.2f)",
+                              symbolPrice.id, symbolPrice.price, arrow,
+                              abs(symbolPrice.changePercent), sign,
+                              abs(symbolPrice.change));
+      charsWritten = min(charsWritten, maxLen - 1);
+      if (this->isSymbolStale(index)) {
+        charsWritten += this->writeAge(str + charsWritten,
+                                       maxLen - charsWritten, index);
+      }
+      if (this->displayMode == DisplayMode::SPARKLINE) {
+        charsWritten +=
+          this->writeSparkline(str + charsWritten, maxLen - charsWritten,
+                               this->priceHistories[index]);
+      }
+      charsWritten +=
+        snprintf(str + charsWritten, maxLen - charsWritten, "    ");
+      this->recordDisplayAge(index);
+    } else {
+      // No data yet cause price is negative
+      charsWritten =
+        snprintf(str, maxLen, "%s: No data yet...    ", symbolPrice.id);
+    }
+    return min(charsWritten, maxLen - 1);
+  }
+
+  /**
+   * @brief Writes a space and a sparkline of a price history, one column per
+   *  sample scaled between the lowest and highest price.
+   *
+   * @param str Where to write the sparkline.
+   * @param maxLen The size of str, including the null terminator.
+   * @param history The price history to draw.
+   * @return size_t The number of characters written, not including the null
+   *  terminator.
+   */
+  size_t StockTicker::writeSparkline(char* str, size_t maxLen,
+                                     const SymbolHistory& history) {
+    int32_t samples[SymbolHistory::MAX_SAMPLES];
+    const uint16_t sampleCount =
+      history.getSamples(samples, SymbolHistory::MAX_SAMPLES);
+    // Need a space, at least two samples to show a trend, and a terminator
+    if (sampleCount < 2 || maxLen < 3) {
+      return 0;
+    }
+    int32_t lowest = samples[0];
+    int32_t highest = samples[0];
+    for (uint16_t i = 1; i < sampleCount; i++) {
+      lowest = min(lowest, samples[i]);
+      highest = max(highest, samples[i]);
+    }
+    const uint8_t topLevel = MD_MAX72XX_Font::SPARKLINE_LEVELS - 1;
+    size_t len = 0;
+    str[len++] = ' ';
+    for (uint16_t i = 0; i < sampleCount && len < maxLen - 1; i++) {
+      // A flat history is drawn through the middle
+      uint8_t level = topLevel / 2;
+      if (highest > lowest) {
+        level = static_cast<uint8_t>(
+          (static_cast<int64_t>(samples[i] - lowest) * topLevel) /
+          (highest - lowest));
       }
-      ptr += charsWritten;
+      str[len++] = MD_MAX72XX_Font::sparklineChar(level);
     }
-    Serial1.println("Display string updated:");
-    Serial1.println(displayStr);
+    str[len] = '\0';
+    return len;
   }
 } // StockTicker
@@ -15,18 +15,50 @@
   #define BUFFER_JSON_READING
 #endif
 
+#include <AgeHistogram.h>
 #include <Arduino.h>
 #include <ArduinoJson.h>
-#include <HTTPClient.h>
+#include <DeadlineStream.h>
+#include <InflateStream.h>
+#include <Log.h>
+#include <MD_MAX72xx_Font.h>
+#include <MD_MAX72xx_SegmentSource.h>
+#include <MarketDataProvider.h>
+#include <PollArena.h>
+#include <PriceHistory.h>
 #include <StreamUtils.h>
-#include <WiFi.h>
 
 namespace StockTicker {
   const size_t MAX_ID_LEN = 32;
   const size_t MAX_SYMBOLS_STRING_LEN = 256;
   const uint16_t MAX_SYMBOLS = 64;
-  const size_t MAX_SYMBOL_DISPLAY_STR_LEN = 64;
-  const size_t MAX_DISPLAY_STR_LEN = MAX_SYMBOLS * MAX_SYMBOL_DISPLAY_STR_LEN;
+  // Room for the price text and a sparkline of the whole history
+  const size_t MAX_SYMBOL_DISPLAY_STR_LEN = MD_MAX72XX_MAX_SEGMENT_LEN;
+  // How long before a request to let the provider get ready, like looking up
+  // its host if the cached address is about to expire
+  const uint32_t PROVIDER_PREFETCH_LEAD = 2000;
+  const uint8_t MAX_PROVIDERS = 4;
+  // Every this many polls the least recently used provider is tried again, in
+  // case it got faster
+  const uint32_t PROVIDER_PROBE_PERIOD = 20;
+  // A symbol due within this fraction of its period joins a poll that is
+  // already happening instead of needing a request of its own later
+  const uint32_t BATCH_AHEAD_DIVISOR = 4;
+  // Alpaca's free plan allows 200 requests a minute, requests past that are
+  // held back until there is room again
+  const uint32_t RATE_LIMIT_REQUESTS = 200;
+  const uint32_t RATE_LIMIT_WINDOW = 60 * 1000;
+  const char SYMBOL_TIER_SEPARATOR = ':';
+  // A symbol is shown as stale once this many of its periods pass without a
+  // new price, like after failed requests
+  const uint32_t STALE_AFTER_PERIODS = 3;
+  // How often to log the age histograms
+  const uint32_t AGE_REPORT_PERIOD = 10 * 60 * 1000;
+  // Most of an error response body that is logged
+  const size_t MAX_LOG_RESPONSE_LEN = 256;
+
+  static_assert(MAX_SYMBOLS == PRICE_HISTORY_SYMBOLS,
+                "PRICE_HISTORY_SYMBOLS should match MAX_SYMBOLS");
 
   // clang-format off
   struct SymbolPrice {
@@ -34,41 +66,87 @@ namespace StockTicker {
     float price;
     float change;
     float changePercent;
+    // True if restored from before a reboot or left out of a poll that ran
+    // out of time, and not updated since
+    bool stale;
+    // Seconds since 1970 UTC the exchange gave the price, 0 if not known
+    uint32_t exchangeTime;
+    // millis() when the price was received, only if received
+    uint32_t receivedAt;
+    // False until a price is received, restored prices don't count
+    bool received;
+    // True from receiving a price with an exchange time until it is scrolled
+    // onto the display
+    bool displayPending;
   };
   // clang-format on
 
   /**
-   * @brief Status codes for the StockTicker class.
+   * @brief How often a symbol is refreshed, written after the symbol like
+   *  "AAPL:fast". Symbols without one are NORMAL.
+   */
+  enum class SymbolTier : uint8_t {
+    // Every fast request period, for symbols that move a lot
+    FAST,
+    // Every request period (or crypto request period for crypto)
+    NORMAL,
+    // Every slow request period, for symbols that are only held
+    SLOW
+  };
+
+  /**
+   * @brief When a symbol is next refreshed.
    */
-  enum class StockTickerStatus {
-    OK,
-    ERROR_NO_WIFI,
-    ERROR_INIT_REQUEST_FAILED,
-    ERROR_CONNECTION_FAILED,
-    ERROR_SEND_HEADER_FAILED,
-    ERROR_SEND_PAYLOAD_FAILED,
-    ERROR_BAD_JSON_RESPONSE,
-    ERROR_BAD_REQUEST,
-    ERROR_FORBIDDEN,
-    ERROR_TOO_MANY_REQUESTS,
-    ERROR_INTERNAL_SERVER_ERROR,
-    ERROR_UNKNOWN
+  struct SymbolSchedule {
+      SymbolTier tier;
+      // millis() time it is due
+      uint32_t nextDue;
   };
 
+  /**
+   * @brief What to show for each symbol.
+   */
+  enum class DisplayMode {
+    // Price, change and change percent
+    PRICES,
+    // Same as PRICES followed by a sparkline of the price history
+    SPARKLINE
+  };
+
+  class PriceStore;
+
   uint16_t stockSymbolsCount(const char* symbolsString);
+  bool isCryptoSymbol(const char* symbol);
+  bool splitSymbolTier(char* token, SymbolTier& tier);
 
   /**
-   * @brief StockTicker class to fetch and display stock prices from Alpaca
-   *  Markets' Market Data API
+   * @brief StockTicker class to fetch and display stock prices from one or
+   *  more market data providers.
+   *
+   * Each symbol is one segment to scroll, its text is written from the
+   * latest price as it scrolls in.
    */
-  class StockTicker {
+  class StockTicker : public MD_MAX72XX_SegmentSource, protected QuoteSink {
     public:
       StockTicker() = default;
       ~StockTicker() = default;
 
-      void begin(const char* apiKeyId, const char* apiSecretKey,
-                 const char* symbolsString, const char* feed = "iex",
-                 uint32_t request = 60 * 1000);
+      void begin(const char* symbolsString, uint32_t request = 60 * 1000,
+                 uint32_t cryptoRequest = 60 * 1000);
+      bool addProvider(MarketDataProvider* provider);
+
+      /**
+       * @brief Set where prices are saved now and then and restored from in
+       *  begin(), call before begin().
+       *
+       * @param store The store, must stay valid while the StockTicker is
+       *  used. nullptr (the default) saves and restores nothing, like in
+       *  tests.
+       */
+      void setPriceStore(PriceStore* store) {
+        this->priceStore = store;
+      }
+
       /**
        * @brief Deinitialize.
        */
@@ -77,16 +155,21 @@ namespace StockTicker {
       };
 
       void update();
+      uint32_t getNextUpdateTime() const;
+      bool isSymbolStale(uint16_t index) const;
+      void logAgeHistograms();
 
       /**
-       * @brief Get a pointer to the string to display.
+       * @brief Get how many segments there are to scroll, one per symbol.
        *
-       * @return const char*
+       * @return uint16_t
        */
-      const char* getDisplayStr() const {
-        return this->displayStr;
+      uint16_t getSegmentCount() override {
+        return this->symbolCount;
       }
 
+      size_t writeSegment(uint16_t index, char* str, size_t maxLen) override;
+
       /**
        * @brief Get the current status of the StockTicker.
        *
@@ -96,34 +179,202 @@ namespace StockTicker {
         return this->status;
       }
 
+      /**
+       * @brief Set how long each part of a request may take, takes effect on
+       *  the next request.
+       *
+       * @param connect Milliseconds to connect, including TLS.
+       * @param firstByte Milliseconds from sending the request to the start
+       *  of the response.
+       * @param total Milliseconds for the whole poll, every request in it
+       *  from connecting to the end of the response.
+       */
+      void setDeadlines(uint32_t connect, uint32_t firstByte, uint32_t total) {
+        this->connectTimeout = connect;
+        this->firstByteTimeout = firstByte;
+        this->pollTimeout = total;
+      }
+
+      /**
+       * @brief Set how often the fast and slow tiers are refreshed, takes
+       *  effect as each symbol is next refreshed.
+       *
+       * @param fast Milliseconds between refreshes of FAST symbols.
+       * @param slow Milliseconds between refreshes of SLOW symbols.
+       */
+      void setTierPeriods(uint32_t fast, uint32_t slow) {
+        this->fastRequestPeriod = fast;
+        this->slowRequestPeriod = slow;
+      }
+
+      /**
+       * @brief Set what to show for each symbol, takes effect from the next
+       *  symbol to scroll in.
+       *
+       * @param mode The display mode.
+       */
+      void setDisplayMode(DisplayMode mode) {
+        this->displayMode = mode;
+      }
+
+      /**
+       * @brief Get the number of bytes used by the price histories of all
+       *  symbols.
+       *
+       * @return size_t
+       */
+      size_t getHistoryMemoryUsage() const {
+        return sizeof(this->priceHistories);
+      }
+
+      /**
+       * @brief Get how many symbols are tracked.
+       *
+       * @return uint16_t
+       */
+      uint16_t getSymbolCount() const {
+        return this->symbolCount;
+      }
+
+      /**
+       * @brief Get a symbol's price and when it was received.
+       *
+       * @param index 0 to getSymbolCount() - 1.
+       * @return const SymbolPrice&
+       */
+      const SymbolPrice& getSymbolPrice(uint16_t index) const {
+        return this->allSymbolPrices[index];
+      }
+
+      /**
+       * @brief Get how old a symbol's prices were when they scrolled onto the
+       *  display, from the exchange's timestamp.
+       *
+       * @param index 0 to getSymbolCount() - 1.
+       * @return const AgeHistogram&
+       */
+      const AgeHistogram& getAgeHistogram(uint16_t index) const {
+        return this->ageHistograms[index];
+      }
+
+      /**
+       * @brief Get the time now according to the last server response.
+       *
+       * @return uint32_t Seconds since 1970 UTC, or 0 if not known yet.
+       */
+      uint32_t getEpochTime() const {
+        return this->clockEpoch != 0
+                 ? this->clockEpoch + (millis() - this->clockMillis) / 1000
+                 : 0;
+      }
+
+      /**
+       * @brief Get the arena each poll's JSON document and buffers come from,
+       *  for its usage stats.
+       *
+       * @return const PollArena&
+       */
+      const PollArena& getPollArena() const {
+        return this->pollArena;
+      }
+
       /**
        * @brief Signal an immediate refresh of the stock prices on the next
        *  StockTicker::StockTicker.update();
        */
       void refreshOnNextUpdate() {
-        this->nextRequestTime = 0; // Force immediate refresh
+        // Force immediate refresh
+        for (uint16_t i = 0; i < this->symbolCount; i++) {
+          this->schedules[i].nextDue = millis();
+        }
       }
 
     protected:
-      const char* apcaApiKeyId;
-      const char* apcaApiSecretKey;
+      /**
+       * @brief A provider and how fast it has been.
+       */
+      struct ProviderSlot {
+          MarketDataProvider* provider;
+          // Smoothed milliseconds per poll, from connecting to the end of
+          // the response, failed polls count as the whole poll deadline
+          uint32_t averageLatency;
+          uint32_t lastUsedPoll;
+          bool measured;
+      };
+
+      ProviderSlot providers[MAX_PROVIDERS];
+      uint8_t providerCount = 0;
+      uint32_t pollCount = 0;
+
+      int8_t pickProvider(AssetClass assetClass) const;
+      void recordLatency(int8_t slot, uint32_t latency);
 
       const char* symbols;
       SymbolPrice allSymbolPrices[MAX_SYMBOLS];
+      // Same index as allSymbolPrices, one sample per successful request
+      SymbolHistory priceHistories[MAX_SYMBOLS];
+      // Same index as allSymbolPrices
+      SymbolSchedule schedules[MAX_SYMBOLS];
+      // Same index as allSymbolPrices
+      AgeHistogram ageHistograms[MAX_SYMBOLS];
       uint16_t symbolCount = 0;
 
-      void updateSymbolPriceInMemory(const char* id, float price, float change,
-                                     float changePercent);
+      void setSymbols(const char* symbolsString);
+      void swapSymbols(uint16_t a, uint16_t b);
+      int32_t updateSymbolPriceInMemory(const char* id, float price,
+                                        float change, float changePercent,
+                                        uint32_t exchangeTime);
+      void addQuote(const char* symbol, float price, float change,
+                    float changePercent, uint32_t exchangeTime) override;
+      // Symbols (by index) updated by the current poll
+      bool committed[MAX_SYMBOLS];
+
+      uint16_t requestBatches(AssetClass assetClass, bool* batched,
+                              uint32_t deadline);
+      void requestQuotes(AssetClass assetClass, const char* symbols,
+                         const bool* inBatch, uint32_t deadline);
+      uint32_t getSymbolPeriod(uint16_t index) const;
 
-      const char* sourceFeed;
       uint32_t requestPeriod;
-      uint32_t nextRequestTime = 0;
+      // Crypto trades around the clock, so it has its own schedule
+      uint32_t cryptoRequestPeriod;
+      uint32_t fastRequestPeriod = 15 * 1000;
+      uint32_t slowRequestPeriod = 5 * 60 * 1000;
+      PriceStore* priceStore = nullptr;
+      uint32_t nextPersistTime = 0;
+
+      // Milliseconds of requests that can be made right away, each one
+      // costs RATE_LIMIT_WINDOW / RATE_LIMIT_REQUESTS
+      uint32_t rateCredit = RATE_LIMIT_WINDOW;
+      uint32_t lastCreditTime = 0;
+
+      bool refillRateCredit();
+      uint16_t getSoonestSymbol() const;
+
+      uint32_t connectTimeout = 5000;
+      uint32_t firstByteTimeout = 5000;
+      uint32_t pollTimeout = 15000;
+
+      // If the provider was told to get ready for the next request yet
+      bool prefetched = false;
+
+      // Server time from the last response that had one, and millis() then
+      uint32_t clockEpoch = 0;
+      uint32_t clockMillis = 0;
+
+      uint32_t lastAgeReport = 0;
+
+      // Reset after every poll, nothing allocated from it outlives update()
+      PollArena pollArena;
 
       StockTickerStatus status = StockTickerStatus::OK;
 
-      char displayStr[MAX_DISPLAY_STR_LEN];
+      DisplayMode displayMode = DisplayMode::PRICES;
 
-      void updateDisplayStr();
+      void recordDisplayAge(uint16_t index);
+      size_t writeAge(char* str, size_t maxLen, uint16_t index);
+      size_t writeSparkline(char* str, size_t maxLen,
+                            const SymbolHistory& history);
   };
 } // StockTicker
 
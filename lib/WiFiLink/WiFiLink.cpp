@@ -0,0 +1,191 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#include <Checksum.h>
+#include <WiFiLink.h>
+
+namespace WiFiLink {
+  /**
+   * @brief Start keeping the link to a network up. Can be called again to
+   *  switch networks.
+   *
+   * @param ssid The network's SSID, must stay valid until end().
+   * @param password The network's password, must stay valid until end().
+   */
+  void WiFiLinkManager::begin(const char* ssid, const char* password) {
+    if (this->state != LinkState::IDLE) {
+      WiFi.disconnect();
+    }
+    this->ssid = ssid;
+    this->password = password;
+    this->stats = {};
+    this->everConnected = false;
+    this->backoff = FIRST_BACKOFF;
+    this->loadCache();
+    this->startAttempt();
+  }
+
+  /**
+   * @brief Disconnect and stop reconnecting.
+   */
+  void WiFiLinkManager::end() {
+    WiFi.disconnect();
+    this->state = LinkState::IDLE;
+  }
+
+  /**
+   * @brief Check on the link and start another attempt if it's time. Never
+   *  blocks, call this every loop.
+   *
+   * @return true if the link just came up.
+   */
+  bool WiFiLinkManager::update() {
+    switch (this->state) {
+      case LinkState::IDLE:
+        break;
+      case LinkState::CONNECTING: {
+        const int status = WiFi.status();
+        if (status == WL_CONNECTED) {
+          this->linkUp();
+          return true;
+        }
+        if (status == WL_CONNECT_FAILED || status == WL_NO_SSID_AVAIL ||
+            millis() - this->attemptStartTime >= CONNECT_TIMEOUT) {
+          this->attemptFailed();
+        }
+        break;
+      }
+      case LinkState::CONNECTED:
+        if (WiFi.status() != WL_CONNECTED) {
+          this->stats.dropCount++;
+          LOG_WARN("WiFi link dropped (%lu drops), reconnecting",
+                   this->stats.dropCount);
+          this->startAttempt(); // Brief outages usually come right back
+        }
+        break;
+      case LinkState::BACKOFF:
+        if (static_cast<int32_t>(millis() - this->nextAttemptTime) >= 0) {
+          this->startAttempt();
+        }
+        break;
+    }
+    return false;
+  }
+
+  void WiFiLinkManager::startAttempt() {
+    this->usingCache = this->cacheValid;
+    this->stats.attemptCount++;
+    if (this->usingCache) {
+      this->stats.cachedAttemptCount++;
+      LOG_INFO("Connecting to %s through cached access point "
+               "%02X:%02X:%02X:%02X:%02X:%02X",
+               this->ssid, this->cache.bssid[0], this->cache.bssid[1],
+               this->cache.bssid[2], this->cache.bssid[3],
+               this->cache.bssid[4], this->cache.bssid[5]);
+      #ifdef REUSE_CACHED_DHCP_LEASE
+      // Skip DHCP by using the last lease as a static address
+      WiFi.config(IPAddress(this->cache.localIP), IPAddress(this->cache.dns),
+                  IPAddress(this->cache.gateway), IPAddress(this->cache.subnet));
+      #endif
+    } else {
+      LOG_INFO("Connecting to %s", this->ssid);
+    }
+    this->attemptStartTime = millis();
+    WiFi.beginNoBlock(this->ssid, this->password,
+                      this->usingCache ? this->cache.bssid : nullptr);
+    this->state = LinkState::CONNECTING;
+  }
+
+  void WiFiLinkManager::attemptFailed() {
+    this->stats.consecutiveFailures++;
+    WiFi.disconnect();
+    if (this->usingCache) {
+      // The access point or lease might have changed, try again right away
+      // with a full scan and DHCP
+      LOG_WARN("Connecting through cached access point failed");
+      this->cacheValid = false;
+      #ifdef REUSE_CACHED_DHCP_LEASE
+      // All zeros goes back to DHCP
+      WiFi.config(IPAddress(0, 0, 0, 0), IPAddress(0, 0, 0, 0),
+                  IPAddress(0, 0, 0, 0), IPAddress(0, 0, 0, 0));
+      #endif
+      this->nextAttemptTime = millis();
+    } else {
+      LOG_WARN("WiFi connection failed (%lu in a row), retrying in %lu "
+               "ms",
+               this->stats.consecutiveFailures, this->backoff);
+      this->nextAttemptTime = millis() + this->backoff;
+      this->backoff = min(this->backoff * 2, MAX_BACKOFF);
+    }
+    this->state = LinkState::BACKOFF;
+  }
+
+  void WiFiLinkManager::linkUp() {
+    this->stats.lastAssociationTime = millis() - this->attemptStartTime;
+    this->stats.consecutiveFailures = 0;
+    this->backoff = FIRST_BACKOFF;
+    this->everConnected = true;
+    this->state = LinkState::CONNECTED;
+    LOG_INFO("Connected to WiFi in %lu ms%s (%lu attempts, %lu drops)",
+             this->stats.lastAssociationTime,
+             this->usingCache ? " using cached access point" : "",
+             this->stats.attemptCount, this->stats.dropCount);
+    this->saveCache();
+  }
+
+  /**
+   * @brief Read the cached access point from flash, and only use it if it's
+   *  intact and for the same SSID.
+   */
+  void WiFiLinkManager::loadCache() {
+    EEPROM.begin(Settings::EEPROM_EMULATION_SIZE);
+    memcpy(&this->cache,
+           EEPROM.getDataPtr() + Settings::WIFI_LINK_CACHE_EEPROM_OFFSET,
+           sizeof(this->cache));
+    EEPROM.end();
+    this->cacheValid =
+      this->cache.magic == LINK_CACHE_MAGIC &&
+      this->cache.version == LINK_CACHE_VERSION &&
+      this->cache.crc == cacheCrc(this->cache) &&
+      this->cache.ssidCrc == Checksum::crc32(this->ssid, strlen(this->ssid));
+    LOG_INFO("WiFi link cache %s",
+             this->cacheValid ? "loaded" : "not usable");
+  }
+
+  /**
+   * @brief Save the access point and address of the link that just came up,
+   *  only writing to flash if they changed.
+   */
+  void WiFiLinkManager::saveCache() {
+    LinkCache linkCache;
+    memset(&linkCache, 0, sizeof(linkCache)); // Padding is part of the CRC
+    linkCache.magic = LINK_CACHE_MAGIC;
+    linkCache.version = LINK_CACHE_VERSION;
+    WiFi.BSSID(linkCache.bssid);
+    linkCache.ssidCrc = Checksum::crc32(this->ssid, strlen(this->ssid));
+    linkCache.localIP = WiFi.localIP();
+    linkCache.gateway = WiFi.gatewayIP();
+    linkCache.subnet = WiFi.subnetMask();
+    linkCache.dns = WiFi.dnsIP();
+    linkCache.crc = cacheCrc(linkCache);
+    this->cache = linkCache;
+    EEPROM.begin(Settings::EEPROM_EMULATION_SIZE);
+    uint8_t* stored =
+      EEPROM.getDataPtr() + Settings::WIFI_LINK_CACHE_EEPROM_OFFSET;
+    if (memcmp(stored, &linkCache, sizeof(linkCache)) != 0) {
+      LOG_DEBUG("Writing WiFi link cache to flash");
+      memcpy(stored, &linkCache, sizeof(linkCache));
+      EEPROM.commit();
+    }
+    EEPROM.end();
+    this->cacheValid = true;
+  }
+
+  /**
+   * @brief Calculate the CRC of the cache, not including the CRC itself.
+   */
+  uint32_t WiFiLinkManager::cacheCrc(const LinkCache& linkCache) {
+    return Checksum::crc32(&linkCache, offsetof(LinkCache, crc));
+  }
+} // WiFiLink
@@ -0,0 +1,155 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_WIFILINK_H
+#define PICO2W_STOCK_TICKER_WIFILINK_H
+
+#ifndef REUSE_CACHED_DHCP_LEASE
+// #define REUSE_CACHED_DHCP_LEASE
+#endif
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <EEPROMLayout.h>
+#include <Log.h>
+#include <WiFi.h>
+
+namespace WiFiLink {
+  const uint32_t LINK_CACHE_MAGIC = 0x574C4E4B; // "WLNK"
+  const uint16_t LINK_CACHE_VERSION = 2;
+  // How long to wait for one attempt to associate and get an address
+  const uint32_t CONNECT_TIMEOUT = 10 * 1000;
+  // Wait between failed attempts doubles from the first up to the max
+  const uint32_t FIRST_BACKOFF = 1000;
+  const uint32_t MAX_BACKOFF = 60 * 1000;
+
+  enum class LinkState {
+    // begin() not called
+    IDLE,
+    // Waiting for an attempt to finish
+    CONNECTING,
+    CONNECTED,
+    // Waiting before the next attempt
+    BACKOFF
+  };
+
+  /**
+   * @brief Counters for how the link has been doing, times in milliseconds.
+   */
+  struct LinkStats {
+      // How long the last successful attempt took
+      uint32_t lastAssociationTime;
+      // How many times the link went down after being up
+      uint32_t dropCount;
+      uint32_t attemptCount;
+      // Failed attempts since the link was last up
+      uint32_t consecutiveFailures;
+      // How many attempts used the cached access point
+      uint32_t cachedAttemptCount;
+  };
+
+  /**
+   * @brief Keeps the WiFi link up without ever blocking.
+   *
+   * Attempts are started with WiFi.beginNoBlock() and checked on each
+   * update(), failed attempts and drops are retried with exponential backoff.
+   * The access point (BSSID) and address of the last good link are kept in
+   * flash so the first attempt after a reboot can go straight to the same
+   * access point. With REUSE_CACHED_DHCP_LEASE the address is also used as a
+   * static one to skip DHCP, it's off by default since a router can hand the
+   * address to someone else once the lease runs out.
+   */
+  class WiFiLinkManager {
+    public:
+      WiFiLinkManager() = default;
+      ~WiFiLinkManager() = default;
+
+      void begin(const char* ssid, const char* password);
+      void end();
+      bool update();
+
+      /**
+       * @brief Check if the link is up.
+       *
+       * @return true if connected.
+       */
+      bool isConnected() const {
+        return this->state == LinkState::CONNECTED;
+      }
+
+      /**
+       * @brief Check if the link has been up at least once since begin().
+       *
+       * @return true if it has connected before.
+       */
+      bool hasConnected() const {
+        return this->everConnected;
+      }
+
+      /**
+       * @brief Get what the link is doing.
+       *
+       * @return LinkState
+       */
+      LinkState getState() const {
+        return this->state;
+      }
+
+      /**
+       * @brief Get the association time and drop counters.
+       *
+       * @return const LinkStats&
+       */
+      const LinkStats& getStats() const {
+        return this->stats;
+      }
+
+    protected:
+      // clang-format off
+      struct LinkCache {
+          uint32_t magic;
+          uint16_t version;
+          uint8_t bssid[6];
+          // Which network this is for, so a new SSID doesn't use it
+          uint32_t ssidCrc;
+          uint32_t localIP;
+          uint32_t gateway;
+          uint32_t subnet;
+          uint32_t dns;
+          uint32_t crc;
+      };
+      // clang-format on
+
+      static_assert(Settings::WIFI_LINK_CACHE_EEPROM_OFFSET +
+                        sizeof(LinkCache) <=
+                      Settings::EEPROM_EMULATION_SIZE,
+                    "WiFi link cache doesn't fit in EEPROM emulation");
+
+      const char* ssid = nullptr;
+      const char* password = nullptr;
+
+      LinkState state = LinkState::IDLE;
+      LinkStats stats = {};
+      bool everConnected = false;
+
+      LinkCache cache = {};
+      bool cacheValid = false;
+      // If the current attempt is using the cache
+      bool usingCache = false;
+
+      uint32_t attemptStartTime = 0;
+      uint32_t backoff = FIRST_BACKOFF;
+      uint32_t nextAttemptTime = 0;
+
+      void startAttempt();
+      void attemptFailed();
+      void linkUp();
+
+      void loadCache();
+      void saveCache();
+      static uint32_t cacheCrc(const LinkCache& linkCache);
+  };
+} // WiFiLink
+
+#endif // PICO2W_STOCK_TICKER_WIFILINK_H
@@ -1,98 +1,317 @@
+#ifndef BENCHMARK_FONT_RENDERING
+// #define BENCHMARK_FONT_RENDERING
+#endif
+#ifndef LOG_SOAK_STATS
+// #define LOG_SOAK_STATS
+#endif
+#ifndef USE_MOCK_PROVIDER
+// #define USE_MOCK_PROVIDER
+#endif
+
 #include "config.h"
 #include "pins.h"
+#include <AlpacaProvider.h>
 #include <Arduino.h>
+#include <ButtonEvents.h>
+#include <IdleScheduler.h>
+#include <Log.h>
 #include <MD_MAX72xx.h>
 #include <MD_MAX72xx_Text.h>
+#include <MockProvider.h>
+#include <PriceStore.h>
 #include <SPI.h>
-#include <SimpleButton.h>
+#include <SoakMonitor.h>
 #include <StockTicker.h>
 #include <TickerSettings.h>
 #include <WiFi.h>
+#include <WiFiLink.h>
 #include <WiFiSettings.h>
 
-SimpleButton configBtn(CONFIG_BTN_PIN);
+ButtonEvents::ButtonEvents buttons;
+uint8_t configButton = ButtonEvents::NO_BUTTON;
 
 Settings::WiFiSettings wifiSettings;
 Settings::TickerSettings tickerSettings;
 StockTicker::StockTicker stockTicker;
-
-#ifdef USE_HARDWARE_SPI
-// Not using Parola for manual control
-MD_MAX72XX display =
-  MD_MAX72XX(HARDWARE_TYPE, SPI, CS_PIN, matrixModulesCount * 4);
-#else
-MD_MAX72XX display =
-  MD_MAX72XX(HARDWARE_TYPE, DATA_PIN, CLK_PIN, CS_PIN,
-             matrixModulesCount * 4);
+StockTicker::AlpacaProvider alpacaProvider;
+StockTicker::PriceStore priceStore;
+#ifdef USE_MOCK_PROVIDER
+// Made up prices without a network, to work on everything after the request
+StockTicker::MockProvider mockProvider;
+#endif
+WiFiLink::WiFiLinkManager wifiLink;
+#ifdef LOG_SOAK_STATS
+SoakMonitor::SoakMonitor soakMonitor;
 #endif
+IdleScheduler::IdleScheduler idleScheduler;
 
-MD_MAX72XX_Print textDisplay(&display);
-MD_MAX72XX_Scrolling scrollingDisplay(&display);
+// Don't wait for the next frame to handle a button edge
+void wakeOnButton() {
+  idleScheduler.wake();
+}
 
-void startWiFiConfigOverUSBAndReboot(const char* msg) {
-  Serial1.println("Exposing FatFSUSB for WiFi settings editing");
-  wifiSettings.fatFSUSBBegin();
-  Serial1.println("USB connected, waiting for eject...");
+// Failed attempts before asking for new WiFi settings, only if the link has
+// never been up since boot (a network that worked before is just down)
+const uint32_t WIFI_FAILURES_BEFORE_CONFIG = 5;
+
+// Created in beginDisplay() once the chain length is loaded from settings
+MD_MAX72XX* display = nullptr;
+
+MD_MAX72XX_Framebuffer framebuffer;
+MD_MAX72XX_Compositor compositor(&framebuffer);
+// Prices and messages scroll on the left
+MD_MAX72XX_Scrolling scrollingDisplay(&framebuffer);
+// The link status stays put on the right, see showLinkStatus()
+MD_MAX72XX_Print textDisplay(&framebuffer);
+// Room for "..", the widest status
+const uint16_t STATUS_ZONE_WIDTH = 8;
+
+// Where the time went during boot, in microseconds
+struct BootTimings {
+    Settings::LoadTimings settings;
+    uint32_t displayInit;
+    // Since power on
+    uint32_t firstFrame;
+};
+
+BootTimings bootTimings = {};
+
+void logBootTimingsOnFirstFrame() {
+  static bool logged = false;
+  if (logged) {
+    return;
+  }
+  logged = true;
+  bootTimings.firstFrame = micros();
+  LOG_INFO("Boot timings: mount %lu us, read %lu us, parse %lu us, "
+           "validate %lu us (%d settings from cache), display init %lu "
+           "us, first frame at %lu us",
+           bootTimings.settings.mount, bootTimings.settings.read,
+           bootTimings.settings.parse, bootTimings.settings.validate,
+           bootTimings.settings.cacheHits, bootTimings.displayInit,
+           bootTimings.firstFrame);
+}
+
+// Expose the filesystem over USB and scroll msg until the drive is ejected or
+// the config button is pressed and released
+void waitForSettingsOverUSB(Settings::BaseSettings& settings,
+                            const char* msg) {
+  settings.fatFSUSBBegin();
+  LOG_INFO("USB connected, waiting for eject...");
   scrollingDisplay.setText(msg, true);
+  // Not the release of the press that got here
   bool hasPressedYet = false;
-  while (wifiSettings.fatFSUSBConnected()) {
-    scrollingDisplay.update();
-    if (configBtn.pressed()) {
-      hasPressedYet = true;
-    }
-    if (configBtn.released() && hasPressedYet) {
-      Serial1.println("Config button pressed and released, stopping FatFSUSB");
-      break;
+  bool hasReleased = false;
+  while (settings.fatFSUSBConnected() && !hasReleased) {
+    compositor.update();
+    buttons.update();
+    Log::logger.drain();
+    ButtonEvents::Event event;
+    while (buttons.nextEvent(event)) {
+      if (event.button != configButton) {
+        continue;
+      }
+      if (event.type == ButtonEvents::EventType::PRESS) {
+        hasPressedYet = true;
+      } else if (event.type == ButtonEvents::EventType::RELEASE &&
+                 hasPressedYet) {
+        hasReleased = true;
+      }
     }
   }
-  wifiSettings.fatFSUSBEnd();
-  Serial1.println("Rebooting to try loading settings again");
+  if (hasReleased) {
+    LOG_INFO("Config button pressed and released, stopping FatFSUSB");
+  }
+  settings.fatFSUSBEnd();
+}
+
+void startWiFiConfigOverUSBAndReboot(const char* msg) {
+  LOG_INFO("Exposing FatFSUSB for WiFi settings editing");
+  waitForSettingsOverUSB(wifiSettings, msg);
+  LOG_INFO("Rebooting to try loading settings again");
+  Log::logger.flush();
   rp2040.reboot();
 }
 
 void startTickerConfigOverUSBAndReboot(const char* msg) {
-  Serial1.println("Exposing FatFSUSB for Ticker settings editing");
-  tickerSettings.fatFSUSBBegin();
-  Serial1.println("USB connected, waiting for eject...");
-  scrollingDisplay.setText(msg, true);
-  bool hasPressedYet = false;
-  while (tickerSettings.fatFSUSBConnected()) {
-    scrollingDisplay.update();
-    if (configBtn.pressed()) {
-      hasPressedYet = true;
+  LOG_INFO("Exposing FatFSUSB for Ticker settings editing");
+  waitForSettingsOverUSB(tickerSettings, msg);
+  LOG_INFO("Rebooting to try loading settings again");
+  Log::logger.flush();
+  rp2040.reboot();
+}
+
+// Settings that can change without restarting anything
+void applyLiveSettings() {
+  stockTicker.setDisplayMode(tickerSettings.showSparklines
+                               ? StockTicker::DisplayMode::SPARKLINE
+                               : StockTicker::DisplayMode::PRICES);
+  scrollingDisplay.periodBetweenShifts = tickerSettings.scrollPeriod;
+  textDisplay.setPeriodBetweenShifts(tickerSettings.scrollPeriod);
+  display->control(MD_MAX72XX::INTENSITY, tickerSettings.displayBrightness);
+  stockTicker.setDeadlines(tickerSettings.connectTimeout,
+                           tickerSettings.firstByteTimeout,
+                           tickerSettings.pollTimeout);
+  stockTicker.setTierPeriods(tickerSettings.fastRequestPeriod * 1000,
+                             tickerSettings.slowRequestPeriod * 1000);
+  Log::logger.setLevel(Log::parseLevel(tickerSettings.logLevel));
+}
+
+// Let the settings be edited over USB while running, then reload them and
+// restart only what changed. Only reboots if the new settings are invalid (to
+// show why) or the display chain length changed.
+void startConfigOverUSBAndReload(const char* msg) {
+  LOG_INFO("Exposing FatFSUSB for settings editing");
+  waitForSettingsOverUSB(tickerSettings, msg);
+
+  // Copies to compare the reloaded settings against
+  const Settings::WiFiSettings previousWiFiSettings = wifiSettings;
+  const Settings::TickerSettings previousTickerSettings = tickerSettings;
+  Settings::BaseSettings* const allSettings[] = {&wifiSettings,
+                                                 &tickerSettings};
+  Settings::LoadFromDiskResult results[2];
+  Settings::loadAllFromDisk(allSettings, results, 2);
+  if (results[0] != Settings::LoadFromDiskResult::OK ||
+      results[1] != Settings::LoadFromDiskResult::OK) {
+    LOG_ERROR("Settings failed to load, rebooting to show why");
+    WiFi.end();
+    Log::logger.flush();
+    rp2040.reboot();
+  }
+  if (tickerSettings.matrixModulesCount !=
+      previousTickerSettings.matrixModulesCount) {
+    LOG_INFO("Matrix modules count changed, rebooting");
+    WiFi.end();
+    Log::logger.flush();
+    rp2040.reboot();
+  }
+
+  if (strcmp(wifiSettings.ssid, previousWiFiSettings.ssid) != 0 ||
+      strcmp(wifiSettings.password, previousWiFiSettings.password) != 0) {
+    LOG_INFO("WiFi settings changed, reconnecting");
+    wifiLink.begin(wifiSettings.ssid, wifiSettings.password);
+  } else if (!wifiLink.isConnected()) {
+    // Start over with a fresh count of failed attempts
+    wifiLink.begin(wifiSettings.ssid, wifiSettings.password);
+  }
+  if (strcmp(tickerSettings.apcaApiKeyId,
+             previousTickerSettings.apcaApiKeyId) != 0 ||
+      strcmp(tickerSettings.apcaApiSecretKey,
+             previousTickerSettings.apcaApiSecretKey) != 0 ||
+      strcmp(tickerSettings.symbols, previousTickerSettings.symbols) != 0 ||
+      strcmp(tickerSettings.sourceFeed, previousTickerSettings.sourceFeed) !=
+        0 ||
+      strcmp(tickerSettings.cryptoLocation,
+             previousTickerSettings.cryptoLocation) != 0 ||
+      tickerSettings.requestPeriod != previousTickerSettings.requestPeriod ||
+      tickerSettings.cryptoRequestPeriod !=
+        previousTickerSettings.cryptoRequestPeriod) {
+    LOG_INFO("Ticker settings changed, restarting stock ticker");
+    alpacaProvider.begin(
+      tickerSettings.apcaApiKeyId, tickerSettings.apcaApiSecretKey,
+      tickerSettings.sourceFeed, tickerSettings.cryptoLocation);
+    stockTicker.begin(tickerSettings.symbols,
+                      tickerSettings.requestPeriod * 1000,
+                      tickerSettings.cryptoRequestPeriod * 1000);
+  }
+  applyLiveSettings();
+  scrollingDisplay.setSource(&stockTicker);
+  LOG_INFO("Settings reloaded");
+}
+
+#ifdef BENCHMARK_FONT_RENDERING
+// Compare drawing characters with MD_MAX72XX::setChar() (runtime font search)
+// against the compile time font tables drawn into the framebuffer
+void benchmarkFontRendering() {
+  const char* text = "AAPL: $123.45 +1.23% (+$1.50)    ";
+  const size_t textLen = strlen(text);
+  const uint16_t iterations = 1000;
+  MD_MAX72XX_Zone zone(&framebuffer);
+
+  uint32_t start = micros();
+  for (uint16_t i = 0; i < iterations; i++) {
+    for (size_t j = 0; j < textLen; j++) {
+      display->setChar(display->getColumnCount() - 1, text[j]);
     }
-    if (configBtn.released() && hasPressedYet) {
-      Serial1.println("Config button pressed and released, stopping FatFSUSB");
-      break;
+  }
+  const uint32_t setCharTime = micros() - start;
+
+  start = micros();
+  for (uint16_t i = 0; i < iterations; i++) {
+    for (size_t j = 0; j < textLen; j++) {
+      zone.drawChar(0, text[j]);
     }
   }
-  tickerSettings.fatFSUSBEnd();
-  Serial1.println("Rebooting to try loading settings again");
-  rp2040.reboot();
-}
+  const uint32_t atlasTime = micros() - start;
 
-void setup() {
-  Serial1.begin(115200);
-  Serial1.println("\n");
-  pinMode(LED_BUILTIN, OUTPUT);
-  digitalWrite(LED_BUILTIN, LOW);
-  configBtn.begin(false);
+  const uint32_t charsDrawn = iterations * textLen;
+  LOG_INFO("setChar: %lu us for %lu chars (%.3f us/char)", setCharTime,
+           charsDrawn, static_cast<float>(setCharTime) / charsDrawn);
+  LOG_INFO("Font atlas: %lu us for %lu chars (%.3f us/char)",
+           atlasTime, charsDrawn,
+           static_cast<float>(atlasTime) / charsDrawn);
+  display->clear();
+  framebuffer.clear();
+}
+#endif
 
+void beginDisplay(uint8_t matrixModulesCount) {
+  LOG_INFO("Starting display with %d groups of four modules",
+           matrixModulesCount);
   #ifdef USE_HARDWARE_SPI
   SPI.setSCK(CLK_PIN);
   SPI.setTX(DATA_PIN);
   SPI.setCS(CS_PIN);
   SPI.begin();
+  // Not using Parola for manual control
+  display = new MD_MAX72XX(HARDWARE_TYPE, SPI, CS_PIN, matrixModulesCount * 4);
+  #else
+  display = new MD_MAX72XX(HARDWARE_TYPE, DATA_PIN, CLK_PIN, CS_PIN,
+                           matrixModulesCount * 4);
+  #endif
+  display->begin();
+  display->clear();
+  display->control(MD_MAX72XX::UPDATE, MD_MAX72XX::OFF);
+  display->control(MD_MAX72XX::INTENSITY, MAX_INTENSITY / 2);
+  framebuffer.begin(display);
+  textDisplay.setBuffered(true);
+  compositor.removeAllZones();
+  const uint16_t tickerWidth =
+    framebuffer.getColumnCount() - STATUS_ZONE_WIDTH;
+  compositor.addZone(&scrollingDisplay, 0, tickerWidth);
+  compositor.addZone(&textDisplay, tickerWidth, STATUS_ZONE_WIDTH);
+  #ifdef BENCHMARK_FONT_RENDERING
+  benchmarkFontRendering();
   #endif
-  display.begin();
-  display.clear();
-  display.control(MD_MAX72XX::UPDATE, MD_MAX72XX::OFF);
-  display.control(MD_MAX72XX::INTENSITY, MAX_INTENSITY / 2);
+}
+
+void setup() {
+  Log::logger.begin();
+  Log::logger.println();
+  pinMode(LED_BUILTIN, OUTPUT);
+  digitalWrite(LED_BUILTIN, LOW);
+  buttons.begin(wakeOnButton);
+  // The board has its own pull up
+  configButton = buttons.addButton(CONFIG_BTN_PIN, false);
+
+  // Mount the filesystem once for every settings file and the saved prices
+  Settings::BaseSettings* const allSettings[] = {&wifiSettings,
+                                                 &tickerSettings};
+  Settings::LoadFromDiskResult results[2];
+  Settings::loadAllFromDisk(allSettings, results, 2, &bootTimings.settings,
+                            []() { priceStore.load(); });
+  const Settings::LoadFromDiskResult r = results[0];
+  const Settings::LoadFromDiskResult r2 = results[1];
+  // Ticker settings say how long the chain is, falls back to the default if
+  // they failed to load so error messages can still be shown
+  const uint32_t displayInitStart = micros();
+  beginDisplay(tickerSettings.matrixModulesCount);
+  bootTimings.displayInit = micros() - displayInitStart;
 
-  const Settings::LoadFromDiskResult r = wifiSettings.loadFromDisk();
   // If fail to load WiFi settings, start WiFi configuration over USB
   if (r != Settings::LoadFromDiskResult::OK) {
-    Serial1.printf("Failed to load settings from disk: %s\n", r);
+    LOG_ERROR("Failed to load settings from disk: %d",
+              static_cast<int>(r));
     if (r == Settings::LoadFromDiskResult::ERROR_FILE_OPEN_FAILED) {
       // Write default settings because file not found
       wifiSettings.saveToDisk();
@@ -147,10 +366,10 @@ void setup() {
         break;
     }
   }
-  const Settings::LoadFromDiskResult r2 = tickerSettings.loadFromDisk();
   // If fail to load Ticker settings, start Ticker configuration over USB
   if (r2 != Settings::LoadFromDiskResult::OK) {
-    Serial1.printf("Failed to load settings from disk: %s\n", r2);
+    LOG_ERROR("Failed to load settings from disk: %d",
+              static_cast<int>(r2));
     if (r2 == Settings::LoadFromDiskResult::ERROR_FILE_OPEN_FAILED) {
       // Write default settings because file not found
       tickerSettings.saveToDisk();
@@ -203,7 +422,8 @@ void setup() {
           case Settings::TickerSettingsValidationResult::ERROR_INVALID_SYMBOLS:
             startTickerConfigOverUSBAndReboot(
               "Invalid symbols, modify \"symbols\" key (must be comma "
-              "separated list of 1 to 32 stock symbols) in "
+              "separated list of 1 to 32 stock symbols or crypto pairs like "
+              "BTC/USD, each optionally ending in :fast, :normal or :slow) in "
               "ticker_settings.json on USB drive and eject to finish.");
           case Settings::TickerSettingsValidationResult::
           ERROR_INVALID_SOURCE_FEED:
@@ -218,21 +438,72 @@ void setup() {
               "Invalid request period, modify \"requestPeriod\" key (must be a "
               "natural number) in ticker_settings.json on USB drive and eject "
               "to finish.");
-            break;
           case Settings::TickerSettingsValidationResult::
           ERROR_INVALID_SCROLL_PERIOD:
             startTickerConfigOverUSBAndReboot(
               "Invalid scroll period, modify \"scrollPeriod\" key (must be a "
               "natural number) in ticker_settings.json on USB drive and eject "
               "to finish.");
-            break;
           case Settings::TickerSettingsValidationResult::
           ERROR_INVALID_DISPLAY_BRIGHTNESS:
             startTickerConfigOverUSBAndReboot(
               "Invalid display brightness, modify \"displayBrightness\" key "
               "(must be a natural number between 1 and 15 inclusive) in "
               "ticker_settings.json on USB drive and eject to finish.");
-            break;
+          case Settings::TickerSettingsValidationResult::
+          ERROR_INVALID_MATRIX_MODULES_COUNT:
+            startTickerConfigOverUSBAndReboot(
+              "Invalid matrix modules count, modify \"matrixModulesCount\" "
+              "key (must be a natural number between 1 and 8 inclusive) in "
+              "ticker_settings.json on USB drive and eject to finish.");
+          case Settings::TickerSettingsValidationResult::
+          ERROR_INVALID_CONNECT_TIMEOUT:
+            startTickerConfigOverUSBAndReboot(
+              "Invalid connect timeout, modify \"connectTimeout\" key (must be "
+              "milliseconds between 100 and 60000 inclusive) in "
+              "ticker_settings.json on USB drive and eject to finish.");
+          case Settings::TickerSettingsValidationResult::
+          ERROR_INVALID_FIRST_BYTE_TIMEOUT:
+            startTickerConfigOverUSBAndReboot(
+              "Invalid first byte timeout, modify \"firstByteTimeout\" key "
+              "(must be milliseconds between 100 and 60000 inclusive) in "
+              "ticker_settings.json on USB drive and eject to finish.");
+          case Settings::TickerSettingsValidationResult::
+          ERROR_INVALID_POLL_TIMEOUT:
+            startTickerConfigOverUSBAndReboot(
+              "Invalid poll timeout, modify \"pollTimeout\" key (must be "
+              "milliseconds between 1000 and 600000 inclusive) in "
+              "ticker_settings.json on USB drive and eject to finish.");
+          case Settings::TickerSettingsValidationResult::
+          ERROR_INVALID_CRYPTO_LOCATION:
+            startTickerConfigOverUSBAndReboot(
+              "Invalid crypto location, modify \"cryptoLocation\" key (must "
+              "be \"us\", \"us-1\", or \"eu-1\") in ticker_settings.json on "
+              "USB drive and eject to finish.");
+          case Settings::TickerSettingsValidationResult::
+          ERROR_INVALID_CRYPTO_REQUEST_PERIOD:
+            startTickerConfigOverUSBAndReboot(
+              "Invalid crypto request period, modify \"cryptoRequestPeriod\" "
+              "key (must be a natural number) in ticker_settings.json on USB "
+              "drive and eject to finish.");
+          case Settings::TickerSettingsValidationResult::
+          ERROR_INVALID_FAST_REQUEST_PERIOD:
+            startTickerConfigOverUSBAndReboot(
+              "Invalid fast request period, modify \"fastRequestPeriod\" key "
+              "(must be a natural number) in ticker_settings.json on USB drive "
+              "and eject to finish.");
+          case Settings::TickerSettingsValidationResult::
+          ERROR_INVALID_SLOW_REQUEST_PERIOD:
+            startTickerConfigOverUSBAndReboot(
+              "Invalid slow request period, modify \"slowRequestPeriod\" key "
+              "(must be a natural number) in ticker_settings.json on USB drive "
+              "and eject to finish.");
+          case Settings::TickerSettingsValidationResult::
+          ERROR_INVALID_LOG_LEVEL:
+            startTickerConfigOverUSBAndReboot(
+              "Invalid log level, modify \"logLevel\" key (must be \"none\", "
+              "\"error\", \"warn\", \"info\", or \"debug\") in "
+              "ticker_settings.json on USB drive and eject to finish.");
           case Settings::TickerSettingsValidationResult::OK:
             break;
         }
@@ -240,45 +511,97 @@ void setup() {
         break;
     }
   }
-  // If configuration buton pressed, start WiFi or Ticker configuration over USB
-  if (configBtn.pressed()) {
-    Serial1.println("Config button pressed");
+  // If configuration buton held, start WiFi or Ticker configuration over USB
+  if (buttons.isPressed(configButton)) {
+    LOG_INFO("Config button pressed");
     startWiFiConfigOverUSBAndReboot(
       "Configuration button pressed, modify wifi_settings.json or "
       "ticker_settings.json on USB drive and eject to finish.");
   }
 
-  Serial1.println(tickerSettings.symbols);
-  stockTicker.begin(tickerSettings.apcaApiKeyId,
-                    tickerSettings.apcaApiSecretKey, tickerSettings.symbols,
-                    tickerSettings.sourceFeed,
-                    tickerSettings.requestPeriod * 1000);
+  LOG_INFO("Symbols: %s", tickerSettings.symbols);
+  alpacaProvider.begin(
+    tickerSettings.apcaApiKeyId, tickerSettings.apcaApiSecretKey,
+    tickerSettings.sourceFeed, tickerSettings.cryptoLocation);
+  #ifdef USE_MOCK_PROVIDER
+  stockTicker.addProvider(&mockProvider);
+  #else
+  stockTicker.addProvider(&alpacaProvider);
+  #endif
+  stockTicker.setPriceStore(&priceStore);
+  stockTicker.begin(tickerSettings.symbols,
+                    tickerSettings.requestPeriod * 1000,
+                    tickerSettings.cryptoRequestPeriod * 1000);
+  applyLiveSettings();
+  scrollingDisplay.setSource(&stockTicker);
+  // Connects in the background while the restored prices scroll
+  wifiLink.begin(wifiSettings.ssid, wifiSettings.password);
+  #ifdef LOG_SOAK_STATS
+  soakMonitor.begin();
+  #endif
+  idleScheduler.begin();
+}
 
-  scrollingDisplay.setText(stockTicker.getDisplayStr());
-  scrollingDisplay.periodBetweenShifts = tickerSettings.scrollPeriod;
-  display.control(MD_MAX72XX::INTENSITY, tickerSettings.displayBrightness);
+// Show in the status zone if the prices might be old: ".." while WiFi is
+// down, "!" while the last request failed, nothing when all is well
+void showLinkStatus() {
+  static const char* shownStatus = nullptr;
+  const char* status = "";
+  if (!wifiLink.isConnected()) {
+    status = "..";
+  } else if (stockTicker.getStatus() != StockTicker::StockTickerStatus::OK) {
+    status = "!";
+  }
+  if (status == shownStatus) {
+    return;
+  }
+  shownStatus = status;
+  // Drawn on the next compositor update
+  textDisplay.print('\n');
+  textDisplay.print(status);
 }
 
 void loop() {
   static StockTicker::StockTickerStatus lastStatus =
     StockTicker::StockTickerStatus::OK;
 
-  // If configuration button pressed, start WiFi configuration over USB
-  if (configBtn.pressed()) {
-    Serial1.println("Config button pressed");
-    Serial1.println("Stopping WiFi and rebooting");
-    WiFi.end();
-    rp2040.reboot();
+  buttons.update();
+  ButtonEvents::Event event;
+  while (buttons.nextEvent(event)) {
+    if (event.button != configButton) {
+      continue;
+    }
+    switch (event.type) {
+      // Edit settings over USB without rebooting
+      case ButtonEvents::EventType::LONG_PRESS:
+        LOG_INFO("Config button held");
+        startConfigOverUSBAndReload(
+          "Modify wifi_settings.json or ticker_settings.json on USB drive and "
+          "eject to finish.");
+        lastStatus = StockTicker::StockTickerStatus::OK;
+        break;
+      // Get new prices now instead of at the next poll
+      case ButtonEvents::EventType::CLICK:
+        LOG_INFO("Config button clicked, refreshing prices");
+        stockTicker.refreshOnNextUpdate();
+        break;
+      default:
+        break;
+    }
   }
-  if (WiFi.status() == WL_CONNECTED) {
+  // Keeps scrolling the last prices while the link is down
+  if (wifiLink.update()) {
+    stockTicker.refreshOnNextUpdate();
+  }
+  if (wifiLink.isConnected()) {
     stockTicker.update();
-    scrollingDisplay.update();
     if (stockTicker.getStatus() != lastStatus) {
       lastStatus = stockTicker.getStatus();
-      Serial1.printf("Stock ticker status changed: %s\n", lastStatus);
+      LOG_INFO("Stock ticker status changed: %d",
+               static_cast<int>(lastStatus));
       switch (lastStatus) {
         case StockTicker::StockTickerStatus::OK:
-          scrollingDisplay.setText(stockTicker.getDisplayStr());
+          scrollingDisplay.setSource(&stockTicker);
           break;
         case StockTicker::StockTickerStatus::ERROR_NO_WIFI:
           scrollingDisplay.setText(
@@ -296,21 +619,34 @@ void loop() {
           scrollingDisplay.setText("Bad connection, check WiFi connection or "
             "credentials, trying again later.");
           break;
+        case StockTicker::StockTickerStatus::ERROR_CONNECT_TIMEOUT:
+        // Fallthrough
+        case StockTicker::StockTickerStatus::ERROR_FIRST_BYTE_TIMEOUT:
+          scrollingDisplay.setText(
+            "Server took too long to respond, trying again later.");
+          break;
+        case StockTicker::StockTickerStatus::ERROR_POLL_TIMEOUT:
+          // Whatever was read in time scrolls as usual, the rest is shown as
+          // stale
+          scrollingDisplay.setSource(&stockTicker);
+          break;
         case StockTicker::StockTickerStatus::ERROR_BAD_JSON_RESPONSE:
           scrollingDisplay.setText(
             "Bad response from server, trying again later.");
           break;
         case StockTicker::StockTickerStatus::ERROR_BAD_REQUEST:
           // Bad request, start Ticker configuration over USB
-          startTickerConfigOverUSBAndReboot(
+          startConfigOverUSBAndReload(
             "Bad request, modify ticker_settings.json on USB drive and eject "
             "to finish.");
+          lastStatus = StockTicker::StockTickerStatus::OK;
           break;
         case StockTicker::StockTickerStatus::ERROR_FORBIDDEN:
           // Forbidden, start Ticker configuration over USB
-          startTickerConfigOverUSBAndReboot(
+          startConfigOverUSBAndReload(
             "Forbidden, modify \"apcaApiKeyId\" and/or \"apcaApiSecretKey\" "
             "key in ticker_settings.json on USB drive and eject to finish.");
+          lastStatus = StockTicker::StockTickerStatus::OK;
           break;
         case StockTicker::StockTickerStatus::ERROR_TOO_MANY_REQUESTS:
           scrollingDisplay.setText("Too many requests, upgrade Alpaca Markets "
@@ -326,26 +662,31 @@ void loop() {
           break;
       }
     }
-  } else {
-    Serial1.println("Connecting to WiFi...");
-    textDisplay.print("Connecting to WiFi...");
-    display.update();
-    WiFi.begin(wifiSettings.ssid, wifiSettings.password);
-    delay(1000);
-    // If WiFi connection fails, start WiFi configuration over USB
-    if (WiFi.status() != WL_CONNECTED) {
-      Serial1.println("WiFi connection failed");
-      startWiFiConfigOverUSBAndReboot(
-        "WiFi connection failed, modify \"ssid\" and/or \"password\" in "
-        "wifi_settings.json on USB drive and eject to finish.");
-    }
-    Serial1.println("Connected to WiFi");
-    textDisplay.print("\nConnected to WiFi");
-    display.update();
-    Serial1.print("IP Address: ");
-    Serial1.println(WiFi.localIP());
-    delay(1000);
-    scrollingDisplay.reset();
-    stockTicker.refreshOnNextUpdate();
+  } else if (!wifiLink.hasConnected() &&
+             wifiLink.getStats().consecutiveFailures >=
+               WIFI_FAILURES_BEFORE_CONFIG) {
+    // If WiFi never connects, start WiFi configuration over USB
+    LOG_ERROR("WiFi connection failed");
+    startConfigOverUSBAndReload(
+      "WiFi connection failed, modify \"ssid\" and/or \"password\" in "
+      "wifi_settings.json on USB drive and eject to finish.");
+  }
+  showLinkStatus();
+  compositor.update();
+  logBootTimingsOnFirstFrame();
+  #ifdef LOG_SOAK_STATS
+  soakMonitor.update();
+  #endif
+  // Sleep until the next frame or poll, the WiFi link is checked at least
+  // every IdleScheduler::MAX_IDLE
+  idleScheduler.wakeBy(scrollingDisplay.getNextShiftTime());
+  if (wifiLink.isConnected()) {
+    idleScheduler.wakeBy(stockTicker.getNextUpdateTime());
+  }
+  uint32_t buttonTime;
+  if (buttons.getNextUpdateTime(buttonTime)) {
+    idleScheduler.wakeBy(buttonTime);
   }
+  Log::logger.drain();
+  idleScheduler.idle();
 }
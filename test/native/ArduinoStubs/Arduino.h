@@ -0,0 +1,199 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_NATIVE_ARDUINO_H
+#define PICO2W_STOCK_TICKER_NATIVE_ARDUINO_H
+
+// Just enough of the Arduino core for the libraries in lib/ to build and run
+// on the computer, for `pio test -e native`. The clock is the computer's,
+// Serial1 goes to stdout and there is no hardware behind anything else.
+//
+// The network and filesystem (and String, which only they return) are
+// declared but never defined. The libraries that use them still build, but a
+// test that reaches them fails to link instead of pretending to work.
+
+#include <math.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+// unsigned long is 32 bits on the board, these are too so they wrap the same
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+
+long random(long howBig);
+long random(long howSmall, long howBig);
+void randomSeed(unsigned long seed);
+
+template <class T, class L>
+auto min(const T& a, const L& b) -> decltype((b < a) ? b : a) {
+  return (b < a) ? b : a;
+}
+
+template <class T, class L>
+auto max(const T& a, const L& b) -> decltype((b < a) ? b : a) {
+  return (a < b) ? b : a;
+}
+
+#define constrain(amt, low, high) \
+  ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+class Print {
+  public:
+    virtual ~Print() = default;
+
+    virtual size_t write(uint8_t c) = 0;
+
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+      size_t written = 0;
+      for (size_t i = 0; i < size; i++) {
+        written += this->write(buffer[i]);
+      }
+      return written;
+    }
+
+    size_t write(const char* str) {
+      return this->write(reinterpret_cast<const uint8_t*>(str), strlen(str));
+    }
+
+    virtual int availableForWrite() {
+      return 0;
+    }
+
+    virtual void flush() {
+    }
+
+    size_t print(const char* str) {
+      return this->write(str);
+    }
+
+    size_t print(char c) {
+      return this->write(static_cast<uint8_t>(c));
+    }
+
+    size_t println(const char* str = "") {
+      return this->write(str) + this->write("\r\n");
+    }
+
+    size_t printf(const char* format, ...)
+      __attribute__((format(printf, 2, 3))) {
+      char str[256];
+      va_list args;
+      va_start(args, format);
+      const int len = vsnprintf(str, sizeof(str), format, args);
+      va_end(args);
+      if (len <= 0) {
+        return 0;
+      }
+      return this->write(reinterpret_cast<const uint8_t*>(str),
+                         min(static_cast<size_t>(len), sizeof(str) - 1));
+    }
+};
+
+class Stream : public Print {
+  public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    void setTimeout(unsigned long timeout) {
+      this->timeout = timeout;
+    }
+
+    unsigned long getTimeout() {
+      return this->timeout;
+    }
+
+    /**
+     * @brief Read until length bytes are read or a read times out.
+     *
+     * @return size_t How many bytes were read.
+     */
+    size_t readBytes(char* buffer, size_t length) {
+      size_t count = 0;
+      while (count < length) {
+        const uint32_t start = millis();
+        int c;
+        do {
+          c = this->read();
+        } while (c < 0 && millis() - start < this->timeout);
+        if (c < 0) {
+          break;
+        }
+        buffer[count++] = static_cast<char>(c);
+      }
+      return count;
+    }
+
+    size_t readBytes(uint8_t* buffer, size_t length) {
+      return this->readBytes(reinterpret_cast<char*>(buffer), length);
+    }
+
+  protected:
+    unsigned long timeout = 1000;
+};
+
+// Writes straight to stdout, never has anything to read
+class HardwareSerial : public Stream {
+  public:
+    void begin(unsigned long baud) {
+    }
+
+    size_t write(uint8_t c) override {
+      return fputc(c, stdout) == EOF ? 0 : 1;
+    }
+
+    size_t write(const uint8_t* buffer, size_t size) override {
+      return fwrite(buffer, 1, size, stdout);
+    }
+
+    using Print::write;
+
+    int availableForWrite() override {
+      return 4096;
+    }
+
+    void flush() override {
+      fflush(stdout);
+    }
+
+    int available() override {
+      return 0;
+    }
+
+    int read() override {
+      return -1;
+    }
+
+    int peek() override {
+      return -1;
+    }
+};
+
+extern HardwareSerial Serial1;
+
+// The heap is the computer's, measured against a pretend total the size of
+// the board's RAM
+class RP2040 {
+  public:
+    int getTotalHeap();
+    int getUsedHeap();
+    int getFreeHeap();
+};
+
+extern RP2040 rp2040;
+
+#include <WString.h>
+
+#endif // PICO2W_STOCK_TICKER_NATIVE_ARDUINO_H
@@ -0,0 +1,80 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#include <Arduino.h>
+#include <hardware/uart.h>
+#include <malloc.h>
+#include <chrono>
+#include <random>
+#include <thread>
+
+HardwareSerial Serial1;
+RP2040 rp2040;
+
+namespace {
+  uart_inst_t uart0Instance;
+  const auto startTime = std::chrono::steady_clock::now();
+  std::minstd_rand randomEngine;
+  // The RP2350's 520 KB of SRAM
+  const int TOTAL_HEAP = 520 * 1024;
+} // namespace
+
+uart_inst_t* const uart0 = &uart0Instance;
+
+/**
+ * @brief Milliseconds since the program started, wrapping like on the board.
+ *  Weak so a test can run on a virtual clock by defining its own, like
+ *  test_soak.
+ */
+__attribute__((weak)) uint32_t millis() {
+  return static_cast<uint32_t>(
+    std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - startTime)
+      .count());
+}
+
+/**
+ * @brief Microseconds since the program started, wrapping like on the board.
+ */
+uint32_t micros() {
+  return static_cast<uint32_t>(
+    std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - startTime)
+      .count());
+}
+
+void delay(uint32_t ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+long random(long howBig) {
+  if (howBig == 0) {
+    return 0;
+  }
+  return randomEngine() % howBig;
+}
+
+long random(long howSmall, long howBig) {
+  if (howSmall >= howBig) {
+    return howSmall;
+  }
+  return howSmall + random(howBig - howSmall);
+}
+
+void randomSeed(unsigned long seed) {
+  randomEngine.seed(seed);
+}
+
+int RP2040::getTotalHeap() {
+  return TOTAL_HEAP;
+}
+
+int RP2040::getUsedHeap() {
+  const struct mallinfo2 info = mallinfo2();
+  return static_cast<int>(info.uordblks + info.hblkhd);
+}
+
+int RP2040::getFreeHeap() {
+  return this->getTotalHeap() - this->getUsedHeap();
+}
@@ -0,0 +1,35 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_NATIVE_FATFS_H
+#define PICO2W_STOCK_TICKER_NATIVE_FATFS_H
+
+#include <Arduino.h>
+
+// Declared only, see Arduino.h. Tests leave StockTicker without a PriceStore,
+// so nothing they run touches the filesystem.
+class File : public Stream {
+  public:
+    explicit operator bool() const;
+    size_t size() const;
+    bool seek(uint32_t pos);
+    size_t read(uint8_t* buffer, size_t size);
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    int available() override;
+    int read() override;
+    int peek() override;
+    void close();
+};
+
+class FS {
+  public:
+    bool begin();
+    void end();
+    File open(const char* path, const char* mode);
+};
+
+extern FS FatFS;
+
+#endif // PICO2W_STOCK_TICKER_NATIVE_FATFS_H
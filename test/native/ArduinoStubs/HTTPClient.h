@@ -0,0 +1,40 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_NATIVE_HTTPCLIENT_H
+#define PICO2W_STOCK_TICKER_NATIVE_HTTPCLIENT_H
+
+#include <WiFiClient.h>
+
+// The errors are the real ones, mapAlpacaError() is tested against them
+#define HTTPC_ERROR_CONNECTION_FAILED (-1)
+#define HTTPC_ERROR_SEND_HEADER_FAILED (-2)
+#define HTTPC_ERROR_SEND_PAYLOAD_FAILED (-3)
+#define HTTPC_ERROR_NOT_CONNECTED (-4)
+#define HTTPC_ERROR_CONNECTION_LOST (-5)
+#define HTTPC_ERROR_NO_STREAM (-6)
+#define HTTPC_ERROR_NO_HTTP_SERVER (-7)
+#define HTTPC_ERROR_TOO_LESS_RAM (-8)
+#define HTTPC_ERROR_ENCODING (-9)
+#define HTTPC_ERROR_STREAM_WRITE (-10)
+#define HTTPC_ERROR_READ_TIMEOUT (-11)
+
+// Declared only, see Arduino.h
+class HTTPClient {
+  public:
+    bool begin(WiFiClient& client, const char* url);
+    void end();
+    void useHTTP10(bool usehttp10);
+    void setReuse(bool reuse);
+    void setTimeout(uint16_t timeout);
+    void setConnectTimeout(int32_t connectTimeout);
+    void addHeader(const char* name, const char* value);
+    void collectHeaders(const char* headerKeys[], size_t headerKeysCount);
+    String header(const char* name);
+    int GET();
+    int getSize();
+    WiFiClient& getStream();
+};
+
+#endif // PICO2W_STOCK_TICKER_NATIVE_HTTPCLIENT_H
@@ -0,0 +1,17 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_NATIVE_IPADDRESS_H
+#define PICO2W_STOCK_TICKER_NATIVE_IPADDRESS_H
+
+#include <Arduino.h>
+
+// Declared only, see Arduino.h
+class IPAddress {
+  public:
+    IPAddress();
+    bool isSet() const;
+};
+
+#endif // PICO2W_STOCK_TICKER_NATIVE_IPADDRESS_H
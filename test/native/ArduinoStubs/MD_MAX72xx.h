@@ -0,0 +1,32 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_NATIVE_MD_MAX72XX_H
+#define PICO2W_STOCK_TICKER_NATIVE_MD_MAX72XX_H
+
+#include <Arduino.h>
+
+// A chain of modules that shows nothing, for the framebuffer to flush to on
+// the computer. Only what the libraries in lib/ call is here.
+class MD_MAX72XX {
+  public:
+    explicit MD_MAX72XX(uint8_t numDevices = 1) : numDevices(numDevices) {
+    }
+
+    uint16_t getColumnCount() const {
+      return this->numDevices * 8;
+    }
+
+    bool setColumn(uint16_t c, uint8_t value) {
+      return c < this->getColumnCount();
+    }
+
+    void update() {
+    }
+
+  protected:
+    uint8_t numDevices;
+};
+
+#endif // PICO2W_STOCK_TICKER_NATIVE_MD_MAX72XX_H
@@ -0,0 +1,11 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_NATIVE_STREAM_H
+#define PICO2W_STOCK_TICKER_NATIVE_STREAM_H
+
+// Where ArduinoJson and StreamUtils look for Stream
+#include <Arduino.h>
+
+#endif // PICO2W_STOCK_TICKER_NATIVE_STREAM_H
@@ -0,0 +1,15 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_NATIVE_WSTRING_H
+#define PICO2W_STOCK_TICKER_NATIVE_WSTRING_H
+
+// Declared only, see Arduino.h
+class String {
+  public:
+    const char* c_str() const;
+    bool operator==(const char* str) const;
+};
+
+#endif // PICO2W_STOCK_TICKER_NATIVE_WSTRING_H
@@ -0,0 +1,24 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_NATIVE_WIFI_H
+#define PICO2W_STOCK_TICKER_NATIVE_WIFI_H
+
+#include <Arduino.h>
+#include <IPAddress.h>
+
+#define WL_IDLE_STATUS 0
+#define WL_CONNECTED 3
+
+// Declared only, see Arduino.h. Tests use MockProvider and ReplayProvider
+// instead of the network.
+class WiFiClass {
+  public:
+    int status();
+    int hostByName(const char* hostname, IPAddress& result, int timeout);
+};
+
+extern WiFiClass WiFi;
+
+#endif // PICO2W_STOCK_TICKER_NATIVE_WIFI_H
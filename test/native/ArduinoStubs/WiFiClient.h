@@ -0,0 +1,28 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_NATIVE_WIFICLIENT_H
+#define PICO2W_STOCK_TICKER_NATIVE_WIFICLIENT_H
+
+#include <Client.h>
+#include <WiFi.h>
+
+// Declared only, see Arduino.h
+class WiFiClient : public Client {
+  public:
+    int connect(IPAddress ip, uint16_t port) override;
+    int connect(const char* host, uint16_t port) override;
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    int available() override;
+    int read() override;
+    int read(uint8_t* buffer, size_t size) override;
+    int peek() override;
+    void flush() override;
+    void stop() override;
+    uint8_t connected() override;
+    operator bool() override;
+};
+
+#endif // PICO2W_STOCK_TICKER_NATIVE_WIFICLIENT_H
@@ -0,0 +1,18 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_NATIVE_WIFICLIENTSECURE_H
+#define PICO2W_STOCK_TICKER_NATIVE_WIFICLIENTSECURE_H
+
+#include <WiFiClient.h>
+
+// Declared only, see Arduino.h
+class WiFiClientSecure : public WiFiClient {
+  public:
+    int connect(IPAddress ip, uint16_t port) override;
+    int connect(const char* host, uint16_t port) override;
+    void setInsecure();
+};
+
+#endif // PICO2W_STOCK_TICKER_NATIVE_WIFICLIENTSECURE_H
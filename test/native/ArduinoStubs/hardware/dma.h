@@ -0,0 +1,59 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_NATIVE_HARDWARE_DMA_H
+#define PICO2W_STOCK_TICKER_NATIVE_HARDWARE_DMA_H
+
+#include <stdint.h>
+
+// There are no DMA channels, so claiming one always fails and the logger
+// writes to Serial1 itself
+
+enum dma_channel_transfer_size { DMA_SIZE_8, DMA_SIZE_16, DMA_SIZE_32 };
+
+typedef struct {
+  uint32_t ctrl;
+} dma_channel_config;
+
+static inline int dma_claim_unused_channel(bool required) {
+  return -1;
+}
+
+static inline dma_channel_config dma_channel_get_default_config(uint32_t ch) {
+  return {0};
+}
+
+static inline void channel_config_set_transfer_data_size(
+  dma_channel_config* c, dma_channel_transfer_size size) {
+}
+
+static inline void channel_config_set_read_increment(dma_channel_config* c,
+                                                     bool incr) {
+}
+
+static inline void channel_config_set_write_increment(dma_channel_config* c,
+                                                      bool incr) {
+}
+
+static inline void channel_config_set_dreq(dma_channel_config* c,
+                                           uint32_t dreq) {
+}
+
+static inline void dma_channel_configure(uint32_t ch,
+                                         const dma_channel_config* config,
+                                         volatile void* writeAddr,
+                                         const volatile void* readAddr,
+                                         uint32_t transferCount,
+                                         bool trigger) {
+}
+
+static inline void dma_channel_transfer_from_buffer_now(
+  uint32_t ch, const volatile void* readAddr, uint32_t transferCount) {
+}
+
+static inline bool dma_channel_is_busy(uint32_t ch) {
+  return false;
+}
+
+#endif // PICO2W_STOCK_TICKER_NATIVE_HARDWARE_DMA_H
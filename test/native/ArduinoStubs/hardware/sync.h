@@ -0,0 +1,12 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_NATIVE_HARDWARE_SYNC_H
+#define PICO2W_STOCK_TICKER_NATIVE_HARDWARE_SYNC_H
+
+static inline void __compiler_memory_barrier() {
+  __asm__ volatile("" ::: "memory");
+}
+
+#endif // PICO2W_STOCK_TICKER_NATIVE_HARDWARE_SYNC_H
@@ -0,0 +1,28 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_NATIVE_HARDWARE_UART_H
+#define PICO2W_STOCK_TICKER_NATIVE_HARDWARE_UART_H
+
+#include <stdint.h>
+
+typedef struct {
+  volatile uint32_t dr;
+} uart_hw_t;
+
+typedef struct {
+  uart_hw_t hw;
+} uart_inst_t;
+
+extern uart_inst_t* const uart0;
+
+static inline uart_hw_t* uart_get_hw(uart_inst_t* uart) {
+  return &uart->hw;
+}
+
+static inline uint32_t uart_get_dreq_num(uart_inst_t* uart, bool isTx) {
+  return 0;
+}
+
+#endif // PICO2W_STOCK_TICKER_NATIVE_HARDWARE_UART_H
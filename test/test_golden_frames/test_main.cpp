@@ -0,0 +1,228 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+// Renders known text through the scroller and Print into an offscreen
+// framebuffer and checks every frame against golden_frames.h, so changes to
+// the renderers can be checked for pixel-identical output without looking at
+// the matrix, then benchmarks them. Run on the board with
+// `pio test -e rpipico2w -f test_golden_frames`, or on the computer with
+// `pio test -e native -f test_golden_frames`.
+//
+// A failing test prints the first frame that differs and the whole recording
+// as an array, paste that into golden_frames.h if the change was meant.
+
+#include <Arduino.h>
+#include <Log.h>
+#include <MD_MAX72xx_Font.h>
+#include <MD_MAX72xx_Offscreen.h>
+#include <MD_MAX72xx_Print.h>
+#include <MD_MAX72xx_Scrolling.h>
+#include <MD_MAX72xx_SegmentSource.h>
+#include <unity.h>
+#include "golden_frames.h"
+
+const uint16_t COLUMNS = GOLDEN_COLUMNS;
+const size_t MAX_FRAMES = 64;
+// Frames per chain length in the benchmark
+const uint32_t BENCHMARK_FRAMES = 2000;
+
+uint8_t frameStorage[COLUMNS * MAX_FRAMES];
+MD_MAX72XX_OffscreenFramebuffer framebuffer(COLUMNS, frameStorage, MAX_FRAMES);
+
+// Two short segments, like two symbols of the ticker
+class TwoSegments : public MD_MAX72XX_SegmentSource {
+  public:
+    uint16_t getSegmentCount() override {
+      return 2;
+    }
+
+    size_t writeSegment(uint16_t index, char* str, size_t maxLen) override {
+      return snprintf(str, maxLen, "%s", index == 0 ? "AB " : "-1.5 ");
+    }
+};
+
+// Every segment as long as it can be, of one column wide bars with no
+// spacing, so the widest zone shows the most characters it can
+class FullHeightBars : public MD_MAX72XX_SegmentSource {
+  public:
+    uint16_t getSegmentCount() override {
+      return 3;
+    }
+
+    size_t writeSegment(uint16_t index, char* str, size_t maxLen) override {
+      memset(str, MD_MAX72XX_Font::sparklineChar(7), maxLen - 1);
+      str[maxLen - 1] = '\0';
+      return maxLen - 1;
+    }
+};
+
+void assertFramesMatch(const uint8_t* golden, size_t goldenFrameCount) {
+  const int32_t mismatch = framebuffer.compareFrames(golden, goldenFrameCount);
+  if (mismatch >= 0) {
+    Log::logger.flush();
+    framebuffer.dumpFrameAscii(Serial1, mismatch);
+    framebuffer.dumpFramesAsArray(Serial1);
+  }
+  TEST_ASSERT_EQUAL_INT32_MESSAGE(-1, mismatch,
+                                  "First frame that differs from golden");
+}
+
+/**
+ * @brief Shift a scroller as fast as it goes until frameCount frames are
+ *  recorded. Scrolling::update() flushes once per shift.
+ */
+void recordScroll(MD_MAX72XX_Scrolling& scroller, size_t frameCount) {
+  scroller.periodBetweenShifts = 0;
+  while (framebuffer.getFlushCount() < frameCount) {
+    scroller.update();
+  }
+}
+
+void setUp() {
+  framebuffer.clear();
+  framebuffer.resetRecording();
+}
+
+void tearDown() {}
+
+void test_scroll_text_from_right() {
+  MD_MAX72XX_Scrolling scroller(&framebuffer);
+  scroller.setText("$1.5");
+  recordScroll(scroller, GOLDEN_SCROLL_FROM_RIGHT_FRAMES);
+  assertFramesMatch(GOLDEN_SCROLL_FROM_RIGHT, GOLDEN_SCROLL_FROM_RIGHT_FRAMES);
+}
+
+void test_scroll_text_from_left() {
+  MD_MAX72XX_Scrolling scroller(&framebuffer);
+  scroller.setText("AB", true);
+  recordScroll(scroller, GOLDEN_SCROLL_FROM_LEFT_FRAMES);
+  assertFramesMatch(GOLDEN_SCROLL_FROM_LEFT, GOLDEN_SCROLL_FROM_LEFT_FRAMES);
+}
+
+void test_scroll_segments_in_zone() {
+  TwoSegments segments;
+  MD_MAX72XX_Scrolling scroller(&framebuffer);
+  scroller.setZone(8, 16);
+  scroller.setSource(&segments);
+  recordScroll(scroller, GOLDEN_SCROLL_SEGMENTS_FRAMES);
+  assertFramesMatch(GOLDEN_SCROLL_SEGMENTS, GOLDEN_SCROLL_SEGMENTS_FRAMES);
+}
+
+void test_scroll_period_keeps_frames() {
+  // Only how often the frames come changes with the period, not what is in
+  // them
+  MD_MAX72XX_Scrolling scroller(&framebuffer);
+  scroller.setText("$1.5");
+  scroller.periodBetweenShifts = 20;
+  const size_t frameCount = 10;
+  const uint32_t start = millis();
+  while (framebuffer.getFlushCount() < frameCount) {
+    scroller.update();
+  }
+  // The first shift is right away
+  TEST_ASSERT_UINT32_WITHIN(5, (frameCount - 1) * 20, millis() - start);
+  assertFramesMatch(GOLDEN_SCROLL_FROM_RIGHT, frameCount);
+}
+
+void test_scroll_bars_fill_widest_zone() {
+  uint8_t wideStorage[MAX_FRAMEBUFFER_COLUMNS];
+  MD_MAX72XX_OffscreenFramebuffer wideFramebuffer(MAX_FRAMEBUFFER_COLUMNS,
+                                                  wideStorage, 1);
+  FullHeightBars bars;
+  MD_MAX72XX_Scrolling scroller(&wideFramebuffer);
+  scroller.periodBetweenShifts = 0;
+  scroller.setSource(&bars);
+  // In from the right edge, then two segments' worth further
+  const size_t shiftCount =
+    MAX_FRAMEBUFFER_COLUMNS + 2 * MD_MAX72XX_MAX_SEGMENT_LEN;
+  while (wideFramebuffer.getFlushCount() < shiftCount) {
+    scroller.update();
+  }
+  // Characters start drawing one column in from the right edge, so the last
+  // column only ever gets the rest of a wider one (like in the golden frames)
+  for (uint16_t x = 0; x < MAX_FRAMEBUFFER_COLUMNS - 1; x++) {
+    TEST_ASSERT_EQUAL_HEX8_MESSAGE(0xFF, wideFramebuffer.getColumn(x),
+                                   "Column left blank");
+  }
+}
+
+void test_print_unbuffered() {
+  MD_MAX72XX_Print print(&framebuffer);
+  print.print("12");
+  print.flush();
+  print.print("\r3");
+  print.flush();
+  print.print("\n%");
+  print.flush();
+  assertFramesMatch(GOLDEN_PRINT_UNBUFFERED, GOLDEN_PRINT_UNBUFFERED_FRAMES);
+}
+
+void test_print_buffered_overflow() {
+  MD_MAX72XX_Print print(&framebuffer);
+  print.setZone(16, 16);
+  print.setBuffered(true);
+  print.setPeriodBetweenShifts(0);
+  print.print("OK");
+  print.flush();
+  // Too wide for the zone, so it scrolls from the left
+  print.print("WIFI?");
+  print.flush();
+  while (framebuffer.getFlushCount() < GOLDEN_PRINT_OVERFLOW_FRAMES) {
+    print.update();
+  }
+  assertFramesMatch(GOLDEN_PRINT_OVERFLOW, GOLDEN_PRINT_OVERFLOW_FRAMES);
+}
+
+/**
+ * @brief Time drawing frames into a zone as wide as the ticker's on each
+ *  chain length, to compare renderer changes. Checks nothing.
+ */
+void test_benchmark_scroll() {
+  uint8_t benchmarkStorage[MAX_FRAMEBUFFER_COLUMNS];
+  TwoSegments segments;
+  for (uint8_t groups = 1; groups <= 8; groups *= 2) {
+    const uint16_t width = groups * 4 * 8;
+    MD_MAX72XX_OffscreenFramebuffer benchmarkFramebuffer(
+      width, benchmarkStorage, 1);
+    MD_MAX72XX_Scrolling scroller(&benchmarkFramebuffer);
+    scroller.periodBetweenShifts = 0;
+    // Beside a one module status zone, like the ticker
+    scroller.setZone(0, width - 8);
+    scroller.setSource(&segments);
+    const uint32_t start = micros();
+    for (uint32_t i = 0; i < BENCHMARK_FRAMES; i++) {
+      scroller.render();
+    }
+    const uint32_t elapsed = micros() - start;
+    LOG_INFO("%d groups: %lu ns per frame", groups,
+             elapsed * 1000 / BENCHMARK_FRAMES);
+  }
+}
+
+int runUnityTests() {
+  UNITY_BEGIN();
+  RUN_TEST(test_scroll_text_from_right);
+  RUN_TEST(test_scroll_text_from_left);
+  RUN_TEST(test_scroll_segments_in_zone);
+  RUN_TEST(test_scroll_period_keeps_frames);
+  RUN_TEST(test_scroll_bars_fill_widest_zone);
+  RUN_TEST(test_print_unbuffered);
+  RUN_TEST(test_print_buffered_overflow);
+  RUN_TEST(test_benchmark_scroll);
+  return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+  // Time to open the serial monitor
+  delay(2000);
+  runUnityTests();
+}
+
+void loop() {}
+#else
+int main() {
+  return runUnityTests();
+}
+#endif
@@ -0,0 +1,296 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+// Runs the whole pipeline after the request (buffering, decompression,
+// parsing, the price table) without a network, through ReplayProvider with
+// recorded responses and MockProvider with made up ones. Also checks provider
+// selection by latency and the shared error mapping, and logs how long a poll
+// takes through each. Run on the board with
+// `pio test -e rpipico2w -f test_providers`, or on the computer with
+// `pio test -e native -f test_providers`.
+
+#include <AlpacaSnapshots.h>
+#include <Arduino.h>
+#include <InflateStream.h>
+#include <Log.h>
+#include <MockProvider.h>
+#include <ReplayProvider.h>
+#include <StockTicker.h>
+#include <unity.h>
+
+using StockTicker::StockTickerStatus;
+
+// Polls per provider in the benchmark
+const uint32_t BENCHMARK_POLLS = 40;
+// 2024-01-02T15:59:59Z
+const uint32_t TRADE_TIME = 1704211199;
+
+const char STOCKS_BODY[] =
+  "{\"AAPL\":{\"dailyBar\":{\"o\":100,\"c\":101.5,"
+  "\"t\":\"2024-01-02T05:00:00Z\"},"
+  "\"latestTrade\":{\"t\":\"2024-01-02T15:59:59.123Z\"}},"
+  "\"MSFT\":{\"dailyBar\":{\"o\":400,\"c\":396}}}";
+// gzip of {"snapshots":{"BTC/USD":{"dailyBar":{"o":40000,"c":42000,
+// "t":"2024-01-02T00:00:00Z"},"latestTrade":{"t":"2024-01-02T15:59:59.5Z"}},
+// "ETH/USD":{"dailyBar":{"o":2000,"c":1900}}}}
+const uint8_t CRYPTO_BODY_GZIPPED[] = {
+  0x1F, 0x8B, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xAB, 0x56,
+  0x2A, 0xCE, 0x4B, 0x2C, 0x28, 0xCE, 0xC8, 0x2F, 0x29, 0x56, 0xB2, 0xAA,
+  0x56, 0x72, 0x0A, 0x71, 0xD6, 0x0F, 0x0D, 0x76, 0x01, 0x31, 0x53, 0x12,
+  0x33, 0x73, 0x2A, 0x9D, 0x12, 0x8B, 0x40, 0xEC, 0x7C, 0x25, 0x2B, 0x13,
+  0x03, 0x20, 0xD0, 0x51, 0x4A, 0x06, 0xB2, 0x8C, 0xC0, 0xAC, 0x12, 0x25,
+  0x2B, 0x25, 0x23, 0x03, 0x23, 0x13, 0x5D, 0x03, 0x43, 0x5D, 0x03, 0xA3,
+  0x10, 0x03, 0x03, 0x2B, 0x30, 0x8A, 0x52, 0xAA, 0xD5, 0x51, 0xCA, 0x49,
+  0x2C, 0x49, 0x2D, 0x2E, 0x09, 0x29, 0x4A, 0x4C, 0x49, 0x05, 0x69, 0x47,
+  0x53, 0x6A, 0x68, 0x6A, 0x65, 0x6A, 0x09, 0x44, 0x7A, 0xA6, 0x40, 0xC5,
+  0x40, 0xD5, 0xAE, 0x21, 0x1E, 0x38, 0x2C, 0x35, 0x82, 0xD9, 0x69, 0x68,
+  0x69, 0x60, 0x50, 0x0B, 0x04, 0x00, 0x6C, 0xA7, 0x8D, 0x6E, 0xAF, 0x00,
+  0x00, 0x00};
+const char TOO_MANY_REQUESTS_BODY[] = "{\"message\":\"too many requests.\"}";
+// Cut off in the middle of the second symbol
+const char CRYPTO_BODY_CUT_OFF[] =
+  "{\"snapshots\":{\"BTC/USD\":{\"dailyBar\":{\"o\":40000,\"c\":40400}},"
+  "\"ETH/USD\":{\"dailyB";
+
+// Two polls of a stock and a crypto request each
+const StockTicker::RecordedResponse RESPONSES[] = {
+  {200, reinterpret_cast<const uint8_t*>(STOCKS_BODY), sizeof(STOCKS_BODY) - 1,
+   false},
+  {200, CRYPTO_BODY_GZIPPED, sizeof(CRYPTO_BODY_GZIPPED), true},
+  {429, reinterpret_cast<const uint8_t*>(TOO_MANY_REQUESTS_BODY),
+   sizeof(TOO_MANY_REQUESTS_BODY) - 1, false},
+  {200, reinterpret_cast<const uint8_t*>(CRYPTO_BODY_CUT_OFF),
+   sizeof(CRYPTO_BODY_CUT_OFF) - 1, false}};
+
+/**
+ * @brief Counts its requests, to see which provider polls went to.
+ */
+class CountingMock : public StockTicker::MockProvider {
+  public:
+    explicit CountingMock(uint32_t latency) : MockProvider(1, latency) {}
+
+    int32_t sendRequest(const StockTicker::ProviderRequest& request) override {
+      this->requestCount++;
+      return MockProvider::sendRequest(request);
+    }
+
+    uint32_t requestCount = 0;
+};
+
+StockTicker::ReplayProvider replay(RESPONSES,
+                                   sizeof(RESPONSES) / sizeof(RESPONSES[0]));
+// Every second request fails with a 500
+StockTicker::MockProvider mock(3, 0, 2);
+CountingMock slowMock(30);
+CountingMock fastMock(0);
+StockTicker::StockTicker replayTicker;
+StockTicker::StockTicker mockTicker;
+StockTicker::StockTicker pickingTicker;
+
+void assertStatus(StockTickerStatus expected, StockTickerStatus actual,
+                  const char* message) {
+  TEST_ASSERT_EQUAL_INT32_MESSAGE(static_cast<int32_t>(expected),
+                                  static_cast<int32_t>(actual), message);
+}
+
+void assertQuote(const StockTicker::StockTicker& ticker, uint16_t index,
+                 const char* id, float price, float changePercent,
+                 uint32_t exchangeTime) {
+  const StockTicker::SymbolPrice& quote = ticker.getSymbolPrice(index);
+  TEST_ASSERT_EQUAL_STRING(id, quote.id);
+  TEST_ASSERT_TRUE_MESSAGE(quote.received, id);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, price, quote.price);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, changePercent, quote.changePercent);
+  TEST_ASSERT_EQUAL_UINT32(exchangeTime, quote.exchangeTime);
+}
+
+/**
+ * @brief Make every symbol due and run one poll.
+ */
+void poll(StockTicker::StockTicker& ticker) {
+  ticker.refreshOnNextUpdate();
+  ticker.update();
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_replay_session() {
+  replayTicker.begin("AAPL,MSFT,BTC/USD,ETH/USD");
+  poll(replayTicker);
+  assertStatus(StockTickerStatus::OK, replayTicker.getStatus(), "First poll");
+  assertQuote(replayTicker, 0, "AAPL", 101.5f, 1.5f, TRADE_TIME);
+  assertQuote(replayTicker, 1, "MSFT", 396.0f, -1.0f, 0);
+  // Inflated on the way in
+  assertQuote(replayTicker, 2, "BTC/USD", 42000.0f, 5.0f, TRADE_TIME);
+  assertQuote(replayTicker, 3, "ETH/USD", 1900.0f, -5.0f, 0);
+
+  // Stocks get a 429 and keep their prices, crypto is cut off after the
+  // first symbol, which still counts
+  poll(replayTicker);
+  assertStatus(StockTickerStatus::ERROR_BAD_JSON_RESPONSE,
+               replayTicker.getStatus(), "Second poll");
+  assertQuote(replayTicker, 0, "AAPL", 101.5f, 1.5f, TRADE_TIME);
+  assertQuote(replayTicker, 2, "BTC/USD", 40400.0f, 1.0f, 0);
+  assertQuote(replayTicker, 3, "ETH/USD", 1900.0f, -5.0f, 0);
+}
+
+/**
+ * @brief Inflate all of a gzipped body the way the parser leaves it.
+ *
+ * @return true if it matched its trailer.
+ */
+bool inflateAll(const uint8_t* gzipped, size_t length) {
+  StockTicker::MemoryStream compressed;
+  compressed.setTimeout(0);
+  compressed.begin(gzipped, length);
+  StockTicker::InflateStream inflater(compressed);
+  // Stop partway, like the parser stops before the trailer
+  while (inflater.peek() >= 0 && inflater.read() != '}') {}
+  return inflater.finish();
+}
+
+void test_gzip_trailer_checked() {
+  uint8_t body[sizeof(CRYPTO_BODY_GZIPPED)];
+  memcpy(body, CRYPTO_BODY_GZIPPED, sizeof(body));
+  TEST_ASSERT_TRUE_MESSAGE(inflateAll(body, sizeof(body)), "Intact");
+  // Low byte of the CRC
+  body[sizeof(body) - 8] ^= 0x01;
+  TEST_ASSERT_FALSE(inflateAll(body, sizeof(body)));
+  // Cut off in the trailer
+  TEST_ASSERT_FALSE(inflateAll(CRYPTO_BODY_GZIPPED,
+                               sizeof(CRYPTO_BODY_GZIPPED) - 4));
+}
+
+void test_mock_is_deterministic() {
+  char first[256];
+  char again[256];
+  char nextPoll[256];
+  StockTicker::MockSnapshotStream stream;
+  // The end of the response is the end, don't wait for more
+  stream.setTimeout(0);
+  stream.begin("AAPL,MSFT", 3, 1);
+  first[stream.readBytes(first, sizeof(first) - 1)] = '\0';
+  stream.begin("AAPL,MSFT", 3, 1);
+  again[stream.readBytes(again, sizeof(again) - 1)] = '\0';
+  stream.begin("AAPL,MSFT", 3, 2);
+  nextPoll[stream.readBytes(nextPoll, sizeof(nextPoll) - 1)] = '\0';
+  TEST_ASSERT_EQUAL_STRING(first, again);
+  TEST_ASSERT_TRUE_MESSAGE(strcmp(first, nextPoll) != 0,
+                           "Prices should move between polls");
+  TEST_ASSERT_TRUE(strncmp(first, "{\"AAPL\":{\"dailyBar\":", 20) == 0);
+}
+
+void test_mock_errors() {
+  mockTicker.begin("AAPL,BTC/USD");
+  // The stock request works, the crypto one is the second and fails
+  poll(mockTicker);
+  assertStatus(StockTickerStatus::ERROR_INTERNAL_SERVER_ERROR,
+               mockTicker.getStatus(), "Mock poll");
+  TEST_ASSERT_TRUE(mockTicker.getSymbolPrice(0).received);
+  TEST_ASSERT_FALSE(mockTicker.getSymbolPrice(1).received);
+}
+
+void test_picks_fastest_provider() {
+  pickingTicker.begin("AAPL");
+  // Each is tried once, then polls go to the fast one until the next probe
+  const uint32_t polls = 10;
+  for (uint32_t i = 0; i < polls; i++) {
+    poll(pickingTicker);
+  }
+  TEST_ASSERT_EQUAL_UINT32(1, slowMock.requestCount);
+  TEST_ASSERT_EQUAL_UINT32(polls - 1, fastMock.requestCount);
+}
+
+void test_error_mapping_is_shared() {
+  const StockTicker::ProviderRequest request = {
+    StockTicker::AssetClass::EQUITY, "AAPL", 5000, 5000, 0, nullptr};
+  const struct {
+      int32_t code;
+      uint32_t elapsed;
+      StockTickerStatus status;
+  } cases[] = {
+    {400, 0, StockTickerStatus::ERROR_BAD_REQUEST},
+    {403, 0, StockTickerStatus::ERROR_FORBIDDEN},
+    {429, 0, StockTickerStatus::ERROR_TOO_MANY_REQUESTS},
+    {500, 0, StockTickerStatus::ERROR_INTERNAL_SERVER_ERROR},
+    {418, 0, StockTickerStatus::ERROR_UNKNOWN},
+    {StockTicker::PROVIDER_ERROR_NO_NETWORK, 0,
+     StockTickerStatus::ERROR_NO_WIFI},
+    {StockTicker::PROVIDER_ERROR_INIT_FAILED, 0,
+     StockTickerStatus::ERROR_INIT_REQUEST_FAILED},
+    {HTTPC_ERROR_CONNECTION_FAILED, 100,
+     StockTickerStatus::ERROR_CONNECTION_FAILED},
+    {HTTPC_ERROR_CONNECTION_FAILED, 5000,
+     StockTickerStatus::ERROR_CONNECT_TIMEOUT},
+    {HTTPC_ERROR_READ_TIMEOUT, 5000,
+     StockTickerStatus::ERROR_FIRST_BYTE_TIMEOUT}};
+  for (const auto& c : cases) {
+    char message[32];
+    snprintf(message, sizeof(message), "Code %d", c.code);
+    assertStatus(c.status,
+                 StockTicker::mapAlpacaError(c.code, c.elapsed, request),
+                 message);
+    assertStatus(c.status, replay.mapError(c.code, c.elapsed, request),
+                 message);
+    assertStatus(c.status, mock.mapError(c.code, c.elapsed, request),
+                 message);
+  }
+}
+
+/**
+ * @brief Time BENCHMARK_POLLS polls, everything after the request included.
+ */
+void benchmarkPolls(StockTicker::StockTicker& ticker, const char* name) {
+  const uint32_t start = micros();
+  for (uint32_t i = 0; i < BENCHMARK_POLLS; i++) {
+    poll(ticker);
+  }
+  const uint32_t perPoll = (micros() - start) / BENCHMARK_POLLS;
+  char message[96];
+  snprintf(message, sizeof(message),
+           "%s: %lu us per poll, poll arena high-water mark %u bytes", name,
+           perPoll, ticker.getPollArena().getHighWaterMark());
+  TEST_MESSAGE(message);
+}
+
+void test_benchmark() {
+  // Errors would only get in the way of the timing
+  const Log::Level level = Log::logger.getLevel();
+  Log::logger.setLevel(Log::Level::NONE);
+  benchmarkPolls(replayTicker, "Replay");
+  benchmarkPolls(mockTicker, "Mock");
+  Log::logger.setLevel(level);
+}
+
+int runUnityTests() {
+  replayTicker.addProvider(&replay);
+  mockTicker.addProvider(&mock);
+  pickingTicker.addProvider(&slowMock);
+  pickingTicker.addProvider(&fastMock);
+  UNITY_BEGIN();
+  RUN_TEST(test_replay_session);
+  RUN_TEST(test_gzip_trailer_checked);
+  RUN_TEST(test_mock_is_deterministic);
+  RUN_TEST(test_mock_errors);
+  RUN_TEST(test_picks_fastest_provider);
+  RUN_TEST(test_error_mapping_is_shared);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+  // Time to open the serial monitor
+  delay(2000);
+  runUnityTests();
+}
+
+void loop() {}
+#else
+int main() {
+  return runUnityTests();
+}
+#endif
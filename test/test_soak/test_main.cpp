@@ -0,0 +1,275 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+// Runs the ticker and the scroller for hundreds of thousands of polls on a
+// virtual clock that crosses the millis() wrap (and the sign flip at 24.8
+// days, where deadlines compared as signed differences turn around), with
+// random symbols and failed requests. Checks that polls and shifts keep
+// their periods, with no stall or burst, and that the heap neither shrinks
+// nor fragments. The ticker has no PriceStore, so nothing is saved.
+//
+// Run on the computer with `pio test -e native -f test_soak`, where millis()
+// below takes the place of the stand-in's. On the board, for its own heap,
+// run `pio test -e rpipico2w_soak`, which links every millis() call to
+// __wrap_millis() below.
+
+#include <Arduino.h>
+#include <Log.h>
+#include <MD_MAX72xx_Offscreen.h>
+#include <MD_MAX72xx_Scrolling.h>
+#include <MockProvider.h>
+#include <SoakMonitor.h>
+#include <StockTicker.h>
+#include <unity.h>
+
+// Requests per run, stock and crypto together, about 33 hours of virtual
+// time
+const uint32_t POLLS = 200000;
+// Each loop moves the clock forward by 1 to MAX_STEP milliseconds
+const uint32_t MAX_STEP = 20;
+// How long before the wrap (or sign flip) to start
+const uint64_t LEAD_IN = 30 * 60 * 1000;
+const uint32_t STOCK_PERIOD = 1000;
+const uint32_t CRYPTO_PERIOD = 1500;
+const uint32_t SHIFT_PERIOD = 25;
+// One in this many requests fails with a 500
+const uint32_t ERROR_ODDS = 10;
+// Every this many polls the symbols change, like a settings reload
+const uint32_t RELOAD_POLLS = 20000;
+// Bytes the heap may move by between samples, for what the core keeps
+const uint32_t HEAP_SLACK = 256;
+const uint16_t COLUMNS = 32;
+
+uint64_t virtualTime = 0;
+
+#ifdef ARDUINO
+// Every millis() call in the rpipico2w_soak env comes here
+extern "C" unsigned long __wrap_millis() {
+  return static_cast<uint32_t>(virtualTime);
+}
+#else
+// Takes the place of the stand-in's millis() on the computer
+uint32_t millis() {
+  return static_cast<uint32_t>(virtualTime);
+}
+#endif
+
+/**
+ * @brief The shortest and longest time between events, like requests.
+ */
+struct Gaps {
+    uint32_t last;
+    bool started;
+    uint32_t shortest;
+    uint32_t longest;
+    uint32_t count;
+
+    void reset() {
+      *this = {};
+      this->shortest = UINT32_MAX;
+    }
+
+    // Leave the gap before the next event out, like after a reload
+    void restart() {
+      this->started = false;
+    }
+
+    void record(uint32_t time) {
+      if (this->started) {
+        const uint32_t gap = time - this->last;
+        this->shortest = min(this->shortest, gap);
+        this->longest = max(this->longest, gap);
+      }
+      this->started = true;
+      this->last = time;
+      this->count++;
+    }
+};
+
+/**
+ * @brief Fails requests at random, and times the requests of each asset
+ *  class.
+ */
+class FlakyProvider : public StockTicker::MockProvider {
+  public:
+    FlakyProvider() : MockProvider(7) {}
+
+    int32_t sendRequest(const StockTicker::ProviderRequest& request) override {
+      this->requests[static_cast<uint8_t>(request.assetClass)].record(
+        millis());
+      if (random(ERROR_ODDS) == 0) {
+        return 500;
+      }
+      return MockProvider::sendRequest(request);
+    }
+
+    uint32_t getRequestCount() const {
+      return this->requests[0].count + this->requests[1].count;
+    }
+
+    Gaps requests[2];
+};
+
+const char* const STOCKS[] = {"AAPL", "MSFT", "NVDA", "SPY", "TSLA"};
+const char* const CRYPTO[] = {"BTC/USD", "ETH/USD", "SOL/USD"};
+
+uint8_t frameStorage[COLUMNS];
+MD_MAX72XX_OffscreenFramebuffer framebuffer(COLUMNS, frameStorage, 1);
+MD_MAX72XX_Scrolling scroller(&framebuffer);
+FlakyProvider provider;
+StockTicker::StockTicker ticker;
+char symbolsString[StockTicker::MAX_SYMBOLS_STRING_LEN];
+
+void appendSymbol(size_t& len, const char* symbol) {
+  len += snprintf(symbolsString + len, sizeof(symbolsString) - len, "%s%s",
+                  len > 0 ? "," : "", symbol);
+}
+
+/**
+ * @brief Start the ticker again with a random handful of symbols, at least
+ *  one of each asset class.
+ */
+void reloadSymbols() {
+  size_t len = 0;
+  for (size_t i = 0; i < sizeof(STOCKS) / sizeof(STOCKS[0]); i++) {
+    if (i == 0 || random(2) == 0) {
+      appendSymbol(len, STOCKS[i]);
+    }
+  }
+  for (size_t i = 0; i < sizeof(CRYPTO) / sizeof(CRYPTO[0]); i++) {
+    if (i == 0 || random(2) == 0) {
+      appendSymbol(len, CRYPTO[i]);
+    }
+  }
+  ticker.begin(symbolsString, STOCK_PERIOD, CRYPTO_PERIOD);
+  // Everything is due right away after begin()
+  provider.requests[0].restart();
+  provider.requests[1].restart();
+}
+
+void assertPeriodKept(const Gaps& gaps, uint32_t shortest, uint32_t longest,
+                      const char* what) {
+  char message[64];
+  snprintf(message, sizeof(message), "%s: %lu times, %lu to %lu ms apart",
+           what, gaps.count, gaps.shortest, gaps.longest);
+  TEST_ASSERT_TRUE_MESSAGE(gaps.count > 1, message);
+  TEST_ASSERT_GREATER_OR_EQUAL_UINT32_MESSAGE(shortest, gaps.shortest,
+                                              message);
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32_MESSAGE(longest, gaps.longest, message);
+}
+
+/**
+ * @brief Run POLLS polls from startTime on the virtual clock.
+ */
+void runSoak(uint64_t startTime) {
+  virtualTime = startTime;
+  randomSeed(1);
+  provider.requests[0].reset();
+  provider.requests[1].reset();
+  Gaps shifts;
+  shifts.reset();
+  scroller.reset();
+  SoakMonitor::SoakMonitor monitor;
+  monitor.begin();
+  SoakMonitor::HeapStats baseline = {};
+  SoakMonitor::HeapStats worst = {};
+
+  uint32_t reloadCount = 0;
+  while (provider.getRequestCount() < POLLS) {
+    if (provider.getRequestCount() >= reloadCount * RELOAD_POLLS) {
+      // The first period is the warm up, whatever the logger keeps is
+      // allocated by its end
+      if (reloadCount == 1) {
+        baseline = SoakMonitor::SoakMonitor::getHeapStats();
+        worst = baseline;
+      } else if (reloadCount > 1) {
+        const SoakMonitor::HeapStats heap =
+          SoakMonitor::SoakMonitor::getHeapStats();
+        worst.freeBytes = min(worst.freeBytes, heap.freeBytes);
+        worst.largestFreeBlock =
+          min(worst.largestFreeBlock, heap.largestFreeBlock);
+      }
+      reloadSymbols();
+      reloadCount++;
+    }
+    ticker.update();
+    const size_t flushCount = framebuffer.getFlushCount();
+    scroller.update();
+    if (framebuffer.getFlushCount() != flushCount) {
+      shifts.record(millis());
+    }
+    monitor.update();
+    virtualTime += 1 + random(MAX_STEP);
+  }
+  monitor.update();
+  const SoakMonitor::HeapStats heap = SoakMonitor::SoakMonitor::getHeapStats();
+  worst.freeBytes = min(worst.freeBytes, heap.freeBytes);
+  worst.largestFreeBlock = min(worst.largestFreeBlock, heap.largestFreeBlock);
+  Log::logger.flush();
+
+  // A deadline that turned around at the wrap either never comes (a stall)
+  // or comes every loop (a burst)
+  assertPeriodKept(shifts, SHIFT_PERIOD, SHIFT_PERIOD + MAX_STEP, "Shifts");
+  // Symbols of one class can come along early with the other's request
+  assertPeriodKept(
+    provider.requests[0],
+    STOCK_PERIOD - STOCK_PERIOD / StockTicker::BATCH_AHEAD_DIVISOR,
+    STOCK_PERIOD + MAX_STEP, "Stock requests");
+  assertPeriodKept(
+    provider.requests[1],
+    CRYPTO_PERIOD - CRYPTO_PERIOD / StockTicker::BATCH_AHEAD_DIVISOR,
+    CRYPTO_PERIOD + MAX_STEP, "Crypto requests");
+  for (uint16_t i = 0; i < ticker.getSymbolCount(); i++) {
+    TEST_ASSERT_TRUE_MESSAGE(ticker.getSymbolPrice(i).received,
+                             ticker.getSymbolPrice(i).id);
+  }
+
+  TEST_ASSERT_GREATER_OR_EQUAL_UINT32_MESSAGE(
+    baseline.freeBytes - HEAP_SLACK, worst.freeBytes, "Free heap shrank");
+  TEST_ASSERT_GREATER_OR_EQUAL_UINT32_MESSAGE(
+    baseline.largestFreeBlock - HEAP_SLACK, worst.largestFreeBlock,
+    "Largest free block shrank");
+  // The monitor counted the wrap, if there was one
+  TEST_ASSERT_TRUE_MESSAGE(monitor.getUptime() == virtualTime,
+                           "Monitor's uptime is off");
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_soak_across_wrap() {
+  runSoak((1ULL << 32) - LEAD_IN);
+}
+
+void test_soak_across_sign_flip() {
+  runSoak((1ULL << 31) - LEAD_IN);
+}
+
+int runUnityTests() {
+  // Failed requests are logged as errors, the rest would only slow it down
+  Log::logger.setLevel(Log::Level::WARN);
+  ticker.addProvider(&provider);
+  ticker.setDisplayMode(StockTicker::DisplayMode::SPARKLINE);
+  scroller.periodBetweenShifts = SHIFT_PERIOD;
+  scroller.setSource(&ticker);
+  UNITY_BEGIN();
+  RUN_TEST(test_soak_across_wrap);
+  RUN_TEST(test_soak_across_sign_flip);
+  return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+  // Time to open the serial monitor
+  delay(2000);
+  runUnityTests();
+}
+
+void loop() {}
+#else
+int main() {
+  return runUnityTests();
+}
+#endif
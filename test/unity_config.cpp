@@ -0,0 +1,29 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#include <Arduino.h>
+#include <Log.h>
+#include "unity_config.h"
+
+void unityOutputStart(unsigned long baudrate) {
+  // Starts Serial1 too, at the same baud rate
+  Log::logger.begin();
+}
+
+void unityOutputChar(unsigned int c) {
+  // Through the log's ring, so results and the log lines of the code under
+  // test come out in order. Waits for room rather than dropping results.
+  while (Log::logger.availableForWrite() == 0) {
+    Log::logger.drain();
+  }
+  Log::logger.write(static_cast<uint8_t>(c));
+}
+
+void unityOutputFlush(void) {
+  Log::logger.flush();
+}
+
+void unityOutputComplete(void) {
+  Log::logger.flush();
+}
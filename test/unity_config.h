@@ -0,0 +1,29 @@
+//
+// Created by agent on 10/18/2026.
+//
+
+#ifndef PICO2W_STOCK_TICKER_UNITY_CONFIG_H
+#define PICO2W_STOCK_TICKER_UNITY_CONFIG_H
+
+// Test results go out of Serial1 through the log's ring, the USB port is
+// left to FatFSUSB
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void unityOutputStart(unsigned long baudrate);
+void unityOutputChar(unsigned int c);
+void unityOutputFlush(void);
+void unityOutputComplete(void);
+
+#define UNITY_OUTPUT_START() unityOutputStart(115200)
+#define UNITY_OUTPUT_CHAR(c) unityOutputChar(c)
+#define UNITY_OUTPUT_FLUSH() unityOutputFlush()
+#define UNITY_OUTPUT_COMPLETE() unityOutputComplete()
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICO2W_STOCK_TICKER_UNITY_CONFIG_H